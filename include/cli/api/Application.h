@@ -0,0 +1,77 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_APPLICATION_H
+#define VIRGIL_CLI_APPLICATION_H
+
+#include <string>
+#include <vector>
+
+namespace cli {
+
+/**
+ * @brief Entry point of the CLI, that builds command from the given arguments and runs it.
+ */
+class Application {
+public:
+    /**
+     * @brief Configure process and run command defined by the given arguments.
+     *
+     * If environment variable VIRGIL_SERVE_SOCKET is set and the command server (see virgil-serve)
+     * is listening on it, then command is run by the server within current directory and standard streams.
+     *
+     * @return Process exit code.
+     */
+    static int run(int argc, const char* argv[]);
+
+    /**
+     * @brief Run command defined by the given arguments within already configured process.
+     * @return Process exit code.
+     */
+    static int runCommand(int argc, const char* argv[]);
+
+    /**
+     * @brief Run command defined by the given arguments (without program name) within already configured process.
+     * @note Command never interacts with the user, so it can be run concurrently with the other commands.
+     * @return Command exit code.
+     */
+    static int runNonInteractiveCommand(const std::vector<std::string>& arguments);
+};
+
+}
+
+#endif //VIRGIL_CLI_APPLICATION_H
@@ -45,6 +45,16 @@ class Configurations {
 public:
     static void init();
     static void apply(int argc, const char* argv[]);
+    /**
+     * @brief Apply only settings that depend on the command line arguments, i.e. verbosity.
+     * @note Used to run command within the process that was configured with @link apply() @endlink before.
+     */
+    static void applyArguments(int argc, const char* argv[]);
+    /**
+     * @brief Configure process that uses CLI as a library (see Engine): all logs are disabled.
+     * @note Configuration file is not used, so it is not created.
+     */
+    static void applyLibrary();
     static std::string getDefaultConfigFilePath();
 private:
     static void initConfigFile();
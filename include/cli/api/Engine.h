@@ -0,0 +1,252 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_ENGINE_H
+#define VIRGIL_CLI_ENGINE_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/model/ChunkedCipher.h>
+#include <cli/model/DecryptCredentials.h>
+#include <cli/model/EncryptCredentials.h>
+#include <cli/model/FileDataSource.h>
+#include <cli/model/HashAlgorithm.h>
+#include <cli/model/PublicKey.h>
+#include <cli/model/SessionCipher.h>
+#include <cli/model/SignerCredentials.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cli {
+
+/**
+ * @brief Options of the @link Engine::encrypt() @endlink, see virgil-encrypt.
+ */
+struct EncryptOptions {
+    /**
+     * @brief Recipients, i.e. KeyEncryptCredentials, PasswordEncryptCredentials.
+     */
+    std::vector<std::unique_ptr<model::EncryptCredentials>> recipients;
+    /**
+     * @brief If not null, then content info is written to this sink instead of being embedded to the encrypted data.
+     * @note Is not allowed for the chunked format.
+     */
+    Crypto::DataSink* contentInfoSink = nullptr;
+    /**
+     * @brief If true, then data is encrypted in the chunked format.
+     */
+    bool isChunked = false;
+    /**
+     * @brief Size of the chunk of the chunked format.
+     */
+    size_t chunkSize = model::ChunkedCipher::kChunkSize_Default;
+    /**
+     * @brief Number of the threads that process chunks of the chunked format, if 0 then all hardware threads are used.
+     */
+    size_t jobs = model::ChunkedCipher::kJobs_Auto;
+    /**
+     * @brief If true, then data is read, processed and written in the separate threads.
+     */
+    bool isPipelined = false;
+    /**
+     * @brief If not null, then data is encrypted as the next message of this session, and recipients are ignored.
+     * @note Is not allowed for the chunked format and with the content info sink.
+     */
+    std::shared_ptr<const model::SessionCipher> session;
+};
+
+/**
+ * @brief Options of the @link Engine::decrypt() @endlink, see virgil-decrypt.
+ */
+struct DecryptOptions {
+    /**
+     * @brief Recipients, i.e. KeyDecryptCredentials, PasswordDecryptCredentials.
+     *     Recipients that do not match content info are skipped.
+     */
+    std::vector<std::unique_ptr<model::DecryptCredentials>> recipients;
+    /**
+     * @brief Content info, if it was not embedded to the encrypted data.
+     */
+    Crypto::Bytes contentInfo;
+    /**
+     * @brief Number of the threads that process chunks of the chunked format, if 0 then all hardware threads are used.
+     */
+    size_t jobs = model::ChunkedCipher::kJobs_Auto;
+    /**
+     * @brief If true, then data is read, processed and written in the separate threads.
+     */
+    bool isPipelined = false;
+    /**
+     * @brief If not null, then data is decrypted as the message of this session, and recipients are ignored.
+     */
+    std::shared_ptr<const model::SessionCipher> session;
+};
+
+/**
+ * @brief Options of the @link Engine::rekey() @endlink, see virgil-rekey.
+ */
+struct RekeyOptions {
+    /**
+     * @brief Credentials that decrypt the data key, i.e. KeyDecryptCredentials, PasswordDecryptCredentials.
+     */
+    std::vector<std::unique_ptr<model::DecryptCredentials>> credentials;
+    /**
+     * @brief New recipients of the data key, they replace all existing recipients.
+     */
+    std::vector<std::unique_ptr<model::EncryptCredentials>> recipients;
+};
+
+/**
+ * @brief Result of the @link Engine::inspect() @endlink, see virgil-content-info.
+ */
+struct EncryptedDataInfo {
+    enum class Format {
+        Default, ///< Data encrypted with the content info, embedded or detached.
+        Chunked, ///< Data encrypted in the chunked format, see ChunkedCipher.
+        SessionHeader, ///< Session header, see SessionCipher.
+        SessionMessage ///< Message of the session, it has no recipients.
+    };
+    Format format = Format::Default;
+    /**
+     * @brief Name of the algorithm that encrypts data, i.e. AES-256-GCM, or empty if it is not recognized.
+     */
+    std::string dataCipher;
+    /**
+     * @brief Size of the plain data chunk, only for the chunked format.
+     */
+    size_t chunkSize = 0;
+    /**
+     * @brief Session identifier, only for the session header and message.
+     */
+    Crypto::Bytes sessionId;
+    /**
+     * @brief Size of the content info in bytes.
+     */
+    size_t contentInfoSize = 0;
+    std::vector<Crypto::Bytes> keyRecipientIds;
+    size_t passwordRecipientCount = 0;
+};
+
+/**
+ * @brief Options of the @link Engine::sign() @endlink, see virgil-sign.
+ */
+struct SignOptions {
+    /**
+     * @brief Signer, i.e. KeySignerCredentials, AgentSignerCredentials.
+     */
+    std::unique_ptr<model::SignerCredentials> signer;
+    model::HashAlgorithm hashAlgorithm = model::HashAlgorithm::SHA384;
+};
+
+/**
+ * @brief Options of the @link Engine::verify() @endlink, see virgil-verify.
+ */
+struct VerifyOptions {
+    model::PublicKey senderKey;
+    Crypto::Bytes signature;
+};
+
+/**
+ * @brief Programmatic entry point to the crypto commands.
+ *
+ * Commands are performed in-process over the caller provided sources and sinks,
+ * so data can be processed in memory, see BytesDataSource and BytesDataSink.
+ * Commands of the CLI use the same implementation, so results are interchangeable.
+ *
+ * @note Call Configurations::applyLibrary() once before the first use.
+ * @throw ArgumentRuntimeError, or VirgilCryptoException - if command failed.
+ */
+class Engine {
+public:
+    static void encrypt(const EncryptOptions& options, Crypto::DataSource& source, Crypto::DataSink& sink);
+
+    /**
+     * @throw ArgumentRecipientDecryptionError - if none of the given recipients can decrypt data.
+     */
+    static void decrypt(const DecryptOptions& options, Crypto::DataSource& source, Crypto::DataSink& sink);
+
+    /**
+     * @brief Decrypt only the given range of the plain data encrypted in the chunked format.
+     * @see ChunkedCipher::decryptRange()
+     * @throw ArgumentRecipientDecryptionError - if none of the given recipients can decrypt data.
+     */
+    static void decryptRange(
+            const DecryptOptions& options, model::FileDataSource& source, Crypto::DataSink& sink,
+            size_t offset, size_t length);
+
+    /**
+     * @brief Replace recipients of the data encrypted in the chunked format, or of the session header.
+     *
+     * Only the data key envelope is rewritten, encrypted payload is copied as is.
+     * Data encrypted in the default format is not supported, because crypto library does not expose its data key.
+     *
+     * @throw ArgumentRuntimeError - if data is encrypted in the default format, or is the session message.
+     * @throw ArgumentRecipientDecryptionError - if none of the given credentials can decrypt data key.
+     */
+    static void rekey(const RekeyOptions& options, Crypto::DataSource& source, Crypto::DataSink& sink);
+
+    /**
+     * @brief Describe recipients and cipher parameters of the encrypted data.
+     *
+     * Only the head of the source is read, that contains the content info or the chunked format header,
+     * encrypted data is neither read nor decrypted.
+     *
+     * @throw ArgumentRuntimeError - if format of the data is not recognized.
+     * @throw VirgilCryptoException - if content info is malformed.
+     */
+    static EncryptedDataInfo inspect(Crypto::DataSource& source);
+
+    /**
+     * @brief Describe recipients and cipher parameters of the encrypted data by its detached content info.
+     */
+    static EncryptedDataInfo inspect(const Crypto::Bytes& contentInfo);
+
+    /**
+     * @return Signature of the data.
+     */
+    static Crypto::Bytes sign(const SignOptions& options, Crypto::DataSource& source);
+
+    /**
+     * @return true - if signature is valid.
+     */
+    static bool verify(const VerifyOptions& options, Crypto::DataSource& source);
+};
+
+}
+
+#endif //VIRGIL_CLI_ENGINE_H
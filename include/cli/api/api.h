@@ -76,6 +76,10 @@ COMMON OPTIONS:
 COMMANDS:
     This section contains brief description of the available commands that are available via Virgil CLI.
     CRYPTO COMMANDS
+    agent
+        Hold unlocked Private Keys and serve sign and decrypt requests of the other commands.
+    batch
+        Run many commands, one per line of the input, within one process.
     keygen
         Generate a user's Private Key with provided parameters.
     key2pub
@@ -86,12 +90,18 @@ COMMANDS:
         Encrypt the data for recipients who can be defined by their Public Keys and by the passwords (Recipient-id).
     decrypt
         Decrypt the data for a recipient who can be defined by his Public Key or by the password.
+    rekey
+        Replace recipients of the encrypted data without re-encryption of the data itself.
+    content-info
+        Show recipients and cipher parameters of the encrypted data without decryption.
     sign
         Sign the data with the user's Private Key.
     verify
         Verify the data and the signature with the Public Key.
     secret-alias
         Derive a public value from the user's secret value.
+    serve
+        Run commands of the other invocations within the warm process to eliminate startup cost.
     config
         Get the information about Virgil CLI configuration file.
     VIRGIL CARD SERVICE COMMANDS
@@ -105,21 +115,157 @@ COMMANDS:
         Revoke the Virgil Card by the Virgil Card ID.
     card-info
         Show Virgil Card information.
+    card-sync
+        Synchronize the local mirror of the application Virgil Cards, that is used by card-search --offline.
 
 CONFIGURATION VALUES:
     This section contains complete list of the configuration values.
     Each command may use all of them or just some of them, or even do not use at all.
     See specific commands documentation to know which configuration values it uses.
+        * AGENT_SOCKET - path to the socket the key agent is listening on (see virgil-agent),
+          default is $HOME/.virgil/agent.sock.
         * APP_ACCESS_TOKEN - is a unique string value that provides an authenticated secure access to the Virgil Services.
         * APP_KEY_ID - is a unique string value that identifies your application in Virgil Services.
         * APP_KEY - is a user's Private Key that is used to perform creation and revocation of Virgil Cards (Public Key) in the Virgil Services.
         * APP_KEY_PASSWORD - a password to the APP_KEY.
+        * IO_BUFFER_SIZE - size in bytes of the buffers used for reading and writing of the processed data
+          (valid range: 4096-268435456), default is 1048576.
+        * IO_PIPELINE - defines whether encrypt and decrypt commands read, process and write data
+          in the separate threads [default: auto].
+            * on - always use pipeline;
+            * off - never use pipeline;
+            * auto - use pipeline if input is large or its size is unknown, i.e. pipe.
+        * IO_URING - defines whether regular files are read and written with io_uring engine
+          on Linux [default: auto].
+            * on - same as auto, but warn if CLI is built without liburing;
+            * off - never use io_uring;
+            * auto - use io_uring if CLI is built with liburing and kernel supports it,
+              otherwise use standard reading and writing.
+        * SERVE_SOCKET - path to the socket the command server is listening on (see virgil-serve),
+          default is $HOME/.virgil/serve.sock.
     Configuration value can be read from the next sources (top is most priority):
         * command line option -D
         * command line option -C
         * default configuration file $HOME/.virgil/conf/default-config.yaml
 )";
 
+static constexpr char VIRGIL_AGENT[] = R"(
+virgil-agent - holds unlocked Private Keys and serves sign and decrypt requests over a local socket
+
+USAGE:
+    virgil agent [options...] [-p <arg>] [--jobs=<n>] <keypass>...
+
+OPTIONS:
+    -p <arg>, --private-key-password=<arg>  
+        Private Key password. If Private Keys have different passwords, then use interactive mode.
+    --jobs=<n>  
+        Number of requests that are served concurrently.
+        If 0, then number of requests equals to the number of CPU cores [default: 0].
+    <keypass>
+        User's Private Key to be held by the agent. Format: privkey:<value>:<alias>
+            + <value> - file that contains Private Key,
+            + <alias> - Private Key alias, that is used as recipient identifier on decryption.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+)";
+
+static constexpr char VIRGIL_SERVE[] = R"(
+virgil-serve - runs commands of the other invocations within the warm process to eliminate startup cost
+
+USAGE:
+    virgil serve [options...] [-p <arg>] [--jobs=<n>] [<keypass>...]
+
+OPTIONS:
+    -p <arg>, --private-key-password=<arg>  
+        Private Key password. If Private Keys have different passwords, then use interactive mode.
+    --jobs=<n>  
+        Maximum number of commands that are run concurrently.
+        If 0, then number of commands equals to the number of CPU cores [default: 0].
+    <keypass>
+        User's Private Key to be unlocked once on the server start. Format: privkey:<value>
+            + <value> - file that contains Private Key.
+        Commands that use this Private Key with the same password do not unlock it again.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+)";
+
+static constexpr char VIRGIL_BATCH[] = R"(
+virgil-batch - runs many commands, one per line of the input, within one process
+
+USAGE:
+    virgil batch [options...] [-i <file>] [-o <file>] [--jobs=<n>]
+
+OPTIONS:
+    -i <file>, --in=<file>  
+        The file with commands, one per line. If omitted, stdin is used.
+        Each line contains arguments of the virgil command, i.e. encrypt -i plain.txt -o plain.enc pubkey:bob.pub
+        Arguments are separated by spaces, and can be quoted with single or double quotes.
+        Empty lines and lines that start with '#' are skipped.
+        If omitted, then commands that read from stdin fail, so they must use -i.
+        Line with unterminated quote fails, other lines are run.
+    -o <file>, --out=<file>  
+        The file to write status of each command: <line number>: success|failure.
+        If omitted, stdout is used, and commands that write to stdout fail, so they must use -o.
+    --jobs=<n>  
+        Number of commands that are run concurrently.
+        If 0, then number of commands equals to the number of CPU cores [default: 1].
+        If more than one, then commands that read from stdin or write to stdout fail,
+        so they must use -i and -o.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+)";
+
 static constexpr char VIRGIL_CARD_CREATE[] = R"(
 virgil-card-create - creates a Virgil Card entity
 
@@ -182,18 +328,27 @@ CONFIGURATION VALUES:
 )";
 
 static constexpr char VIRGIL_CARD_GET[] = R"(
-virgil-card-get - return the Virgil Card from the Virgil Services by the Virgil Card ID.
+virgil-card-get - return the Virgil Card(s) from the Virgil Services by the Virgil Card ID(s).
 
 USAGE:
-    virgil card-get [options...] [-i <arg>] [-o <file>]
+    virgil card-get [options...] [-i <arg>] [-o <file> | --out-dir=<dir>] [--jobs=<n>] [--] [<card-id>...]
 
 OPTIONS:
     -i <arg>, --in=<arg>  
-        Virgil Card ID. If omitted, stdin is used.
+        Virgil Card ID, or the file with Virgil Card IDs, one per line.
+        If omitted and <card-id> is not given, then Virgil Card IDs are read from stdin, one per line.
     -o <file>, --out=<file>  
-        A file where Virgil Card will be saved. If omitted, stdout is used.
+        A file where Virgil Card(s) will be saved, one exported Virgil Card per line. If omitted, stdout is used.
+    --out-dir=<dir>  
+        The directory where each Virgil Card is saved to the separate file <card-id>.vcard.
+    --jobs=<n>  
+        Maximum number of Virgil Cards that are requested concurrently.
+        If 0, then it equals to the number of CPU cores [default: 8].
     --no-format  
         Do not apply formating when print Virgil Card to the standard output.
+    <card-id>
+        Virgil Card ID. Multiple Virgil Card IDs can be given, in this case Virgil Cards are written
+        in the order they are received.
     -h, --help  
         Displays usage information and exits.
     --version  
@@ -310,11 +465,14 @@ static constexpr char VIRGIL_CARD_SEARCH[] = R"(
 virgil-card-search - searches for a Virgil Card(s) by its identities (required), identity-type and scope.
 
 USAGE:
-    virgil card-search [options...] [-o <arg>] [-s <scope>] <identity>...
+    virgil card-search [options...] [-o <arg>] [-s <scope>] [--offline=<dir>] <identity>...
 
 OPTIONS:
     -o <file>, --out=<file>  
         A folder where Virgil Cards will be saved. If omitted, stdout is used.
+    --offline=<dir>  
+        Search in the local mirror of the application Virgil Cards (see virgil-card-sync),
+        the Virgil Services are not requested.
     -s <scope>, --scope=<scope>  
         Specifies the scope to perform search on [default: application].
             * for Global Virgil Card the scope must be global;
@@ -353,28 +511,127 @@ CONFIGURATION VALUES:
     See virgil(1) documentation for values description.
 )";
 
+static constexpr char VIRGIL_CARD_SYNC[] = R"(
+virgil-card-sync - synchronizes the local mirror of the application Virgil Cards with the Virgil Services.
+
+USAGE:
+    virgil card-sync [options...] --dir=<dir> [--max-age=<seconds>] [--] [<identity>...]
+
+OPTIONS:
+    --dir=<dir>  
+        The directory of the mirror. Each Virgil Card is saved to the separate file <card-id>.vcard,
+        and the file 'index' maps identities to the Virgil Cards.
+    --max-age=<seconds>  
+        Identities that were synchronized less than given number of seconds ago are not requested.
+        If 0, then all identities are requested [default: 0].
+    <identity>
+        Identity to be synchronized. Format: <type>:<value>
+        If omitted, then identities that are already in the mirror are synchronized.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+
+CONFIGURATION VALUES:
+    Use APP_ACCESS_TOKEN.
+    See virgil(1) documentation for values description.
+)";
+
+static constexpr char VIRGIL_CONTENT_INFO[] = R"(
+virgil-content-info - shows recipients and cipher parameters of the encrypted data without decryption
+
+USAGE:
+    virgil content-info [options...] [-i <file> | -c <file>] [-o <file>]
+
+OPTIONS:
+    -i <file>, --in=<file>  
+        The file with the encrypted data, or the session header (see virgil-encrypt --session).
+        Only the head of the data is read, that contains the content info. If omitted, stdin is used.
+    -c <file>, --content-info=<file>  
+        Content info, that was detached from the encrypted data (see virgil-encrypt --content-info).
+    -o <file>, --out=<file>  
+        Description of the encrypted data. If omitted, stdout is used.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+)";
+
 static constexpr char VIRGIL_DECRYPT[] = R"(
 virgil-decrypt - decrypts the encrypted data
 
 USAGE:
-    virgil decrypt [options...] [-i <file>] [-o <file>] [-c <file>] [-p <arg>] <keypass>...
+    virgil decrypt [options...] [-i <file>...] [-o <file> | --out-dir=<dir>] [--suffix=<suffix>] [-c <file> | --session=<file>] [-p <arg>] [--jobs=<n>] [--offset=<n>] [--length=<n>] <keypass>...
 
 OPTIONS:
     -i <file>, --in=<file>  
         The file with data which necessary to decrypt. If omitted, stdin is used.
+        If multiple files or a directory are given, then each file is decrypted to the separate output file.
     -o <file>, --out=<file>  
         The file with the decrypted data. If omitted, stdout is used.
+    --out-dir=<dir>  
+        The directory for the decrypted files, if multiple files are decrypted.
+        If omitted, decrypted files are written next to the encrypted files.
+    --suffix=<suffix>  
+        The suffix that is removed from the name of the encrypted file to get the name of the decrypted file [default: .enc].
     -c <file>, --content-info=<file>  
         Content info. Use this option if content info was not embedded in the encrypted data.
+    --session=<file>  
+        The file with the session header (see virgil-encrypt --session).
+        Use this option to decrypt messages that were encrypted within the session.
+        Session key is unwrapped once per run with the given <keypass> and reused for all input files.
     -p <arg>, --private-key-password=<arg>  
         User's Private Key Password.
+    --jobs=<n>  
+        Number of threads that decrypt data in the chunked format (see virgil-encrypt --chunked),
+        or number of files that are decrypted concurrently, if multiple files are decrypted.
+        If 0, then number of threads equals to the number of CPU cores [default: 0].
+    --offset=<n>  
+        Decrypt data starting from the given offset within the plain data.
+        Only data in the chunked format is supported, and only chunks that cover requested range are decrypted.
+    --length=<n>  
+        Decrypt at most given number of bytes. If omitted, data is decrypted up to the end.
+        Only data in the chunked format is supported, and only chunks that cover requested range are decrypted.
     <keypass>
-        Contains user's Private Key or password. Format: (privkey|password):<value>[:<alias>]
+        Contains user's Private Key or password. Format: (privkey|password|agent):<value>[:<alias>]
             * if privkey then:
                   + <value> - recipient's Private Key,
                   + <alias> - Private Key alias;
             * if password then:
                   + <value> - recipient's password,
+                  + <alias> - ignored;
+            * if agent then:
+                  + <value> - alias of the Private Key held by the key agent (see virgil-agent),
                   + <alias> - ignored.
     -h, --help  
         Displays usage information and exits.
@@ -401,15 +658,44 @@ static constexpr char VIRGIL_ENCRYPT[] = R"(
 virgil-encrypt - encrypts any data for the specified recipient(s)
 
 USAGE:
-    virgil encrypt [options...] [-i <file>] [-o <file>] [-c <file>] [--] <recipient-id>...
+    virgil encrypt [options...] [-i <file>...] [-o <file> | --out-dir=<dir>] [--suffix=<suffix>] [-c <file> | --chunked | --session=<file>] [--jobs=<n>] [--recipients=<file>] [--] [<recipient-id>...]
 
 OPTIONS:
     -i <file>, --in=<file>  
         The file with data which necessary to encrypt. If omitted, stdin is used.
+        If multiple files or a directory are given, then each file is encrypted to the separate output file.
     -o <file>, --out=<file>  
         The file which contains the encrypted data. If omitted, stdout is used.
+    --out-dir=<dir>  
+        The directory for the encrypted files, if multiple files are encrypted.
+        If omitted, encrypted files are written next to the source files.
+    --suffix=<suffix>  
+        The suffix that is appended to the name of the source file to get the name of the encrypted file [default: .enc].
     -c <file>, --content-info=<file>  
         Content info <Content info> - meta information about the encrypted data. If omitted, becomes a part of the encrypted data.
+    --chunked  
+        Split data to the independently authenticated chunks and encrypt them in parallel.
+        Content info is always a part of the encrypted data in this format.
+        Chunk size equals to the IO_BUFFER_SIZE configuration value.
+        Use this format if recipients should be changed later with virgil-rekey.
+    --session=<file>  
+        The file with the session header. If the file does not exist, then new session is started:
+        random session key is wrapped once for the given recipients and written to the file,
+        and then each input is encrypted as the separate message of the session with the unique nonce.
+        If the file exists, then session is continued, and recipients are ignored;
+        only the session that was started by the same process (i.e. virgil-batch) can be continued,
+        because session key is kept in memory only. Session that was started by the separate run
+        of virgil, or by the request to virgil-serve (each request is run in the separate process),
+        can not be continued, start new session instead.
+    --jobs=<n>  
+        Number of threads that encrypt chunks, used with --chunked,
+        or number of files that are encrypted concurrently, if multiple files are encrypted.
+        If 0, then number of threads equals to the number of CPU cores [default: 0].
+    --recipients=<file>  
+        The file with the recipients, one <recipient-id> per line. Empty lines and lines that start with '#' are skipped.
+        Recipients from the file are added to the recipients given in the command line.
+        For more than 64 recipients the data key of the chunked format and session is wrapped
+        in the shards of 64 recipients, that are encrypted in parallel (see --jobs).
     <recipient-id>
         Contains information about one recipient. Format: [password|email|vcard|pubkey]:<value>
             * if password, then <value> - a password for encrypting;
@@ -445,15 +731,25 @@ static constexpr char VIRGIL_KEY_FORMAT[] = R"(
 virgil-key-format - convert given key from a PEM format to a DER format and vice versa.
 
 USAGE:
-    virgil key-format [options...] (--public | --private) <key-format> [-i <file>] [-o <file>] [-p <arg>]
+    virgil key-format [options...] (--public | --private) <key-format> [-i <file>...] [-o <file> | --out-dir=<dir>] [--suffix=<suffix>] [-p <arg>] [--jobs=<n>]
 
 OPTIONS:
     -i <file>, --in=<file>  
         Source Private Key or Public Key. If omitted, stdin is used.
+        If multiple files or a directory are given, then each key is converted to the separate output file.
     -o <file>, --out=<file>  
         Destination Private Key or Public Key. If omitted, stdout is used.
+    --out-dir=<dir>  
+        The directory for the converted keys, if multiple keys are converted.
+        If omitted, converted keys are written next to the source keys.
+    --suffix=<suffix>  
+        The suffix that is appended to the name of the source key to get the name of the converted key.
+        If omitted, then '.' followed by <key-format> is used.
+    --jobs=<n>  
+        Number of keys that are converted concurrently, if multiple keys are converted.
+        If 0, then number of keys equals to the number of CPU cores [default: 0].
     -p <arg>, --private-key-password=<arg>  
-        Private Key password.
+        Private Key password. If multiple Private Keys are given, then it is used for all of them.
     --public  
         Specify that input key is a Public Key.
     --private  
@@ -568,6 +864,57 @@ OPTIONS:
         Ignores the rest of the labeled arguments following this flag.
 )";
 
+static constexpr char VIRGIL_REKEY[] = R"(
+virgil-rekey - replaces recipients of the chunked encrypted data or the session header without re-encryption
+
+USAGE:
+    virgil rekey [options...] [-i <file>] [-o <file>] [-p <arg>] -K <keypass>... [--recipients=<file>] [--] [<recipient-id>...]
+
+OPTIONS:
+    -i <file>, --in=<file>  
+        The file with data encrypted in the chunked format (see virgil-encrypt --chunked),
+        or the session header (see virgil-encrypt --session). If omitted, stdin is used.
+        Data encrypted in the default format is not supported, decrypt and encrypt it again instead.
+    -o <file>, --out=<file>  
+        The file with the same data for the new recipients. If omitted, stdout is used.
+    -p <arg>, --private-key-password=<arg>  
+        User's Private Key Password.
+    -K <keypass>, --keypass=<keypass>  
+        Contains Private Key or password of one of the current recipients, that decrypts the data key.
+        Format: (privkey|password|agent):<value>[:<alias>], see virgil-decrypt <keypass>.
+    --recipients=<file>  
+        The file with the new recipients, one <recipient-id> per line. Empty lines and lines that start with '#' are skipped.
+    <recipient-id>
+        Contains information about one new recipient. Format: [password|email|vcard|pubkey]:<value>,
+        see virgil-encrypt <recipient-id>. New recipients replace all current recipients,
+        so to add a recipient list it along with the current recipients, and to remove a recipient omit it.
+        Data key is not changed, so access that was already granted is not revoked:
+        removed recipient decrypts data with the previous copy. Revocation requires encryption under a new key.
+    -h, --help  
+        Displays usage information and exits.
+    --version  
+        Displays version information and exits.
+    -v, --verbose  
+        Activates maximum verbosity.
+    --v=<verbose-level>  
+        Activates verbosity upto given verbose level (valid range: 1-9).
+    -q, --quiet  
+        Quiet mode: suppress normal output.
+    -I, --interactive  
+        Enables interactive mode.
+    -D <config>  
+        Rewrite value from the configuration file, i.e. -D APP_ACCESS_TOKEN=AT.KJHjdskhFDJkshfd=
+    -C <config-file>  
+        Additional configuration file. If multiple files are given, then applied next rules:
+            * duplicate value from the rightmost file overwrites previous.
+    --  
+        Ignores the rest of the labeled arguments following this flag.
+
+CONFIGURATION VALUES:
+    Use APP_ACCESS_TOKEN when vcard or email is used as <recipient-id>
+    See virgil(1) documentation for values description.
+)";
+
 static constexpr char VIRGIL_SECRET_ALIAS[] = R"(
 virgil-secret-alias - derives a public value from the user's secret value
 
@@ -615,15 +962,25 @@ static constexpr char VIRGIL_SIGN[] = R"(
 virgil-sign - signs data with a provided user's Private Key
 
 USAGE:
-    virgil sign [options...] [-i <file>] [-o <file>] -k <file> [-p <arg>] [--hash-algorithm <hash-alg>]
+    virgil sign [options...] [-i <file>...] [-o <file> | --out-dir=<dir>] [--suffix=<suffix>] -k <file> [-p <arg>] [--hash-algorithm <hash-alg>] [--jobs=<n>]
 
 OPTIONS:
     -i <file>, --in=<file>  
         The file with data which necessary to sign. If omitted, stdin is used.
+        If multiple files or a directory are given, then signature of each file is written to the separate file.
     -o <file>, --out=<file>  
         The signed data. If omitted, stdout is used.
+    --out-dir=<dir>  
+        The directory for the signatures, if multiple files are signed.
+        If omitted, signatures are written next to the signed files.
+    --suffix=<suffix>  
+        The suffix that is appended to the name of the signed file to get the name of the signature file [default: .sign].
+    --jobs=<n>  
+        Number of files that are signed concurrently, if multiple files are signed.
+        If 0, then number of files equals to the number of CPU cores [default: 0].
     -k <file>, --private-key=<file>  
         The file that contains signer's Private Key.
+        Use agent:<alias> to sign with the Private Key held by the key agent (see virgil-agent).
     -p <arg>, --private-key-password=<arg>  
         Private Key password.
     --hash-algorithm=<hash-alg>  
@@ -658,13 +1015,20 @@ static constexpr char VIRGIL_VERIFY[] = R"(
 virgil-verify - verifies data and signature with a provided user's Public Key or Virgil Card
 
 USAGE:
-    virgil verify [options...] [-i <file>] -S <file> <recipient-id>
+    virgil verify [options...] [-i <file>...] [-S <file>] [--suffix=<suffix>] [--jobs=<n>] <recipient-id>
 
 OPTIONS:
     -i <file>, --in=<file>  
         The file with data which necessary to verify. If omitted, stdin is used.
+        If multiple files or a directory are given, then each file is verified with its own signature file.
     -S <file>, --sign=<file>  
-        Digest sign.
+        Digest sign. Required, unless multiple files are verified.
+    --suffix=<suffix>  
+        The suffix that is appended to the name of the verified file to get the name of its signature file,
+        if multiple files are verified [default: .sign].
+    --jobs=<n>  
+        Number of files that are verified concurrently, if multiple files are verified.
+        If 0, then number of files equals to the number of CPU cores [default: 0].
     <recipient-id>
         Contains information about the sender. Format: [vcard | pubkey]:<value>
             * if vcard, then <value> - the sender's Virgil Card ID or the Virgil Card itself (the file stored locally);
@@ -701,9 +1065,11 @@ namespace cli { namespace opt {
 
 static constexpr char ALGORITHM[] = "--algorithm";
 static constexpr char ALL[] = "--all";
+static constexpr char CHUNKED[] = "--chunked";
 static constexpr char CONTENT_INFO[] = "--content-info";
 static constexpr char C_SHORT[] = "-C";
 static constexpr char DATA[] = "--data";
+static constexpr char DIRECTORY[] = "--dir";
 static constexpr char D_SHORT[] = "-D";
 static constexpr char FORMAT[] = "--format";
 static constexpr char HASH_ALGORITHM[] = "--hash-algorithm";
@@ -712,19 +1078,29 @@ static constexpr char IN[] = "--in";
 static constexpr char INFO[] = "--info";
 static constexpr char INTERACTIVE[] = "--interactive";
 static constexpr char ITERATIONS[] = "--iterations";
+static constexpr char JOBS[] = "--jobs";
+static constexpr char KEYPASS[] = "--keypass";
+static constexpr char LENGTH[] = "--length";
+static constexpr char MAX_AGE[] = "--max-age";
 static constexpr char NO_FORMAT[] = "--no-format";
 static constexpr char NO_PASSWORD[] = "--no-password";
+static constexpr char OFFLINE[] = "--offline";
+static constexpr char OFFSET[] = "--offset";
 static constexpr char OPTIONS_FIRST[] = "--";
 static constexpr char OUT[] = "--out";
+static constexpr char OUT_DIR[] = "--out-dir";
 static constexpr char PRIVATE[] = "--private";
 static constexpr char PRIVATE_KEY[] = "--private-key";
 static constexpr char PRIVATE_KEY_PASSWORD[] = "--private-key-password";
 static constexpr char PUBLIC[] = "--public";
 static constexpr char QUIET[] = "--quiet";
+static constexpr char RECIPIENTS[] = "--recipients";
 static constexpr char REVOCATION_REASON[] = "--revocation-reason";
 static constexpr char SALT[] = "--salt";
 static constexpr char SCOPE[] = "--scope";
+static constexpr char SESSION[] = "--session";
 static constexpr char SIGN[] = "--sign";
+static constexpr char SUFFIX[] = "--suffix";
 static constexpr char V[] = "--v";
 static constexpr char VERBOSE[] = "--verbose";
 static constexpr char VERSION[] = "--version";
@@ -734,6 +1110,7 @@ static constexpr char VERSION[] = "--version";
 namespace cli { namespace arg {
 
 static constexpr char ARGS[] = "<args>";
+static constexpr char CARD_ID[] = "<card-id>";
 static constexpr char COMMAND[] = "<command>";
 static constexpr char IDENTITY[] = "<identity>";
 static constexpr char KEYPASS[] = "<keypass>";
@@ -744,6 +1121,12 @@ static constexpr char RECIPIENT_ID[] = "<recipient-id>";
 
 namespace cli { namespace arg { namespace value {
 
+static constexpr char VIRGIL_AGENT_KEYPASS_PRIVKEY[] = "privkey";
+static const char* VIRGIL_AGENT_KEYPASS_VALUES[] = {
+    VIRGIL_AGENT_KEYPASS_PRIVKEY,
+    nullptr
+};
+
 static constexpr char VIRGIL_CARD_CREATE_IDENTITY_EMAIL[] = "email";
 static const char* VIRGIL_CARD_CREATE_IDENTITY_VALUES[] = {
     VIRGIL_CARD_CREATE_IDENTITY_EMAIL,
@@ -810,53 +1193,106 @@ static const char* VIRGIL_CARD_SEARCH_SCOPE_VALUES[] = {
     nullptr
 };
 
+static constexpr char VIRGIL_COMMAND_AGENT[] = "agent";
+static constexpr char VIRGIL_COMMAND_BATCH[] = "batch";
 static constexpr char VIRGIL_COMMAND_CARD_CREATE[] = "card-create";
 static constexpr char VIRGIL_COMMAND_CARD_GET[] = "card-get";
 static constexpr char VIRGIL_COMMAND_CARD_INFO[] = "card-info";
 static constexpr char VIRGIL_COMMAND_CARD_REVOKE[] = "card-revoke";
 static constexpr char VIRGIL_COMMAND_CARD_SEARCH[] = "card-search";
+static constexpr char VIRGIL_COMMAND_CARD_SYNC[] = "card-sync";
 static constexpr char VIRGIL_COMMAND_CONFIG[] = "config";
+static constexpr char VIRGIL_COMMAND_CONTENT_INFO[] = "content-info";
 static constexpr char VIRGIL_COMMAND_DECRYPT[] = "decrypt";
 static constexpr char VIRGIL_COMMAND_ENCRYPT[] = "encrypt";
 static constexpr char VIRGIL_COMMAND_KEY_FORMAT[] = "key-format";
 static constexpr char VIRGIL_COMMAND_KEY2PUB[] = "key2pub";
 static constexpr char VIRGIL_COMMAND_KEYGEN[] = "keygen";
+static constexpr char VIRGIL_COMMAND_REKEY[] = "rekey";
 static constexpr char VIRGIL_COMMAND_SECRET_ALIAS[] = "secret-alias";
+static constexpr char VIRGIL_COMMAND_SERVE[] = "serve";
 static constexpr char VIRGIL_COMMAND_SIGN[] = "sign";
 static constexpr char VIRGIL_COMMAND_VERIFY[] = "verify";
 static const char* VIRGIL_COMMAND_VALUES[] = {
+    VIRGIL_COMMAND_AGENT,
+    VIRGIL_COMMAND_BATCH,
     VIRGIL_COMMAND_CARD_CREATE,
     VIRGIL_COMMAND_CARD_GET,
     VIRGIL_COMMAND_CARD_INFO,
     VIRGIL_COMMAND_CARD_REVOKE,
     VIRGIL_COMMAND_CARD_SEARCH,
+    VIRGIL_COMMAND_CARD_SYNC,
     VIRGIL_COMMAND_CONFIG,
+    VIRGIL_COMMAND_CONTENT_INFO,
     VIRGIL_COMMAND_DECRYPT,
     VIRGIL_COMMAND_ENCRYPT,
     VIRGIL_COMMAND_KEY_FORMAT,
     VIRGIL_COMMAND_KEY2PUB,
     VIRGIL_COMMAND_KEYGEN,
+    VIRGIL_COMMAND_REKEY,
     VIRGIL_COMMAND_SECRET_ALIAS,
+    VIRGIL_COMMAND_SERVE,
     VIRGIL_COMMAND_SIGN,
     VIRGIL_COMMAND_VERIFY,
     nullptr
 };
 
+static constexpr char VIRGIL_CONFIG_AGENT_SOCKET[] = "AGENT_SOCKET";
 static constexpr char VIRGIL_CONFIG_APP_ACCESS_TOKEN[] = "APP_ACCESS_TOKEN";
 static constexpr char VIRGIL_CONFIG_APP_KEY[] = "APP_KEY";
 static constexpr char VIRGIL_CONFIG_APP_KEY_ID[] = "APP_KEY_ID";
 static constexpr char VIRGIL_CONFIG_APP_KEY_PASSWORD[] = "APP_KEY_PASSWORD";
+static constexpr char VIRGIL_CONFIG_CARD_CACHE_NEGATIVE_TTL[] = "CARD_CACHE_NEGATIVE_TTL";
+static constexpr char VIRGIL_CONFIG_CARD_CACHE_TTL[] = "CARD_CACHE_TTL";
+static constexpr char VIRGIL_CONFIG_IO_BUFFER_SIZE[] = "IO_BUFFER_SIZE";
+static constexpr char VIRGIL_CONFIG_IO_PIPELINE[] = "IO_PIPELINE";
+static constexpr char VIRGIL_CONFIG_IO_URING[] = "IO_URING";
+static constexpr char VIRGIL_CONFIG_SERVE_SOCKET[] = "SERVE_SOCKET";
 static const char* VIRGIL_CONFIG_VALUES[] = {
+    VIRGIL_CONFIG_AGENT_SOCKET,
     VIRGIL_CONFIG_APP_ACCESS_TOKEN,
     VIRGIL_CONFIG_APP_KEY,
     VIRGIL_CONFIG_APP_KEY_ID,
     VIRGIL_CONFIG_APP_KEY_PASSWORD,
+    VIRGIL_CONFIG_CARD_CACHE_NEGATIVE_TTL,
+    VIRGIL_CONFIG_CARD_CACHE_TTL,
+    VIRGIL_CONFIG_IO_BUFFER_SIZE,
+    VIRGIL_CONFIG_IO_PIPELINE,
+    VIRGIL_CONFIG_IO_URING,
+    VIRGIL_CONFIG_SERVE_SOCKET,
     nullptr
 };
 
+static constexpr auto VIRGIL_CONFIG_IO_BUFFER_SIZE_MIN = 4096; // 4KB
+static constexpr auto VIRGIL_CONFIG_IO_BUFFER_SIZE_MAX = 256 * 1024 * 1024; // 256MB
+
+static constexpr char VIRGIL_CONFIG_IO_PIPELINE_AUTO[] = "auto";
+static constexpr char VIRGIL_CONFIG_IO_PIPELINE_OFF[] = "off";
+static constexpr char VIRGIL_CONFIG_IO_PIPELINE_ON[] = "on";
+static const char* VIRGIL_CONFIG_IO_PIPELINE_VALUES[] = {
+    VIRGIL_CONFIG_IO_PIPELINE_AUTO,
+    VIRGIL_CONFIG_IO_PIPELINE_OFF,
+    VIRGIL_CONFIG_IO_PIPELINE_ON,
+    nullptr
+};
+// Minimum number of the chunks in the input, when pipeline is enabled in the 'auto' mode.
+static constexpr auto VIRGIL_CONFIG_IO_PIPELINE_AUTO_MIN_CHUNKS = 4;
+
+static constexpr char VIRGIL_CONFIG_IO_URING_AUTO[] = "auto";
+static constexpr char VIRGIL_CONFIG_IO_URING_OFF[] = "off";
+static constexpr char VIRGIL_CONFIG_IO_URING_ON[] = "on";
+static const char* VIRGIL_CONFIG_IO_URING_VALUES[] = {
+    VIRGIL_CONFIG_IO_URING_AUTO,
+    VIRGIL_CONFIG_IO_URING_OFF,
+    VIRGIL_CONFIG_IO_URING_ON,
+    nullptr
+};
+
+static constexpr char VIRGIL_DECRYPT_KEYPASS_AGENT[] = "agent";
 static constexpr char VIRGIL_DECRYPT_KEYPASS_PASSWORD[] = "password";
 static constexpr char VIRGIL_DECRYPT_KEYPASS_PRIVKEY[] = "privkey";
 static const char* VIRGIL_DECRYPT_KEYPASS_VALUES[] = {
+    VIRGIL_DECRYPT_KEYPASS_AGENT,
     VIRGIL_DECRYPT_KEYPASS_PASSWORD,
     VIRGIL_DECRYPT_KEYPASS_PRIVKEY,
     nullptr
@@ -930,6 +1366,14 @@ static const char* VIRGIL_SECRET_ALIAS_HASH_ALG_VALUES[] = {
     nullptr
 };
 
+static constexpr char VIRGIL_SERVE_KEYPASS_PRIVKEY[] = "privkey";
+static const char* VIRGIL_SERVE_KEYPASS_VALUES[] = {
+    VIRGIL_SERVE_KEYPASS_PRIVKEY,
+    nullptr
+};
+
+static constexpr char VIRGIL_SIGN_PRIVATE_KEY_AGENT[] = "agent";
+
 static constexpr char VIRGIL_SIGN_HASH_ALG_SHA1[] = "sha1";
 static constexpr char VIRGIL_SIGN_HASH_ALG_SHA224[] = "sha224";
 static constexpr char VIRGIL_SIGN_HASH_ALG_SHA256[] = "sha256";
@@ -955,6 +1399,10 @@ static const char* VIRGIL_VERIFY_RECIPIENT_ID_VALUES[] = {
 static constexpr auto VIRGIL_SECRET_ALIAS_ITERATION_COUNT_MIN = 2048;
 static constexpr auto VIRGIL_SECRET_ALIAS_ITERATION_COUNT_MAX = 16384;
 
+static constexpr auto VIRGIL_JOBS_AUTO = 0;
+static constexpr auto VIRGIL_JOBS_MIN = VIRGIL_JOBS_AUTO;
+static constexpr auto VIRGIL_JOBS_MAX = 1024;
+
 static constexpr auto VIRGIL_VERBOSE_LEVEL_MIN = 1;
 static constexpr auto VIRGIL_VERBOSE_LEVEL_MAX = 9;
 
@@ -44,6 +44,10 @@
 #include <cli/argument/ArgumentSource.h>
 #include <cli/argument/ArgumentValueSource.h>
 
+#include <cli/concurrency/FileJobRunner.h>
+
+#include <cli/io/BufferPool.h>
+
 #include <cli/model/Password.h>
 #include <cli/model/KeyAlgorithm.h>
 #include <cli/model/EncryptCredentials.h>
@@ -73,6 +77,10 @@ public:
     // Check
     bool hasContentInfo() const;
 
+    bool hasSignature() const;
+
+    bool hasSession() const;
+
     bool hasNoPassword() const;
 
     bool isInteractive() const;
@@ -85,6 +93,23 @@ public:
 
     bool isAll() const;
 
+    bool isChunked() const;
+
+    /**
+     * @brief Return true if --offset or --length is given.
+     */
+    bool hasDataRange() const;
+
+    /**
+     * @brief Return true if data from the given source should be processed in the pipelined mode.
+     */
+    bool isPipelined(const model::FileDataSource& source) const;
+
+    /**
+     * @brief Return true if multiple input files, input directory, or output directory are given.
+     */
+    bool isMultiFile() const;
+
     // Get
     std::vector<std::unique_ptr<model::EncryptCredentials>>
     getEncryptCredentials(ArgumentImportance argumentImportance) const;
@@ -92,6 +117,12 @@ public:
     std::vector<std::unique_ptr<model::DecryptCredentials>>
     getDecryptCredentials(ArgumentImportance argumentImportance) const;
 
+    /**
+     * @brief Return decryption credentials given by the --keypass option.
+     */
+    std::vector<std::unique_ptr<model::DecryptCredentials>>
+    getKeypassCredentials(ArgumentImportance argumentImportance) const;
+
     model::SecureValue getInput(ArgumentImportance argumentImportance) const;
 
     model::SecureValue getOutput(ArgumentImportance argumentImportance) const;
@@ -100,10 +131,38 @@ public:
 
     model::FileDataSink getOutputSink(ArgumentImportance argumentImportance) const;
 
+    /**
+     * @brief Return input source that reads data in the small chunks, so only the head of the input is read
+     *     if the rest of the data is not requested.
+     */
+    model::FileDataSource getInputHeadSource(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return input and output files of the multi-file mode.
+     * @param isSuffixRemoved - if true, then output file name is the input file name without suffix,
+     *     otherwise suffix is appended to the input file name.
+     * @note Input directories are replaced with the files they contain.
+     * @note Output files are placed to the output directory if it is given, otherwise next to the input files.
+     * @param defaultSuffix - suffix that is used if it is not given in the arguments.
+     * @throw error::ArgumentRuntimeError - if several input files have the same output file.
+     */
+    std::vector<concurrency::FileJob> getFileJobs(
+            bool isSuffixRemoved, ArgumentImportance argumentImportance,
+            const std::string& defaultSuffix = std::string()) const;
+
+    model::FileDataSource getFileSource(const std::string& filePath) const;
+
+    model::FileDataSink getFileSink(const std::string& filePath) const;
+
     model::FileDataSource getContentInfoSource(ArgumentImportance argumentImportance) const;
 
     model::FileDataSink getContentInfoSink(ArgumentImportance argumentImportance) const;
 
+    /**
+     * @brief Return path to the file with the session header.
+     */
+    Crypto::Text getSessionPath(ArgumentImportance argumentImportance) const;
+
     model::KeyAlgorithm getKeyAlgorithm(ArgumentImportance argumentImportance) const;
 
     model::Password getKeyPassword(ArgumentImportance argumentImportance) const;
@@ -112,6 +171,36 @@ public:
 
     model::PrivateKey getPrivateKeyFromInput(ArgumentImportance argumentImportance) const;
 
+    /**
+     * @brief Read private key from the given file and unlock it with the private key password.
+     */
+    model::PrivateKey getPrivateKeyFromFile(const std::string& filePath) const;
+
+    /**
+     * @brief Return credentials for signing: private key, or key held by the key agent if agent:<alias> is given.
+     */
+    std::unique_ptr<model::SignerCredentials> getSignerCredentials(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return unlocked private keys that should be held by the key agent.
+     */
+    std::vector<model::PrivateKey> getAgentKeys(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return path to the socket the key agent is listening on.
+     */
+    Crypto::Text getAgentSocket(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return unlocked private keys that should be kept warm by the command server.
+     */
+    std::vector<model::PrivateKey> getServeKeys(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return path to the socket the command server is listening on.
+     */
+    Crypto::Text getServeSocket(ArgumentImportance argumentImportance) const;
+
     model::PublicKey getSenderKey(ArgumentImportance argumentImportance) const;
 
     model::FileDataSource getSignatureSource(ArgumentImportance argumentImportance) const;
@@ -138,6 +227,31 @@ public:
 
     std::vector<model::Card> getCardListFromInput(ArgumentImportance argumentImportance) const;
 
+    /**
+     * @brief Read Virgil Card IDs from the arguments, from the input file or from the standard input (one per line).
+     */
+    std::vector<std::string> getCardIds(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @return Output directory, or empty string if it is not given.
+     */
+    std::string getOutputDir(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @return Directory of the Virgil Card mirror (see virgil-card-sync).
+     */
+    std::string getCardMirrorDir(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @return Directory of the Virgil Card mirror to search in offline, or empty string if it is not given.
+     */
+    std::string getOfflineCardMirrorDir(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @return Maximum age of the synchronized identities in seconds, or 0 if it is omitted.
+     */
+    size_t getMaxAge(ArgumentImportance argumentImportance) const;
+
     model::CardRevocationReason getCardRevokeReason(ArgumentImportance argumentImportance) const;
 
     model::HashAlgorithm getHashAlgorithm(ArgumentImportance argumentImportance) const;
@@ -146,6 +260,20 @@ public:
 
     size_t getIterationCount(ArgumentImportance argumentImportance) const;
 
+    size_t getJobs(ArgumentImportance argumentImportance) const;
+
+    size_t getDataOffset(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @return Data length, or maximum value of size_t if it is omitted.
+     */
+    size_t getDataLength(ArgumentImportance argumentImportance) const;
+
+    /**
+     * @brief Return size of the chunks that are used for the data reading and the chunked encryption.
+     */
+    size_t getIOBufferSize() const;
+
     Crypto::Text getKeyFormat(ArgumentImportance argumentImportance) const;
 
 private:
@@ -154,7 +282,8 @@ private:
     model::FileDataSink getSink(const ArgumentValue& argumentValue) const;
 
     void readPrivateKeyPassword(
-            model::PrivateKey& privateKey, const ArgumentValue& argumentValue, const char* passwordArgumentKey) const;
+            model::PrivateKey& privateKey, const ArgumentValue& argumentValue, const char* passwordArgumentKey,
+            model::PrivateKey::CacheMode cacheMode = model::PrivateKey::CacheMode::Shared) const;
 
     std::vector<std::unique_ptr<model::EncryptCredentials>>
     readEncryptCredentials(const ArgumentValue& argumentValue) const;
@@ -162,11 +291,21 @@ private:
     std::vector<std::unique_ptr<model::DecryptCredentials>>
     readDecryptCredentials(const ArgumentValue& argumentValue) const;
 
+    std::vector<std::unique_ptr<model::DecryptCredentials>>
+    readDecryptCredentials(const char* argumentKey, ArgumentImportance argumentImportance) const;
+
     model::PublicKey readSenderKey(const ArgumentValue& argumentValue) const;
 
+    size_t readIOBufferSize() const;
+
+    bool readIOUring() const;
+
 private:
     std::unique_ptr<ArgumentSource> argumentSource_;
     std::unique_ptr<ArgumentValueSource> argumentValueSource_;
+    size_t ioBufferSize_;
+    std::shared_ptr<io::BufferPool> bufferPool_;
+    bool useUring_;
 };
 
 }}
@@ -47,6 +47,8 @@ enum class ArgumentSourceType : cli::types::EnumType {
     File      = 1 << 1,
     Service   = 1 << 2,
     Parser    = 1 << 3,
+    Agent     = 1 << 4,
+    Cache     = 1 << 5,
     Any       = std::numeric_limits<cli::types::EnumType>::max(),
 };
 
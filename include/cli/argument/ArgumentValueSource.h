@@ -41,6 +41,7 @@
 
 #include <cli/argument/ArgumentSourceType.h>
 
+#include <cli/model/AgentKey.h>
 #include <cli/model/Card.h>
 #include <cli/model/PublicKey.h>
 #include <cli/model/PrivateKey.h>
@@ -75,6 +76,8 @@ public:
 
     model::PrivateKey readPrivateKey(const ArgumentValue& argumentValue) const;
 
+    model::AgentKey readAgentKey(const ArgumentValue& argumentValue) const;
+
     std::vector<model::Card> readCards(const ArgumentValue& argumentValue) const;
 
     model::Card readCard(const ArgumentValue& argumentValue) const;
@@ -98,6 +101,8 @@ private:
 
     virtual std::unique_ptr<model::PrivateKey> doReadPrivateKey(const ArgumentValue& argumentValue) const;
 
+    virtual std::unique_ptr<model::AgentKey> doReadAgentKey(const ArgumentValue& argumentValue) const;
+
     virtual std::unique_ptr<std::vector<model::Card>> doReadCards(const ArgumentValue& argumentValue) const;
 
     virtual std::unique_ptr<model::Card> doReadCard(const ArgumentValue& argumentValue) const;
@@ -38,6 +38,7 @@
 #define VIRGIL_CLI_ARGUMENT_VALUE_VIRGIL_SOURCE_H
 
 #include <cli/argument/ArgumentValueSource.h>
+#include <cli/model/CardCache.h>
 
 #include <memory>
 
@@ -45,7 +46,10 @@ namespace cli { namespace argument {
 
 class ArgumentValueVirgilSource : public ArgumentValueSource {
 public:
-    ArgumentValueVirgilSource();
+    /**
+     * @param cardCache - cache that stores received Virgil Cards, if nullptr, then cards are not cached.
+     */
+    explicit ArgumentValueVirgilSource(std::shared_ptr<model::CardCache> cardCache = nullptr);
     ArgumentValueVirgilSource(ArgumentValueVirgilSource&&);
     ArgumentValueVirgilSource& operator=(ArgumentValueVirgilSource&&);
     ~ArgumentValueVirgilSource() noexcept;
@@ -38,6 +38,7 @@
 #define VIRGIL_CLI_DECRYPT_COMMAND_H
 
 #include <cli/command/Command.h>
+#include <cli/model/SessionCipher.h>
 
 namespace cli { namespace command {
 
@@ -49,6 +50,13 @@ private:
     virtual const char* doGetUsage() const override;
     virtual argument::ArgumentParseOptions doGetArgumentParseOptions() const override;
     virtual void doProcess() const override;
+private:
+    void processFiles() const;
+    /**
+     * @brief Open the session, which header is stored in the file given by --session.
+     */
+    std::shared_ptr<const model::SessionCipher> openSession(
+            const std::vector<std::unique_ptr<model::DecryptCredentials>>& recipients) const;
 };
 
 }}
@@ -38,6 +38,7 @@
 #define VIRGIL_CLI_ENCRYPT_COMMAND_H
 
 #include <cli/command/Command.h>
+#include <cli/model/SessionCipher.h>
 
 namespace cli { namespace command {
 
@@ -49,6 +50,12 @@ private:
     virtual const char* doGetUsage() const override;
     virtual argument::ArgumentParseOptions doGetArgumentParseOptions() const override;
     virtual void doProcess() const override;
+private:
+    void processFiles() const;
+    /**
+     * @brief Start the session, if session header file does not exist, or continue the session otherwise.
+     */
+    std::shared_ptr<const model::SessionCipher> getSession() const;
 };
 
 }}
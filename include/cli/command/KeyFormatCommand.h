@@ -52,6 +52,8 @@ private:
 private:
     void processPublicKey() const;
     void processPrivateKey() const;
+    void processPublicKeyFiles() const;
+    void processPrivateKeyFiles() const;
 };
 
 }}
@@ -49,6 +49,8 @@ private:
     virtual const char* doGetUsage() const override;
     virtual argument::ArgumentParseOptions doGetArgumentParseOptions() const override;
     virtual void doProcess() const override;
+private:
+    void processFiles() const;
 };
 
 }}
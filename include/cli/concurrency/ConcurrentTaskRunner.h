@@ -0,0 +1,136 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_CONCURRENT_TASK_RUNNER_H
+#define VIRGIL_CLI_CONCURRENT_TASK_RUNNER_H
+
+#include <cli/concurrency/BoundedQueue.h>
+#include <cli/concurrency/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+
+namespace cli { namespace concurrency {
+
+/**
+ * @brief Run independent tasks concurrently and pass their results to the handler in the calling thread.
+ *
+ * Results are handled in the order the tasks complete, and at most kPendingResults_Max results wait for the handler.
+ * First failure of the task or of the handler stops the run: tasks that were not started yet are cancelled,
+ * running tasks are awaited, and the failure is rethrown to the caller.
+ * @note Task that must not stop the run on failure, should return the error within its result.
+ */
+template<typename Result>
+class ConcurrentTaskRunner {
+public:
+    static constexpr const size_t kPendingResults_Max = 1024;
+    using Task = std::function<Result(size_t index)>;
+    using Handler = std::function<void(size_t index, Result& result)>;
+public:
+    /**
+     * @param threadCount - maximum number of the tasks run concurrently,
+     *     if ThreadPool::kThreadCount_Auto then number of the hardware threads is used.
+     */
+    explicit ConcurrentTaskRunner(size_t threadCount) : threadCount_(threadCount) {
+    }
+
+    /**
+     * @brief Run tasks with indices [0, taskCount) and handle results of all of them.
+     * @note Task is called concurrently, so it must use shared state in the read-only manner.
+     * @throw First exception thrown by the task or by the handler.
+     */
+    void run(size_t taskCount, const Task& task, const Handler& handler) const {
+        if (taskCount == 0) {
+            return;
+        }
+        BoundedQueue<Completion> completions(std::min(taskCount, kPendingResults_Max));
+        std::atomic<bool> isCancelled(false);
+        // Pool is destroyed first, so running tasks are awaited before the queue and the flag go away.
+        ThreadPool pool(threadCount_ == ThreadPool::kThreadCount_Auto ?
+                threadCount_ : std::min(threadCount_, taskCount));
+        try {
+            for (size_t index = 0; index < taskCount; ++index) {
+                pool.submit([&task, &completions, &isCancelled, index]() {
+                    if (isCancelled) {
+                        return;
+                    }
+                    Completion completion{ index, Result(), nullptr };
+                    try {
+                        completion.result = task(index);
+                    } catch (...) {
+                        isCancelled = true;
+                        completion.error = std::current_exception();
+                    }
+                    completions.push(std::move(completion));
+                });
+            }
+            for (size_t i = 0; i < taskCount; ++i) {
+                Completion completion;
+                completions.pop(completion);
+                if (completion.error) {
+                    std::rethrow_exception(completion.error);
+                }
+                handler(completion.index, completion.result);
+            }
+        } catch (...) {
+            isCancelled = true;
+            // Unblock tasks that wait for the room in the queue.
+            completions.cancel();
+            throw;
+        }
+    }
+
+private:
+    struct Completion {
+        size_t index;
+        Result result;
+        std::exception_ptr error;
+    };
+
+private:
+    size_t threadCount_;
+};
+
+template<typename Result>
+constexpr const size_t ConcurrentTaskRunner<Result>::kPendingResults_Max;
+
+}}
+
+#endif //VIRGIL_CLI_CONCURRENT_TASK_RUNNER_H
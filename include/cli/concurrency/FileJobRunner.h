@@ -0,0 +1,91 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_FILE_JOB_RUNNER_H
+#define VIRGIL_CLI_FILE_JOB_RUNNER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace cli { namespace concurrency {
+
+/**
+ * @brief Input and output of the single file processed in the multi-file mode.
+ */
+struct FileJob {
+    std::string inputFile;
+    std::string outputFile;
+};
+
+/**
+ * @brief Process independent files concurrently.
+ *
+ * Failure of the single file is logged and does not stop processing of the other files.
+ * If handler writes the output file, then it receives job with the temporary output file, that replaces
+ * the output file only if handler succeeded, so failed file leaves neither partial output,
+ * nor removes the output of the previous run.
+ */
+class FileJobRunner {
+public:
+    using Handler = std::function<void(const FileJob& fileJob)>;
+public:
+    /**
+     * @param threadCount - number of files processed concurrently,
+     *     if ThreadPool::kThreadCount_Auto then number of the hardware threads is used.
+     * @param isOutputWritten - true if handler writes the output file, false if handler only reads it,
+     *     i.e. output file holds the signature to be verified.
+     */
+    FileJobRunner(size_t threadCount, bool isOutputWritten);
+
+    /**
+     * @brief Process each of the given files with the given handler.
+     * @note Handler is called concurrently, so it must use shared state in the read-only manner.
+     * @note If output is written, then handler receives copy of the job with the temporary output file.
+     * @return Number of the files that were failed to be processed.
+     */
+    size_t run(const std::vector<FileJob>& fileJobs, const Handler& handler) const;
+
+private:
+    size_t threadCount_;
+    bool isOutputWritten_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_FILE_JOB_RUNNER_H
@@ -0,0 +1,114 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_THREAD_POOL_H
+#define VIRGIL_CLI_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cli { namespace concurrency {
+
+/**
+ * @brief Fixed set of the worker threads that execute submitted tasks in the FIFO order.
+ */
+class ThreadPool {
+public:
+    static constexpr const size_t kThreadCount_Auto = 0;
+public:
+    /**
+     * @param threadCount - number of the worker threads,
+     *     if kThreadCount_Auto then number of the hardware threads is used.
+     */
+    explicit ThreadPool(size_t threadCount = kThreadCount_Auto);
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Drop tasks that were not started yet and wait for running tasks.
+     */
+    ~ThreadPool() noexcept;
+
+    /**
+     * @brief Return number of the worker threads.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Schedule given task for execution.
+     * @return Future that holds task result or exception thrown by the task.
+     */
+    template<typename Task>
+    std::future<typename std::result_of<Task()>::type> submit(Task task) {
+        using Result = typename std::result_of<Task()>::type;
+        auto packagedTask = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+        auto future = packagedTask->get_future();
+        enqueue([packagedTask]() { (*packagedTask)(); });
+        return future;
+    }
+
+    /**
+     * @brief Return number of the hardware threads, at least 1.
+     */
+    static size_t hardwareConcurrency();
+
+private:
+    void enqueue(std::function<void()> task);
+
+    void work();
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable hasTask_;
+    bool stopped_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_THREAD_POOL_H
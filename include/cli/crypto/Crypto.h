@@ -49,6 +49,8 @@
 #include <virgil/crypto/foundation/VirgilHash.h>
 #include <virgil/crypto/foundation/VirgilBase64.h>
 #include <virgil/crypto/foundation/VirgilPBKDF.h>
+#include <virgil/crypto/foundation/VirgilRandom.h>
+#include <virgil/crypto/foundation/VirgilSymmetricCipher.h>
 
 #include <cli/model/FileDataSource.h>
 #include <cli/model/FileDataSink.h>
@@ -76,6 +78,8 @@ public:
     using HashAlgorithm = virgil::crypto::foundation::VirgilHash::Algorithm;
     using Base64 = virgil::crypto::foundation::VirgilBase64;
     using KeyDerivation = virgil::crypto::foundation::VirgilPBKDF;
+    using Random = virgil::crypto::foundation::VirgilRandom;
+    using SymmetricCipher = virgil::crypto::foundation::VirgilSymmetricCipher;
     // Smart pointers
     using DataSourceUnique = std::unique_ptr<DataSource>;
     using DataSinkUnique = std::unique_ptr<DataSink>;
@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_AGENT_CHANNEL_H
+#define VIRGIL_CLI_AGENT_CHANNEL_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/io/UnixSocket.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Message channel between the long-running CLI processes (key agent, command server) and their clients.
+ *
+ * Message is framed as: type (1 byte), payload size (4 bytes, big endian), payload.
+ * Connection serves single request: request message, optional Data messages terminated by the End message,
+ * and then response - optional Data messages terminated by the Success or the Failure message.
+ */
+class AgentChannel {
+public:
+    static constexpr const size_t kPayloadSize_Max = 1024 * 1024; // 1MB
+
+    enum class Message : unsigned char {
+        Success = 0,
+        Failure = 1,
+        Data = 2,
+        End = 3,
+        PublicKey = 16,
+        Sign = 17,
+        Decrypt = 18,
+        Run = 32,
+        Exit = 33
+    };
+
+    /**
+     * @brief Source that reads Data messages until the End message.
+     */
+    class DataSource : public Crypto::DataSource {
+    public:
+        explicit DataSource(AgentChannel& channel);
+        virtual bool hasData() override;
+        virtual Crypto::Bytes read() override;
+    private:
+        AgentChannel& channel_;
+        Crypto::Bytes data_;
+        bool isEnd_;
+    };
+
+    /**
+     * @brief Sink that writes data as Data messages.
+     */
+    class DataSink : public Crypto::DataSink {
+    public:
+        explicit DataSink(AgentChannel& channel);
+        virtual bool isGood() override;
+        virtual void write(const Crypto::Bytes& data) override;
+    private:
+        AgentChannel& channel_;
+    };
+
+public:
+    explicit AgentChannel(UnixSocket socket);
+
+    /**
+     * @throw ArgumentRuntimeError - if payload is too large, or write failed.
+     */
+    void write(Message type, const Crypto::Bytes& payload = Crypto::Bytes());
+
+    /**
+     * @brief Write given data as Data messages, each payload is not larger than kPayloadSize_Max.
+     */
+    void writeData(const Crypto::Bytes& data);
+
+    /**
+     * @return false - if peer closed connection.
+     * @throw ArgumentRuntimeError - if message is malformed, or read failed.
+     */
+    bool read(Message& type, Crypto::Bytes& payload);
+
+    /**
+     * @brief Skip Data messages of the request, that were not read yet.
+     */
+    void skipData();
+
+    /**
+     * @see UnixSocket::shutdown()
+     */
+    void shutdown();
+
+    /**
+     * @brief Pack given fields to the single payload, each field is prefixed with its size.
+     */
+    static Crypto::Bytes pack(const std::vector<Crypto::Bytes>& fields);
+
+    /**
+     * @throw ArgumentRuntimeError - if payload is malformed.
+     */
+    static std::vector<Crypto::Bytes> unpack(const Crypto::Bytes& payload);
+
+private:
+    UnixSocket socket_;
+    bool isEndRead_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_AGENT_CHANNEL_H
@@ -0,0 +1,90 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_AGENT_CLIENT_H
+#define VIRGIL_CLI_AGENT_CLIENT_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/io/AgentChannel.h>
+#include <cli/model/HashAlgorithm.h>
+
+#include <string>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Client of the key agent (see virgil-agent), that performs operations with private keys held by the agent.
+ *
+ * Each operation is performed over the separate connection, so client can be used from several threads.
+ */
+class AgentClient {
+public:
+    /**
+     * @param socketPath - path to the socket the agent is listening on.
+     */
+    explicit AgentClient(std::string socketPath);
+
+    /**
+     * @brief Return public key of the private key with the given alias.
+     * @throw ArgumentRuntimeError - if agent is not available, or it does not hold requested key.
+     */
+    Crypto::Bytes publicKey(const std::string& alias) const;
+
+    /**
+     * @brief Sign data from the given source with the private key with the given alias.
+     * @throw ArgumentRuntimeError - if agent is not available, or it failed to sign data.
+     */
+    Crypto::Bytes sign(const std::string& alias, model::HashAlgorithm hashAlgorithm, Crypto::DataSource& source) const;
+
+    /**
+     * @brief Decrypt data from the given source with the private key with the given alias.
+     * @note Data is streamed to the agent, and decrypted data is streamed back, so it is never stored entirely.
+     * @throw ArgumentRuntimeError - if agent is not available, or it failed to decrypt data.
+     */
+    void decrypt(const std::string& alias, Crypto::DataSource& source, Crypto::DataSink& sink) const;
+
+private:
+    Crypto::Bytes request(
+            AgentChannel::Message type, const Crypto::Bytes& payload,
+            Crypto::DataSource* source, Crypto::DataSink* sink) const;
+
+private:
+    std::string socketPath_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_AGENT_CLIENT_H
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_BUFFER_POOL_H
+#define VIRGIL_CLI_BUFFER_POOL_H
+
+#include <cstddef>
+#include <memory>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Thread safe pool of the equally sized, page aligned buffers.
+ *
+ * Buffers are returned to the pool when released, so io_uring block buffers are allocated once per pool
+ * and reused, and can stay registered in the kernel.
+ * @note Data returned by the sources is still copied to the Crypto::Bytes, because crypto interface requires
+ *     owning byte arrays, so pool does not make the whole stream allocation free.
+ */
+class BufferPool {
+public:
+    static constexpr const size_t kAlignment = 4096; // 4KB
+    static constexpr const size_t kMaxIdleBuffers_Default = 8;
+private:
+    class Impl;
+public:
+    /**
+     * @brief Buffer acquired from the pool.
+     * @note Buffer content is not initialized.
+     * @note Buffer is returned to the pool on destruction, even if pool itself was already destroyed.
+     */
+    class Buffer {
+    public:
+        Buffer();
+
+        Buffer(Buffer&& other) noexcept;
+
+        Buffer& operator=(Buffer&& other) noexcept;
+
+        ~Buffer() noexcept;
+
+        unsigned char* data() const;
+
+        size_t capacity() const;
+
+        explicit operator bool() const noexcept;
+
+    private:
+        friend class BufferPool;
+
+        Buffer(std::shared_ptr<Impl> pool, unsigned char* data);
+
+        void release() noexcept;
+
+    private:
+        std::shared_ptr<Impl> pool_;
+        unsigned char* data_;
+    };
+
+public:
+    /**
+     * @param bufferSize - size of each buffer in the pool.
+     * @param maxIdleBuffers - maximum number of released buffers that are kept for reuse,
+     *     buffers released above this limit are freed.
+     */
+    explicit BufferPool(size_t bufferSize, size_t maxIdleBuffers = kMaxIdleBuffers_Default);
+
+    BufferPool(BufferPool&&) noexcept;
+
+    BufferPool& operator=(BufferPool&&) noexcept;
+
+    ~BufferPool() noexcept;
+
+    /**
+     * @brief Take idle buffer from the pool, or allocate new one if no idle buffers left.
+     * @throw std::bad_alloc - if memory allocation failed.
+     */
+    Buffer acquire();
+
+    size_t bufferSize() const;
+
+private:
+    std::shared_ptr<Impl> impl_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_BUFFER_POOL_H
@@ -38,6 +38,7 @@
 #define VIRGIL_CLI_PATH_H
 
 #include <string>
+#include <vector>
 
 namespace cli { namespace io {
 
@@ -54,12 +55,17 @@ public:
     static std::string joinPath(const std::string& left, const std::string& right);
     static std::string pathSeparator();
     static std::string removeSubPath(const std::string& path, const std::string& subPath);
+    static std::string fileName(const std::string& path);
     static bool exists(const std::string& path, bool considerFile);
     static bool existsFile(const std::string& path);
     static bool existsDir(const std::string& path);
     static bool createPath(const std::string& path, bool considerFile);
     static bool createDir(const std::string& path);
     static bool createFile(const std::string& path);
+    /**
+     * @brief Return paths of the regular files within given directory (not recursively) in the sorted order.
+     */
+    static std::vector<std::string> listFiles(const std::string& dirPath);
 };
 
 }}
@@ -0,0 +1,76 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_SERVE_CLIENT_H
+#define VIRGIL_CLI_SERVE_CLIENT_H
+
+#include <cli/io/UnixSocket.h>
+
+#include <string>
+#include <vector>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Client of the command server (see virgil-serve), that runs command within the server process.
+ *
+ * Client passes command arguments, current directory and standard streams (stdin, stdout, stderr) to the server,
+ * so command reads and writes data directly, and waits for the command exit code.
+ */
+class ServeClient {
+public:
+    /**
+     * @brief Connect to the command server.
+     * @param socketPath - path to the socket the server is listening on.
+     * @throw ArgumentRuntimeError - if server is not available.
+     */
+    explicit ServeClient(const std::string& socketPath);
+
+    /**
+     * @brief Run command with the given arguments (including program name) by the server.
+     * @return Exit code of the command.
+     * @throw ArgumentRuntimeError - if connection was lost before command finished.
+     */
+    int run(const std::vector<std::string>& arguments);
+
+private:
+    UnixSocket socket_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_SERVE_CLIENT_H
@@ -0,0 +1,143 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_UNIX_SOCKET_H
+#define VIRGIL_CLI_UNIX_SOCKET_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Stream socket in the UNIX domain, that is used for the local communication between CLI processes.
+ *
+ * Listening socket file is created with permissions for the owner only, and is removed when socket is destroyed.
+ *
+ * @note Available only on UNIX systems.
+ */
+class UnixSocket {
+public:
+    /**
+     * @brief Create socket that is not connected.
+     */
+    UnixSocket();
+
+    UnixSocket(UnixSocket&& other) noexcept;
+
+    UnixSocket& operator=(UnixSocket&& other) noexcept;
+
+    ~UnixSocket() noexcept;
+
+    /**
+     * @brief Connect to the socket listening on the given path.
+     * @throw ArgumentRuntimeError - if connection failed.
+     */
+    static UnixSocket connect(const std::string& path);
+
+    /**
+     * @brief Listen on the given path.
+     * @note Socket file that is left by the terminated process is replaced.
+     * @throw ArgumentRuntimeError - if path is used by another listening process, or if socket can not be bound.
+     */
+    static UnixSocket listen(const std::string& path);
+
+    /**
+     * @brief Wait for the incoming connection at most given number of milliseconds.
+     * @return Connected socket, or not connected socket if time is out, or waiting was interrupted by a signal.
+     */
+    UnixSocket accept(int timeoutMs) const;
+
+    bool isValid() const;
+
+    /**
+     * @brief Return true if connected peer process is run by the same user.
+     */
+    bool isPeerOwner() const;
+
+    /**
+     * @brief Write all given data.
+     * @throw ArgumentRuntimeError - if peer closed connection, or write failed.
+     */
+    void write(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Read exactly given number of bytes.
+     * @return false - if peer closed connection before first byte was read.
+     * @throw ArgumentRuntimeError - if peer closed connection in the middle of the data, or read failed.
+     */
+    bool read(unsigned char* data, size_t size);
+
+    /**
+     * @brief Pass given file descriptors to the peer process.
+     * @throw ArgumentRuntimeError - if peer closed connection, or write failed.
+     */
+    void writeDescriptors(const std::vector<int>& descriptors);
+
+    /**
+     * @brief Receive file descriptors passed by the peer process with @link writeDescriptors() @endlink.
+     * @return Received descriptors, that should be closed by the caller,
+     *     or empty list if peer closed connection before descriptors were passed.
+     * @throw ArgumentRuntimeError - if other number of descriptors was passed, or read failed.
+     */
+    std::vector<int> readDescriptors(size_t count);
+
+    /**
+     * @brief Stop communication in both directions.
+     * @note Reads and writes that are blocked in other threads are interrupted.
+     */
+    void shutdown();
+
+    void close() noexcept;
+
+    /**
+     * @brief Close socket descriptor, but keep socket file.
+     * @note Used by the child process, that inherited listening socket, that is still used by the parent process.
+     */
+    void detach() noexcept;
+
+private:
+    explicit UnixSocket(int descriptor, std::string path = std::string());
+
+private:
+    int descriptor_;
+    std::string path_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_UNIX_SOCKET_H
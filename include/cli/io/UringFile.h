@@ -0,0 +1,161 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_URING_FILE_H
+#define VIRGIL_CLI_URING_FILE_H
+
+#include <cli/io/BufferPool.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace cli { namespace io {
+
+/**
+ * @brief Sequential reader of the regular file, that keeps several block reads in flight with io_uring.
+ *
+ * Blocks are read to the buffers taken from the given pool, buffers are registered in the kernel if it is allowed.
+ * File is opened with O_DIRECT if file system and block size allow it, so page cache copy is avoided.
+ *
+ * @note Available only if CLI is built with io_uring support (USE_IO_URING is ON and liburing is found).
+ */
+class UringFileReader {
+public:
+    static constexpr const size_t kQueueDepth_Default = 4;
+    /**
+     * @brief Block data, that is valid until next call of the @link next() @endlink method.
+     */
+    using Block = std::pair<const unsigned char*, size_t>;
+public:
+    /**
+     * @brief Open given file for reading.
+     * @param fileName - path to the file to be read.
+     * @param bufferPool - pool that provides block buffers, block size is equal to the pool buffer size.
+     * @param queueDepth - maximum number of the reads in flight.
+     * @return Reader, or nullptr if file is not a regular file, if file fits single block,
+     *     or if io_uring is not supported by the kernel.
+     */
+    static std::unique_ptr<UringFileReader> create(
+            const std::string& fileName, std::shared_ptr<BufferPool> bufferPool,
+            size_t queueDepth = kQueueDepth_Default);
+
+    ~UringFileReader() noexcept;
+
+    /**
+     * @brief Return file size.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Wait for the next block of the file.
+     * @return Next block, or empty block if end of file is reached.
+     * @throw ArgumentRuntimeError - if read failed.
+     */
+    Block next();
+
+    /**
+     * @brief Drop blocks that were read ahead and continue reading from the block that contains given offset.
+     * @return Offset of that block, next call of the @link next() @endlink method returns it.
+     * @throw ArgumentRuntimeError - if read that was in flight failed.
+     */
+    size_t seek(size_t offset);
+
+private:
+    class Impl;
+
+    explicit UringFileReader(std::unique_ptr<Impl> impl);
+
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * @brief Sequential writer to the file, that keeps several block writes in flight with io_uring.
+ *
+ * Data is accumulated in the buffers taken from the given pool, full buffer is submitted for writing,
+ * and next buffer is used while write is in progress.
+ *
+ * @note Available only if CLI is built with io_uring support (USE_IO_URING is ON and liburing is found).
+ */
+class UringFileWriter {
+public:
+    static constexpr const size_t kQueueDepth_Default = 4;
+public:
+    /**
+     * @brief Create or truncate given file for writing.
+     * @param fileName - path to the file to be written.
+     * @param bufferPool - pool that provides block buffers, block size is equal to the pool buffer size.
+     * @param queueDepth - maximum number of the writes in flight.
+     * @return Writer, or nullptr if file can not be opened, or if io_uring is not supported by the kernel.
+     */
+    static std::unique_ptr<UringFileWriter> create(
+            const std::string& fileName, std::shared_ptr<BufferPool> bufferPool,
+            size_t queueDepth = kQueueDepth_Default);
+
+    /**
+     * @brief Flush pending data.
+     * @note This is a fallback, errors are lost here. Call @link flush() @endlink and check
+     *       @link isGood() @endlink to ensure that all data is written.
+     */
+    ~UringFileWriter() noexcept;
+
+    /**
+     * @brief Return false if any write failed.
+     */
+    bool isGood() const;
+
+    void write(const unsigned char* data, size_t size);
+
+    /**
+     * @brief Submit buffered data and wait until all writes are completed.
+     */
+    void flush();
+
+private:
+    class Impl;
+
+    explicit UringFileWriter(std::unique_ptr<Impl> impl);
+
+private:
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_URING_FILE_H
@@ -0,0 +1,146 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_CARD_CACHE_H
+#define VIRGIL_CLI_CARD_CACHE_H
+
+#include <cli/model/Card.h>
+
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Local cache of the Virgil Cards, that are received from the Cards service.
+ *
+ * Entries are stored in the directory (one file per entry) and mapped by:
+ *     - card id - for the Virgil Card that is requested by its identifier;
+ *     - identity, identity type and scope - for the search results, empty result is cached as well (negative entry).
+ *
+ * Signatures of the cached Virgil Cards are verified on load, so tampered entries are dropped.
+ * Entries that were loaded once are kept in memory, so repeated lookups within the process do not touch the disk.
+ *
+ * Virgil Cards are not cached by default, because revocation by another party is not visible until
+ * the entry expires; Virgil Cards revoked by virgil-card-revoke are removed from the cache immediately,
+ * and search results of the identity are dropped when virgil-card-create creates new Virgil Card for it.
+ */
+class CardCache {
+public:
+    static constexpr const std::time_t kTtl_Default = 0; // disabled
+    static constexpr const std::time_t kNegativeTtl_Default = 10 * 60; // 10 minutes
+public:
+    /**
+     * @brief Return cache that is shared by all commands of the process, it is stored in $HOME/.virgil/conf/cards.
+     */
+    static std::shared_ptr<CardCache> shared();
+
+    /**
+     * @brief Create cache that is stored in the given directory, directory is created on the first write.
+     */
+    explicit CardCache(std::string dirPath);
+
+    /**
+     * @brief Set time to live of the Virgil Cards in seconds, if 0, then cache is not used.
+     */
+    void setTtl(std::time_t ttl);
+
+    /**
+     * @brief Set time to live of the empty search results in seconds, if 0, then they are not cached.
+     */
+    void setNegativeTtl(std::time_t ttl);
+
+    /**
+     * @return Virgil Card with the given identifier, or nullptr if it is not cached or expired.
+     */
+    std::unique_ptr<Card> findCard(const std::string& cardId) const;
+
+    /**
+     * @return Virgil Cards found by the identity, may be empty (negative entry),
+     *     or nullptr if search result is not cached or expired.
+     */
+    std::unique_ptr<std::vector<Card>> findCards(
+            const std::string& identity, const std::string& identityType, CardScope scope) const;
+
+    void addCard(const Card& card);
+
+    void addCards(
+            const std::string& identity, const std::string& identityType, CardScope scope,
+            const std::vector<Card>& cards);
+
+    /**
+     * @brief Remove Virgil Card and search results of its identity from the cache, i.e. when card is revoked,
+     *     or when new card is created for the identity.
+     */
+    void removeCard(const Card& card);
+
+private:
+    struct Entry {
+        std::time_t storedAt;
+        std::vector<Card> cards;
+    };
+
+    /**
+     * @return Cards of the entry, or nullptr if entry is not found or expired.
+     */
+    std::unique_ptr<std::vector<Card>> findEntry(const std::string& key) const;
+
+    bool isExpired(const Entry& entry) const;
+
+    void addEntry(const std::string& key, const std::vector<Card>& cards);
+
+    void removeEntry(const std::string& key);
+
+    std::unique_ptr<Entry> loadEntry(const std::string& key) const;
+
+    std::string entryPath(const std::string& key) const;
+
+private:
+    const std::string dirPath_;
+    std::atomic<std::time_t> ttl_;
+    std::atomic<std::time_t> negativeTtl_;
+    mutable std::mutex mutex_;
+    mutable std::map<std::string, Entry> entries_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_CARD_CACHE_H
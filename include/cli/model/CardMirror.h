@@ -0,0 +1,141 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_CARD_MIRROR_H
+#define VIRGIL_CLI_CARD_MIRROR_H
+
+#include <cli/model/Card.h>
+#include <cli/model/CardIdentity.h>
+
+#include <ctime>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace cli { namespace model { namespace internal {
+
+class CardMirrorIndex;
+
+}}}
+
+namespace cli { namespace model {
+
+/**
+ * @brief Local mirror of the application Virgil Cards, that is maintained by virgil-card-sync.
+ *
+ * Each Virgil Card is stored to the file <card-id>.vcard (as virgil-card-search exports them),
+ * and the file 'index' maps identity type and identity to the identifiers of the Virgil Cards.
+ * Index records are sorted by identity type and identity, one per line:
+ *     <identity-type> TAB <identity> TAB <synchronization time> [TAB <card-id>]...
+ * so index is mapped to the memory and looked up with the binary search, without parsing of the whole file.
+ *
+ * Signatures of the Virgil Cards are verified on load, so tampered files are ignored.
+ */
+class CardMirror {
+public:
+    /**
+     * @brief Open mirror that is stored in the given directory, directory is created on the first commit.
+     */
+    explicit CardMirror(std::string dirPath);
+
+    ~CardMirror() noexcept;
+
+    /**
+     * @return Virgil Cards of the identity, may be empty,
+     *     or nullptr if identity is not mirrored.
+     * @throw error::ArgumentRuntimeError - if index of the mirror is malformed.
+     */
+    std::unique_ptr<std::vector<Card>> findCards(const std::string& identity, const std::string& identityType) const;
+
+    /**
+     * @return All identities of the mirror.
+     */
+    CardIdentityGroup identities() const;
+
+    /**
+     * @return Time when Virgil Cards of the identity were synchronized, or 0 if identity is not mirrored.
+     */
+    std::time_t syncedAt(const std::string& identity, const std::string& identityType) const;
+
+    /**
+     * @brief Replace Virgil Cards of the identity with the given ones.
+     *
+     * Only Virgil Cards that are not mirrored yet are written, changes of the index are written on commit().
+     * @return Number of the written Virgil Cards.
+     */
+    size_t update(const std::string& identity, const std::string& identityType, const std::vector<Card>& cards);
+
+    /**
+     * @brief Write index, and remove files of the Virgil Cards that are not referenced by the index anymore.
+     * @return Number of the removed Virgil Cards.
+     * @throw error::ArgumentRuntimeError - if index can not be written.
+     */
+    size_t commit();
+
+private:
+    struct Record {
+        std::string identityType;
+        std::string identity;
+        std::time_t syncedAt;
+        std::vector<std::string> cardIds;
+    };
+
+    const internal::CardMirrorIndex* index() const;
+
+    std::map<std::string, Record>& records() const;
+
+    /**
+     * @brief Parse fields of the index record.
+     * @throw error::ArgumentRuntimeError - if record is malformed.
+     */
+    Record parseRecord(std::vector<std::string> fields) const;
+
+    std::unique_ptr<Card> loadCard(const std::string& cardId) const;
+
+    std::string cardPath(const std::string& cardId) const;
+
+private:
+    const std::string dirPath_;
+    mutable std::unique_ptr<internal::CardMirrorIndex> index_;
+    mutable std::unique_ptr<std::map<std::string, Record>> records_;
+    std::set<std::string> staleCardIds_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_CARD_MIRROR_H
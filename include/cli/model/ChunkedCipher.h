@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_CHUNKED_CIPHER_H
+#define VIRGIL_CLI_CHUNKED_CIPHER_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/model/EncryptCredentials.h>
+#include <cli/model/DecryptCredentials.h>
+#include <cli/model/FileDataSource.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Encrypts and decrypts data split to the independently authenticated chunks in parallel.
+ *
+ * Format: header, then sequence of the chunk records.
+ *     - header: magic (8 bytes) || chunk size (4 bytes) || envelope size (4 bytes) || envelope;
+ *     - envelope: random data key encrypted for the recipients, see KeyEnvelope;
+ *     - chunk record: AES-256-GCM ciphertext of the chunk || authentication tag (16 bytes).
+ *
+ * Every chunk except the last one has exactly 'chunk size' bytes, the last chunk is always shorter
+ * (possibly empty), so truncation and reordering of the records are detected.
+ * As all records except the last one have the same size, position of any chunk is computed from its index,
+ * so the header serves as the chunk index for the random access.
+ */
+class ChunkedCipher {
+public:
+    static constexpr const size_t kJobs_Auto = 0;
+    static constexpr const size_t kChunkSize_Default = 1024 * 1024; // 1MB
+    static constexpr const size_t kChunkSize_Max = 256 * 1024 * 1024; // 256MB
+    /**
+     * @brief Header of the data in the chunked format.
+     */
+    struct Header {
+        /**
+         * @brief Size of the plain data chunk.
+         */
+        uint64_t chunkSize;
+        /**
+         * @brief Data key encrypted for the recipients, starts with the content info.
+         */
+        Crypto::Bytes envelope;
+        /**
+         * @brief Return size of the serialized header.
+         */
+        size_t size() const;
+    };
+public:
+    /**
+     * @param jobs - number of the threads that process chunks, if kJobs_Auto then all hardware threads are used.
+     */
+    explicit ChunkedCipher(size_t jobs = kJobs_Auto);
+
+    /**
+     * @brief Return true if given data starts with the chunked format header.
+     */
+    static bool isChunked(const Crypto::Bytes& data);
+
+    /**
+     * @brief Read header of the chunked data, chunk records are not read.
+     * @throw error::ArgumentRuntimeError - if data is not in the chunked format or is truncated.
+     */
+    static Header readHeader(Crypto::DataSource& source);
+
+    void encrypt(
+            const std::vector<std::unique_ptr<EncryptCredentials>>& recipients,
+            Crypto::DataSource& source, Crypto::DataSink& sink, size_t chunkSize = kChunkSize_Default) const;
+
+    /**
+     * @return false - if none of the given recipients can decrypt data, true - otherwise.
+     * @throw error::ArgumentRuntimeError - if data is not in the chunked format or is truncated.
+     */
+    bool decrypt(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& recipients,
+            Crypto::DataSource& source, Crypto::DataSink& sink) const;
+
+    /**
+     * @brief Replace recipients of the encrypted data.
+     *
+     * Data key is decrypted with one of the given credentials and encrypted for the new recipients,
+     * then the header is rewritten, and chunk records are copied as is, without decryption.
+     *
+     * @return false - if none of the given credentials can decrypt data key, true - otherwise.
+     * @throw error::ArgumentRuntimeError - if data is not in the chunked format or is truncated.
+     */
+    bool rekey(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& credentials,
+            const std::vector<std::unique_ptr<EncryptCredentials>>& recipients,
+            Crypto::DataSource& source, Crypto::DataSink& sink) const;
+
+    /**
+     * @brief Decrypt only the given range of the plain data.
+     *
+     * Only chunks that cover the range are read and decrypted, if source is seekable,
+     * otherwise preceding chunks are read and skipped without decryption.
+     *
+     * @param offset - offset of the range within the plain data.
+     * @param length - length of the range, if range exceeds the plain data, then it is trimmed.
+     * @return false - if none of the given recipients can decrypt data, true - otherwise.
+     * @throw error::ArgumentRuntimeError - if data is not in the chunked format or is truncated.
+     */
+    bool decryptRange(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& recipients,
+            FileDataSource& source, Crypto::DataSink& sink, size_t offset, size_t length) const;
+
+private:
+    size_t jobs_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_CHUNKED_CIPHER_H
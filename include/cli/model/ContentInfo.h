@@ -0,0 +1,97 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_CONTENT_INFO_H
+#define VIRGIL_CLI_CONTENT_INFO_H
+
+#include <cli/crypto/Crypto.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Recipients of the encrypted data, that are listed in its content info.
+ */
+class ContentInfo {
+public:
+    /**
+     * @brief Parse given content info.
+     * @throw VirgilCryptoException - if content info is malformed.
+     */
+    explicit ContentInfo(const Crypto::Bytes& contentInfo);
+
+    /**
+     * @brief Parse content info that is embedded to the beginning of the encrypted data.
+     * @param head - beginning of the encrypted data,
+     *     data from the source is appended to it while content info does not fit.
+     * @param source - rest of the encrypted data.
+     * @throw error::ArgumentRuntimeError - if content info is not embedded.
+     * @throw VirgilCryptoException - if content info is malformed.
+     */
+    static ContentInfo readEmbedded(Crypto::Bytes& head, Crypto::DataSource& source);
+
+    bool hasKeyRecipient(const Crypto::Bytes& recipientId) const;
+
+    bool hasPasswordRecipient() const;
+
+    size_t keyRecipientCount() const;
+
+    size_t passwordRecipientCount() const;
+
+    /**
+     * @brief Return identifiers of the key recipients in the lexicographical order.
+     */
+    std::vector<Crypto::Bytes> keyRecipientIds() const;
+
+    /**
+     * @brief Return name of the algorithm that encrypts data, i.e. AES-256-GCM.
+     * @return Empty string - if algorithm is not recognized.
+     */
+    std::string dataCipherName() const;
+
+private:
+    std::unordered_set<std::string> keyRecipientIds_;
+    size_t passwordRecipientCount_;
+    std::string dataCipherName_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_CONTENT_INFO_H
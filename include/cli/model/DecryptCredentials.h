@@ -38,13 +38,24 @@
 #define VIRGIL_CLI_DECRYPT_CREDENTIALS_H
 
 #include <cli/crypto/Crypto.h>
+#include <cli/model/ContentInfo.h>
 
 namespace cli { namespace model {
 
 class DecryptCredentials {
 public:
+    virtual ~DecryptCredentials() noexcept = default;
+
+    /**
+     * @brief Return true if given content info lists recipient that can be decrypted with this credentials.
+     * @note Password can not be checked without decryption, so any password recipient is treated as matched.
+     */
+    bool isRecipientOf(const ContentInfo& contentInfo) const;
+
     bool decrypt(Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const;
 private:
+    virtual bool doIsRecipientOf(const ContentInfo& contentInfo) const = 0;
+
     virtual bool doDecrypt(Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const = 0;
 };
 
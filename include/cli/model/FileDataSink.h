@@ -39,24 +39,51 @@
 
 #include <virgil/crypto/VirgilDataSink.h>
 
-#include <functional>
-#include <ostream>
+#include <cli/io/BufferPool.h>
+
 #include <memory>
+#include <string>
 
 namespace cli { namespace model {
 
+namespace internal {
+class FileDataSinkBackend;
+}
+
 class FileDataSink : public virgil::crypto::VirgilDataSink {
+public:
+    static constexpr const size_t kBufferSize_Default = 1024 * 1024; // 1MB
 public:
     /**
      * @brief Create sink to the standard output
+     * @note On POSIX systems data is written directly to the file descriptor and buffered by the sink,
+     *     if standard output is a terminal, then data is written immediately.
+     * @param bufferSize - size of the buffer, that accumulates data of the small writes.
      */
-    FileDataSink();
+    FileDataSink(size_t bufferSize = kBufferSize_Default);
     /**
      * @brief Create sink to the given file.
+     * @note If io_uring is requested, CLI is built with io_uring support and kernel supports it,
+     *     then regular file is written with io_uring engine, otherwise it is written as stream.
      * @param fileName - path to the destination file to be written.
+     * @param bufferPool - pool that provides write buffers for the io_uring engine,
+     *     if nullptr, then sink creates own pool.
+     * @param useUring - defines whether io_uring engine is tried first.
      * @throw ArgumentFileNotFound, if IO errors occurred.
      */
-    FileDataSink(const std::string& fileName);
+    FileDataSink(
+            const std::string& fileName, std::shared_ptr<io::BufferPool> bufferPool = nullptr,
+            bool useUring = false);
+
+    FileDataSink(FileDataSink&&);
+
+    FileDataSink& operator=(FileDataSink&&);
+
+    /**
+     * @brief Flush buffered data.
+     * @note Write errors can not be reported here, call @link flush() @endlink to ensure that all data is written.
+     */
+    ~FileDataSink() noexcept;
 
     /**
      * @brief Return true if sink use file for output.
@@ -73,15 +100,20 @@ public:
      */
     void addNewLine();
 
+    /**
+     * @brief Write buffered data to the destination.
+     * @note Must be called when all data is written, because flush in the destructor can not report an error.
+     * @throw ArgumentRuntimeError - if output was not written completely, i.e. disk is full or pipe is closed.
+     */
+    void flush();
+
 public:
     virtual bool isGood() override;
     virtual void write(const virgil::crypto::VirgilByteArray& data) override;
     virtual void write(const std::string& text);
 private:
-    using ostream_deleter = std::function<void(std::ostream*)>;
-    using ostream_ptr = std::unique_ptr<std::ostream, ostream_deleter>;
-    ostream_ptr out_;
-    const bool isFileOutput_;
+    std::unique_ptr<internal::FileDataSinkBackend> backend_;
+    bool isFileOutput_;
 };
 
 }}
@@ -39,17 +39,23 @@
 
 #include <virgil/crypto/VirgilDataSource.h>
 
-#include <functional>
-#include <istream>
+#include <cli/io/BufferPool.h>
+
 #include <memory>
+#include <string>
 #include <vector>
 
 
 namespace cli { namespace model {
 
+namespace internal {
+class FileDataSourceBackend;
+}
+
 class FileDataSource : public virgil::crypto::VirgilDataSource {
 public:
     static constexpr const size_t kChunkSize_Default = 1024 * 1024; // 1MB
+    static constexpr const size_t kSize_Unknown = static_cast<size_t>(-1);
 public:
     /**
      * @param chunkSize - size of the data that will be returned by @link read() @endlink method.
@@ -58,11 +64,52 @@ public:
     FileDataSource(size_t chunkSize = kChunkSize_Default);
     /**
      * @brief Create source from the given file.
+     * @note If given file is a non empty regular file, then it is memory mapped, otherwise it is read as stream.
+     * @note If io_uring is requested, CLI is built with io_uring support and kernel supports it, then regular file
+     *     that is larger than single chunk is read with io_uring engine instead of memory mapping.
      * @param fileName - path to the source file to be read.
      * @param chunkSize - size of the data that will be returned by @link read() @endlink method.
+     * @param bufferPool - pool that provides block buffers for the io_uring engine,
+     *     if nullptr, then source creates own pool.
+     * @param useUring - defines whether io_uring engine is tried first.
      * @throw ArgumentFileNotFound, if IO errors occurred.
      */
-    FileDataSource(const std::string& fileName, size_t chunkSize = kChunkSize_Default);
+    FileDataSource(
+            const std::string& fileName, size_t chunkSize = kChunkSize_Default,
+            std::shared_ptr<io::BufferPool> bufferPool = nullptr, bool useUring = false);
+
+    FileDataSource(FileDataSource&&);
+
+    FileDataSource& operator=(FileDataSource&&);
+
+    ~FileDataSource() noexcept;
+
+    /**
+     * @brief Return true if source was created from the file, false - if it reads the standard input.
+     */
+    bool isFileInput() const;
+
+    /**
+     * @brief Return true if source reads data directly from the memory mapped file.
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief Return total size of the source data, or kSize_Unknown if it can not be determined, i.e. for pipes.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Return true if source supports @link seek() @endlink, i.e. it reads a regular file.
+     */
+    bool isSeekable() const;
+
+    /**
+     * @brief Move read position to the given offset from the beginning of the source data.
+     * @note Offset beyond the end of the source data is allowed, no data is read then.
+     * @throw ArgumentRuntimeError - if source is not seekable, or seek failed.
+     */
+    void seek(size_t offset);
 public:
     virtual bool hasData() override;
     virtual virgil::crypto::VirgilByteArray read() override;
@@ -71,10 +118,9 @@ public:
     virtual std::string readLine();
     virtual std::vector<std::string> readMultiLine();
 private:
-    using istream_deleter = std::function<void(std::istream*)>;
-    using istream_ptr = std::unique_ptr<std::istream, istream_deleter>;
-    istream_ptr in_;
+    std::unique_ptr<internal::FileDataSourceBackend> backend_;
     size_t chunkSize_;
+    bool isFileInput_;
 };
 
 }}
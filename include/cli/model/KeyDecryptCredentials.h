@@ -47,6 +47,8 @@ class KeyDecryptCredentials : public DecryptCredentials {
 public:
     KeyDecryptCredentials(PrivateKey privateKey);
 private:
+    virtual bool doIsRecipientOf(const ContentInfo& contentInfo) const override;
+
     virtual bool doDecrypt(
             Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const override;
 private:
@@ -0,0 +1,93 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_KEY_ENVELOPE_H
+#define VIRGIL_CLI_KEY_ENVELOPE_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/model/EncryptCredentials.h>
+#include <cli/model/DecryptCredentials.h>
+
+#include <memory>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Data key encrypted for the recipients, it is used by the chunked format and sessions.
+ *
+ * Format depends on the number of recipients:
+ *     - up to kShardRecipients: data key encrypted for all recipients with the embedded content info;
+ *     - otherwise: magic (8 bytes) || shard count (4 bytes) || { shard size (4 bytes) || shard }...,
+ *       where each shard is the data key encrypted for the next kShardRecipients recipients
+ *       with the embedded content info.
+ *
+ * Shards are encrypted in parallel, so setup time for the thousands of recipients is divided
+ * by the number of threads, and decryption stops at the first shard that lists the recipient.
+ */
+class KeyEnvelope {
+public:
+    static constexpr const size_t kJobs_Auto = 0;
+    static constexpr const size_t kShardRecipients = 64;
+public:
+    /**
+     * @brief Encrypt data key for the given recipients.
+     * @param jobs - number of the threads that encrypt shards, if kJobs_Auto then all hardware threads are used.
+     */
+    static Crypto::Bytes wrap(
+            const std::vector<std::unique_ptr<EncryptCredentials>>& recipients, const Crypto::Bytes& key,
+            size_t jobs = kJobs_Auto);
+
+    /**
+     * @brief Decrypt data key with one of the given credentials.
+     * @param keySize - expected size of the data key.
+     * @return Data key, or empty bytes if none of the given credentials can decrypt it.
+     * @throw error::ArgumentRuntimeError - if envelope is malformed.
+     */
+    static Crypto::Bytes unwrap(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& credentials, const Crypto::Bytes& envelope,
+            size_t keySize);
+
+    /**
+     * @brief Return content info of the each envelope shard.
+     * @throw error::ArgumentRuntimeError - if envelope is malformed.
+     */
+    static std::vector<Crypto::Bytes> readContentInfos(const Crypto::Bytes& envelope);
+};
+
+}}
+
+#endif //VIRGIL_CLI_KEY_ENVELOPE_H
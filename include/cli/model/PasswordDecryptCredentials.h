@@ -46,6 +46,8 @@ class PasswordDecryptCredentials : public DecryptCredentials {
 public:
     explicit PasswordDecryptCredentials(Password password);
 private:
+    virtual bool doIsRecipientOf(const ContentInfo& contentInfo) const override;
+
     virtual bool doDecrypt(
             Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const override;
 private:
@@ -0,0 +1,88 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_PIPELINED_DATA_SINK_H
+#define VIRGIL_CLI_PIPELINED_DATA_SINK_H
+
+#include <virgil/crypto/VirgilDataSink.h>
+
+#include <memory>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Sink that writes chunks to the underlying sink in the background thread.
+ *
+ * Up to 'depth' chunks are queued, so output waiting is overlapped with the data processing.
+ * Underlying sink MUST NOT be used by others until @link finish() @endlink is called.
+ */
+class PipelinedDataSink : public virgil::crypto::VirgilDataSink {
+public:
+    static constexpr const size_t kDepth_Default = 4;
+public:
+    /**
+     * @param sink - underlying sink, MUST outlive this object.
+     * @param depth - maximum number of the chunks that are waiting to be written.
+     */
+    explicit PipelinedDataSink(virgil::crypto::VirgilDataSink& sink, size_t depth = kDepth_Default);
+
+    /**
+     * @brief Stop background writing, chunks that were not written yet are dropped.
+     * @note Call @link finish() @endlink to ensure all chunks are written.
+     */
+    ~PipelinedDataSink() noexcept;
+
+    /**
+     * @brief Wait until all queued chunks are written to the underlying sink.
+     * @throw Exception that was thrown by the underlying sink.
+     */
+    void finish();
+
+public:
+    virtual bool isGood() override;
+    /**
+     * @throw Exception that was thrown by the underlying sink.
+     */
+    virtual void write(const virgil::crypto::VirgilByteArray& data) override;
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_PIPELINED_DATA_SINK_H
@@ -0,0 +1,84 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef VIRGIL_CLI_PIPELINED_DATA_SOURCE_H
+#define VIRGIL_CLI_PIPELINED_DATA_SOURCE_H
+
+#include <virgil/crypto/VirgilDataSource.h>
+
+#include <memory>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Source that reads chunks from the underlying source in the background thread.
+ *
+ * Up to 'depth' chunks are read ahead, so input waiting is overlapped with the data processing.
+ * Underlying source MUST NOT be used by others while this source exists.
+ */
+class PipelinedDataSource : public virgil::crypto::VirgilDataSource {
+public:
+    static constexpr const size_t kDepth_Default = 4;
+public:
+    /**
+     * @param source - underlying source, MUST outlive this object.
+     * @param depth - maximum number of the chunks that are read ahead.
+     */
+    explicit PipelinedDataSource(virgil::crypto::VirgilDataSource& source, size_t depth = kDepth_Default);
+
+    /**
+     * @brief Stop background reading.
+     */
+    ~PipelinedDataSource() noexcept;
+
+public:
+    /**
+     * @throw Exception that was thrown by the underlying source.
+     */
+    virtual bool hasData() override;
+    /**
+     * @throw Exception that was thrown by the underlying source.
+     */
+    virtual virgil::crypto::VirgilByteArray read() override;
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_PIPELINED_DATA_SOURCE_H
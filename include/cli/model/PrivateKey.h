@@ -43,10 +43,28 @@
 
 namespace cli { namespace model {
 
+/**
+ * @brief Private key, that can be unlocked once and then used without the password based key derivation.
+ *
+ * Unlocked keys are cached per process, so the same encrypted key with the same password
+ * is decrypted only once, even if it is read several times.
+ */
 class PrivateKey : public Key {
+public:
+    /**
+     * @brief Defines how unlocked key is kept in the process wide cache.
+     */
+    enum class CacheMode {
+        Shared, ///< Cached with the bounded lifetime, least recently used keys are evicted.
+        Pinned, ///< Cached until the process exit, i.e. keys of the command server inherited by the commands.
+        None    ///< Not cached, i.e. keys of the key agent, that are held in the locked memory only.
+    };
 public:
     using Key::Key;
 
+    /**
+     * @note Public key is extracted once and then cached.
+     */
     PublicKey extractPublic() const;
 
     void setPassword(SecureValue keyPassword);
@@ -58,8 +76,23 @@ public:
     bool checkPassword() const;
 
     bool isEncrypted() const;
+
+    /**
+     * @brief Decrypt private key with the given password, and keep decrypted key and password on success.
+     * @param cacheMode - defines how unlocked key is kept in the process wide cache.
+     * @return false - if password is wrong, true - otherwise.
+     */
+    bool unlock(const SecureValue& keyPassword, CacheMode cacheMode = CacheMode::Shared);
+
+    /**
+     * @brief Return private key that is not encrypted, so it MUST be used with an empty password.
+     * @throw error::ArgumentRuntimeError - if key is encrypted and was not unlocked.
+     */
+    const Crypto::Bytes& unlockedKey() const;
 private:
     SecureValue password_;
+    SecureValue unlockedKey_;
+    mutable Crypto::Bytes publicKey_;
 };
 
 }}
@@ -0,0 +1,117 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_SERVICE_CLIENT_H
+#define VIRGIL_CLI_SERVICE_CLIENT_H
+
+#include <cli/model/Card.h>
+#include <cli/model/CardIdentity.h>
+
+#include <virgil/sdk/client/Client.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Process wide client of the Virgil services.
+ *
+ * Client is created once per application access token and is shared by the commands and value sources
+ * (i.e. within virgil-batch, virgil-serve and concurrent recipient lookups), so service configuration
+ * is built once, and connections kept alive by the SDK transport are reused by the next requests.
+ *
+ * Client does not verify signatures of the received Virgil Cards, caller verifies them with validate(),
+ * that spreads verification of the large search results over the threads.
+ */
+class ServiceClient {
+public:
+    /**
+     * @brief Identities of the same type, that are searched by the single request.
+     */
+    struct SearchBatch {
+        std::string identityType;
+        std::vector<std::string> identities;
+    };
+
+    using SearchHandler = std::function<void(const SearchBatch& batch, std::vector<Card>& cards)>;
+public:
+    /**
+     * @brief Return client for the given application access token, create it on the first call.
+     * @throw error::ArgumentNotFoundError - if access token is empty.
+     */
+    static std::shared_ptr<virgil::sdk::client::Client> get(const std::string& accessToken);
+
+    /**
+     * @brief Verify signatures of the Virgil Cards, large lists are verified in parallel by the process wide pool.
+     *
+     * Fingerprints of the verified Virgil Cards are memorized, so the same Virgil Card
+     * is not verified again within the process.
+     * @throw error::ArgumentRuntimeError - if any Virgil Card has invalid signature.
+     */
+    static void validate(const std::vector<Card>& cards);
+
+    /**
+     * @brief Verify signatures of the Virgil Card.
+     * @throw error::ArgumentRuntimeError - if Virgil Card has invalid signature.
+     */
+    static void validate(const Card& card);
+
+    /**
+     * @brief Return true if Virgil Card has valid signatures.
+     */
+    static bool isValid(const Card& card);
+
+    /**
+     * @brief Search for the Virgil Cards of the given identities.
+     *
+     * Identities are split to the batches of the limited size, and batches are requested concurrently.
+     * Found Virgil Cards are validated, and then passed to the handler in the calling thread,
+     * batch by batch in the order the searches complete.
+     *
+     * @throw First error of the search, of the validation or of the handler,
+     *     searches that were not started yet are cancelled then.
+     */
+    static void searchCards(
+            const std::shared_ptr<virgil::sdk::client::Client>& client, const CardIdentityGroup& identityGroup,
+            CardScope scope, const SearchHandler& handler);
+};
+
+}}
+
+#endif //VIRGIL_CLI_SERVICE_CLIENT_H
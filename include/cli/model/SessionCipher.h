@@ -0,0 +1,151 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef VIRGIL_CLI_SESSION_CIPHER_H
+#define VIRGIL_CLI_SESSION_CIPHER_H
+
+#include <cli/crypto/Crypto.h>
+#include <cli/model/EncryptCredentials.h>
+#include <cli/model/DecryptCredentials.h>
+#include <cli/model/SecureValue.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cli { namespace model {
+
+/**
+ * @brief Encrypts many small messages with the single data key, that is encrypted for the recipients once.
+ *
+ * Format:
+ *     - session header: magic (8 bytes) || session id (16 bytes) || envelope size (4 bytes) || envelope;
+ *     - envelope: random data key encrypted for the recipients, see KeyEnvelope;
+ *     - message: magic (8 bytes) || session id (16 bytes) || nonce (12 bytes) || AES-256-GCM ciphertext || tag (16 bytes).
+ *
+ * Only the process that started the session encrypts its messages, so nonce is the message counter.
+ * Started sessions are kept in memory only, so session can not be continued by another process.
+ * Data key of the opened session is decrypted with the given credentials on each open.
+ */
+class SessionCipher {
+public:
+    /**
+     * @brief Start new session for the given recipients.
+     */
+    static std::shared_ptr<const SessionCipher> start(
+            const std::vector<std::unique_ptr<EncryptCredentials>>& recipients);
+
+    /**
+     * @brief Return session with the given header, that was started by this process.
+     * @return nullptr - if session was not started by this process.
+     */
+    static std::shared_ptr<const SessionCipher> find(const Crypto::Bytes& header);
+
+    /**
+     * @brief Open session with the given header to decrypt its messages.
+     *
+     * Data key is always decrypted with the given credentials, so open the session once
+     * for all of its messages.
+     * @return nullptr - if none of the given recipients can decrypt the session data key.
+     * @throw error::ArgumentRuntimeError - if header is malformed.
+     */
+    static std::shared_ptr<const SessionCipher> open(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& recipients, const Crypto::Bytes& header);
+
+    /**
+     * @brief Replace recipients of the session.
+     *
+     * Session key is decrypted with one of the given credentials and encrypted for the new recipients,
+     * session id and key are kept, so messages of the session remain valid.
+     *
+     * @return New session header, or empty bytes if none of the given credentials can decrypt session key.
+     * @throw error::ArgumentRuntimeError - if header is malformed.
+     */
+    static Crypto::Bytes rekey(
+            const std::vector<std::unique_ptr<DecryptCredentials>>& credentials,
+            const std::vector<std::unique_ptr<EncryptCredentials>>& recipients, const Crypto::Bytes& header);
+
+    /**
+     * @brief Return data key envelope of the session header, see KeyEnvelope.
+     * @throw error::ArgumentRuntimeError - if header is malformed.
+     */
+    static Crypto::Bytes readEnvelope(const Crypto::Bytes& header);
+
+    /**
+     * @brief Return session id from the session header or the beginning of the session message.
+     * @throw error::ArgumentRuntimeError - if data is neither session header nor session message.
+     */
+    static Crypto::Bytes readSessionId(const Crypto::Bytes& data);
+
+    /**
+     * @brief Return true if given data starts with the session header magic.
+     */
+    static bool isHeader(const Crypto::Bytes& data);
+
+    /**
+     * @brief Return true if given data starts with the session message magic.
+     */
+    static bool isMessage(const Crypto::Bytes& data);
+
+    const Crypto::Bytes& header() const;
+
+    /**
+     * @brief Encrypt data from the source as the next message of the session.
+     * @throw error::ArgumentLogicError - if session was not started by this process.
+     */
+    void encrypt(Crypto::DataSource& source, Crypto::DataSink& sink) const;
+
+    /**
+     * @brief Decrypt message of the session.
+     * @throw error::ArgumentRuntimeError - if message belongs to another session, or is truncated.
+     * @throw VirgilCryptoException - if message is corrupted.
+     */
+    void decrypt(Crypto::DataSource& source, Crypto::DataSink& sink) const;
+
+    SessionCipher(Crypto::Bytes header, Crypto::Bytes sessionId, SecureValue key, bool isStarted);
+
+private:
+    Crypto::Bytes header_;
+    Crypto::Bytes sessionId_;
+    SecureValue key_;
+    bool isStarted_;
+    mutable std::atomic<uint64_t> messageCount_;
+};
+
+}}
+
+#endif //VIRGIL_CLI_SESSION_CIPHER_H
@@ -37,10 +37,18 @@
 #ifndef VIRGIL_CLI_SIGNER_CREDENTIALS_H
 #define VIRGIL_CLI_SIGNER_CREDENTIALS_H
 
+#include <cli/crypto/Crypto.h>
+#include <cli/model/HashAlgorithm.h>
+
 namespace cli { namespace model {
 
 class SignerCredentials {
+public:
+    virtual ~SignerCredentials() noexcept = default;
 
+    Crypto::Bytes sign(Crypto::DataSource& source, HashAlgorithm hashAlgorithm) const;
+private:
+    virtual Crypto::Bytes doSign(Crypto::DataSource& source, HashAlgorithm hashAlgorithm) const = 0;
 };
 
 }}
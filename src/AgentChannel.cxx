@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/io/AgentChannel.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <algorithm>
+
+using cli::Crypto;
+using cli::io::AgentChannel;
+using cli::io::UnixSocket;
+
+namespace {
+
+constexpr const size_t kHeaderSize = 5;
+constexpr const size_t kFieldSizeSize = 4;
+
+void writeSize(unsigned char* data, size_t size) {
+    data[0] = static_cast<unsigned char>(size >> 24);
+    data[1] = static_cast<unsigned char>(size >> 16);
+    data[2] = static_cast<unsigned char>(size >> 8);
+    data[3] = static_cast<unsigned char>(size);
+}
+
+size_t readSize(const unsigned char* data) {
+    return (static_cast<size_t>(data[0]) << 24) | (static_cast<size_t>(data[1]) << 16) |
+           (static_cast<size_t>(data[2]) << 8) | static_cast<size_t>(data[3]);
+}
+
+}
+
+AgentChannel::DataSource::DataSource(AgentChannel& channel) : channel_(channel), isEnd_(false) {
+}
+
+bool AgentChannel::DataSource::hasData() {
+    while (!isEnd_ && data_.empty()) {
+        Message type;
+        if (!channel_.read(type, data_)) {
+            throw cli::error::ArgumentRuntimeError("Connection was closed before the end of the data.");
+        }
+        if (type == Message::End) {
+            isEnd_ = true;
+        } else if (type != Message::Data) {
+            throw cli::error::ArgumentRuntimeError("Unexpected message, data was expected.");
+        }
+    }
+    return !data_.empty();
+}
+
+Crypto::Bytes AgentChannel::DataSource::read() {
+    if (!hasData()) {
+        return Crypto::Bytes();
+    }
+    Crypto::Bytes result;
+    result.swap(data_);
+    return result;
+}
+
+AgentChannel::DataSink::DataSink(AgentChannel& channel) : channel_(channel) {
+}
+
+bool AgentChannel::DataSink::isGood() {
+    return true;
+}
+
+void AgentChannel::DataSink::write(const Crypto::Bytes& data) {
+    channel_.writeData(data);
+}
+
+AgentChannel::AgentChannel(UnixSocket socket) : socket_(std::move(socket)), isEndRead_(false) {
+}
+
+void AgentChannel::write(Message type, const Crypto::Bytes& payload) {
+    if (payload.size() > kPayloadSize_Max) {
+        throw error::ArgumentRuntimeError("Key agent message is too large.");
+    }
+    unsigned char header[kHeaderSize];
+    header[0] = static_cast<unsigned char>(type);
+    writeSize(header + 1, payload.size());
+    socket_.write(header, sizeof(header));
+    socket_.write(payload.data(), payload.size());
+}
+
+void AgentChannel::writeData(const Crypto::Bytes& data) {
+    for (size_t offset = 0; offset < data.size(); offset += kPayloadSize_Max) {
+        const auto end = data.cbegin() + std::min(data.size(), offset + kPayloadSize_Max);
+        write(Message::Data, Crypto::Bytes(data.cbegin() + offset, end));
+    }
+}
+
+bool AgentChannel::read(Message& type, Crypto::Bytes& payload) {
+    unsigned char header[kHeaderSize];
+    if (!socket_.read(header, sizeof(header))) {
+        return false;
+    }
+    const auto size = readSize(header + 1);
+    if (size > kPayloadSize_Max) {
+        throw error::ArgumentRuntimeError("Key agent message is too large.");
+    }
+    payload.resize(size);
+    if (size > 0 && !socket_.read(payload.data(), size)) {
+        throw error::ArgumentRuntimeError("Connection was closed in the middle of the message.");
+    }
+    type = static_cast<Message>(header[0]);
+    if (type == Message::End) {
+        isEndRead_ = true;
+    }
+    return true;
+}
+
+void AgentChannel::skipData() {
+    Message type;
+    Crypto::Bytes payload;
+    while (!isEndRead_ && read(type, payload)) {
+        // Drop data, so peer is not failed on writing before it reads the response
+    }
+}
+
+void AgentChannel::shutdown() {
+    socket_.shutdown();
+}
+
+Crypto::Bytes AgentChannel::pack(const std::vector<Crypto::Bytes>& fields) {
+    Crypto::Bytes result;
+    for (const auto& field : fields) {
+        unsigned char size[kFieldSizeSize];
+        writeSize(size, field.size());
+        result.insert(result.end(), size, size + kFieldSizeSize);
+        result.insert(result.end(), field.cbegin(), field.cend());
+    }
+    return result;
+}
+
+std::vector<Crypto::Bytes> AgentChannel::unpack(const Crypto::Bytes& payload) {
+    std::vector<Crypto::Bytes> result;
+    size_t offset = 0;
+    while (offset < payload.size()) {
+        if (payload.size() - offset < kFieldSizeSize) {
+            throw error::ArgumentRuntimeError("Key agent message is malformed.");
+        }
+        const auto size = readSize(payload.data() + offset);
+        offset += kFieldSizeSize;
+        if (payload.size() - offset < size) {
+            throw error::ArgumentRuntimeError("Key agent message is malformed.");
+        }
+        result.emplace_back(payload.cbegin() + offset, payload.cbegin() + offset + size);
+        offset += size;
+    }
+    return result;
+}
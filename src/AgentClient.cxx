@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/io/AgentClient.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <atomic>
+#include <future>
+
+using cli::Crypto;
+using cli::io::AgentChannel;
+using cli::io::AgentClient;
+using cli::io::UnixSocket;
+using cli::model::HashAlgorithm;
+
+AgentClient::AgentClient(std::string socketPath) : socketPath_(std::move(socketPath)) {
+}
+
+Crypto::Bytes AgentClient::publicKey(const std::string& alias) const {
+    return request(AgentChannel::Message::PublicKey, Crypto::Bytes(alias.cbegin(), alias.cend()), nullptr, nullptr);
+}
+
+Crypto::Bytes AgentClient::sign(
+        const std::string& alias, HashAlgorithm hashAlgorithm, Crypto::DataSource& source) const {
+    auto payload = AgentChannel::pack({
+            Crypto::Bytes(alias.cbegin(), alias.cend()),
+            Crypto::Bytes(1, static_cast<unsigned char>(hashAlgorithm))
+    });
+    return request(AgentChannel::Message::Sign, payload, &source, nullptr);
+}
+
+void AgentClient::decrypt(const std::string& alias, Crypto::DataSource& source, Crypto::DataSink& sink) const {
+    request(AgentChannel::Message::Decrypt, Crypto::Bytes(alias.cbegin(), alias.cend()), &source, &sink);
+}
+
+Crypto::Bytes AgentClient::request(
+        AgentChannel::Message type, const Crypto::Bytes& payload,
+        Crypto::DataSource* source, Crypto::DataSink* sink) const {
+    DLOG(INFO) << tfm::format("Send request to the key agent: '%s'.", socketPath_);
+    AgentChannel channel(UnixSocket::connect(socketPath_));
+    channel.write(type, payload);
+    // Data is written in the separate thread, because agent can respond before all data is read,
+    // i.e. decrypted data is returned while encrypted data is still streamed.
+    std::atomic<bool> isStopped(false);
+    std::future<void> writer;
+    if (source != nullptr) {
+        writer = std::async(std::launch::async, [&channel, &isStopped, source]() {
+            while (!isStopped && source->hasData()) {
+                channel.writeData(source->read());
+            }
+            channel.write(AgentChannel::Message::End);
+        });
+    }
+    auto response = AgentChannel::Message::Failure;
+    Crypto::Bytes result;
+    bool isResponseRead = false;
+    try {
+        while ((isResponseRead = channel.read(response, result)) && response == AgentChannel::Message::Data) {
+            if (sink == nullptr) {
+                throw error::ArgumentRuntimeError("Key agent returned unexpected data.");
+            }
+            sink->write(result);
+        }
+    } catch (...) {
+        isStopped = true;
+        channel.shutdown();
+        if (writer.valid()) {
+            writer.wait();
+        }
+        throw;
+    }
+    isStopped = true;
+    if (isResponseRead && response == AgentChannel::Message::Success) {
+        if (writer.valid()) {
+            writer.get();
+        }
+        return result;
+    }
+    if (writer.valid()) {
+        writer.wait();
+    }
+    if (isResponseRead && response == AgentChannel::Message::Failure) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Key agent failed: %s", std::string(result.cbegin(), result.cend())));
+    }
+    throw error::ArgumentRuntimeError("Key agent closed connection unexpectedly.");
+}
@@ -0,0 +1,291 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/command/AgentCommand.h>
+
+#include <cli/api/api.h>
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/AgentChannel.h>
+#include <cli/io/Logger.h>
+#include <cli/io/Path.h>
+#include <cli/io/UnixSocket.h>
+#include <cli/memory.h>
+
+#include <csignal>
+#include <cstring>
+#include <map>
+
+#if OS_UNIX
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#endif //OS_UNIX
+
+#if OS_LINUX
+#include <sys/prctl.h>
+#endif //OS_LINUX
+
+using cli::Crypto;
+using cli::command::AgentCommand;
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentParseOptions;
+using cli::concurrency::ThreadPool;
+using cli::io::AgentChannel;
+using cli::io::Path;
+using cli::io::UnixSocket;
+using cli::model::HashAlgorithm;
+using cli::model::PrivateKey;
+
+namespace {
+
+constexpr const int kAcceptTimeoutMs = 500;
+
+volatile std::sig_atomic_t gIsStopRequested = 0;
+
+extern "C" void requestStop(int) {
+    gIsStopRequested = 1;
+}
+
+void installSignalHandlers() {
+#if OS_UNIX
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    ::sigaction(SIGHUP, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+#else
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+#endif //OS_UNIX
+}
+
+/**
+ * @brief Keep agent memory out of the core dumps, and lock it in RAM if it is allowed.
+ * @note Whole process memory is locked only if memory lock limit is unlimited,
+ *     otherwise only buffers of the unlocked keys are locked, see @link lockKey() @endlink.
+ */
+void protectMemory() {
+#if OS_LINUX
+    ::prctl(PR_SET_DUMPABLE, 0);
+#endif //OS_LINUX
+#if OS_UNIX
+    struct rlimit limit;
+    limit.rlim_cur = 0;
+    limit.rlim_max = 0;
+    ::setrlimit(RLIMIT_CORE, &limit);
+    if (::getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur == RLIM_INFINITY) {
+        if (::mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            LOG(WARNING) << tfm::format("Can not lock memory of the key agent: %s", std::strerror(errno));
+        }
+    }
+#endif //OS_UNIX
+}
+
+void lockKey(const Crypto::Bytes& key) {
+#if OS_UNIX
+    if (!key.empty() && ::mlock(key.data(), key.size()) != 0) {
+        LOG(WARNING) << tfm::format("Can not lock memory of the unlocked Private Key, it can be swapped to disk: %s",
+                std::strerror(errno));
+    }
+#else
+    (void)key;
+#endif //OS_UNIX
+}
+
+/**
+ * @brief Unlocked private keys mapped by alias.
+ */
+class Keyring {
+public:
+    void add(PrivateKey privateKey) {
+        const auto alias = privateKey.identifier();
+        if (keys_.find(alias) != keys_.end()) {
+            throw cli::error::ArgumentRuntimeError(tfm::format(
+                    "Private Key alias '%s' is used more than once.", std::string(alias.cbegin(), alias.cend())));
+        }
+        auto publicKey = privateKey.extractPublic().key();
+        lockKey(privateKey.unlockedKey());
+        keys_.emplace(alias, Entry{ std::move(privateKey), std::move(publicKey) });
+    }
+
+    const PrivateKey& privateKey(const Crypto::Bytes& alias) const {
+        return find(alias).privateKey;
+    }
+
+    const Crypto::Bytes& publicKey(const Crypto::Bytes& alias) const {
+        return find(alias).publicKey;
+    }
+
+    size_t size() const {
+        return keys_.size();
+    }
+
+private:
+    struct Entry {
+        PrivateKey privateKey;
+        Crypto::Bytes publicKey;
+    };
+
+    const Entry& find(const Crypto::Bytes& alias) const {
+        auto found = keys_.find(alias);
+        if (found == keys_.end()) {
+            throw cli::error::ArgumentRuntimeError(tfm::format(
+                    "Private Key '%s' is not held by the agent.", std::string(alias.cbegin(), alias.cend())));
+        }
+        return found->second;
+    }
+
+private:
+    std::map<Crypto::Bytes, Entry> keys_;
+};
+
+HashAlgorithm toHashAlgorithm(const Crypto::Bytes& value) {
+    if (value.size() != 1 || value[0] > static_cast<unsigned char>(HashAlgorithm::SHA512)) {
+        throw cli::error::ArgumentRuntimeError("Unsupported hash algorithm.");
+    }
+    return static_cast<HashAlgorithm>(value[0]);
+}
+
+void processRequest(const Keyring& keyring, AgentChannel::Message type, const Crypto::Bytes& payload,
+        AgentChannel& channel) {
+    switch (type) {
+        case AgentChannel::Message::PublicKey: {
+            channel.write(AgentChannel::Message::Success, keyring.publicKey(payload));
+            break;
+        }
+        case AgentChannel::Message::Sign: {
+            const auto fields = AgentChannel::unpack(payload);
+            if (fields.size() != 2) {
+                throw cli::error::ArgumentRuntimeError("Malformed sign request.");
+            }
+            const auto& privateKey = keyring.privateKey(fields[0]);
+            AgentChannel::DataSource source(channel);
+            Crypto::StreamSigner signer(toHashAlgorithm(fields[1]));
+            channel.write(AgentChannel::Message::Success, signer.sign(source, privateKey.unlockedKey()));
+            break;
+        }
+        case AgentChannel::Message::Decrypt: {
+            const auto& privateKey = keyring.privateKey(payload);
+            AgentChannel::DataSource source(channel);
+            AgentChannel::DataSink sink(channel);
+            Crypto::StreamCipher cipher;
+            cipher.decryptWithKey(source, sink, payload, privateKey.unlockedKey());
+            channel.write(AgentChannel::Message::Success);
+            break;
+        }
+        default:
+            throw cli::error::ArgumentRuntimeError("Unsupported request.");
+    }
+}
+
+void serve(const Keyring& keyring, AgentChannel& channel) {
+    AgentChannel::Message type;
+    Crypto::Bytes payload;
+    if (!channel.read(type, payload)) {
+        return;
+    }
+    try {
+        processRequest(keyring, type, payload, channel);
+    } catch (const std::exception& exception) {
+        LOG(WARNING) << tfm::format("Key agent request failed: %s", exception.what());
+        const std::string message = exception.what();
+        channel.write(AgentChannel::Message::Failure, Crypto::Bytes(message.cbegin(), message.cend()));
+        if (type == AgentChannel::Message::Sign || type == AgentChannel::Message::Decrypt) {
+            channel.skipData();
+        }
+    }
+}
+
+}
+
+const char* AgentCommand::doGetName() const {
+    return arg::value::VIRGIL_COMMAND_AGENT;
+}
+
+const char* AgentCommand::doGetUsage() const {
+    return usage::VIRGIL_AGENT;
+}
+
+ArgumentParseOptions AgentCommand::doGetArgumentParseOptions() const {
+    return ArgumentParseOptions().disableOptionsFirst();
+}
+
+void AgentCommand::doProcess() const {
+    protectMemory();
+
+    ULOG1(INFO) << "Read arguments.";
+    auto socketPath = getArgumentIO()->getAgentSocket(ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    Keyring keyring;
+    for (auto&& privateKey : getArgumentIO()->getAgentKeys(ArgumentImportance::Required)) {
+        keyring.add(std::move(privateKey));
+    }
+
+    ULOG1(INFO) << tfm::format("Listen on the socket '%s'.", socketPath);
+    const auto socketDir = socketPath.substr(0, socketPath.find_last_of(Path::pathSeparator()));
+    if (!socketDir.empty() && socketDir != socketPath) {
+        Path::createDir(socketDir);
+    }
+    auto listener = UnixSocket::listen(socketPath);
+    installSignalHandlers();
+    ULOG(INFO) << tfm::format("Key agent holds %d Private Key(s) and is listening on '%s'.", keyring.size(), socketPath);
+
+    ThreadPool threadPool(jobs);
+    while (!gIsStopRequested) {
+        auto connection = listener.accept(kAcceptTimeoutMs);
+        if (!connection.isValid()) {
+            continue;
+        }
+        if (!connection.isPeerOwner()) {
+            LOG(WARNING) << "Connection from the process of another user is rejected.";
+            continue;
+        }
+        auto channel = std::make_shared<AgentChannel>(std::move(connection));
+        threadPool.submit([&keyring, channel]() {
+            try {
+                serve(keyring, *channel);
+            } catch (const std::exception& exception) {
+                LOG(WARNING) << tfm::format("Key agent connection failed: %s", exception.what());
+            }
+        });
+    }
+    ULOG1(INFO) << "Stop key agent.";
+}
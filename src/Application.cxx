@@ -0,0 +1,221 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/api/Application.h>
+
+#include <cli/memory.h>
+#include <cli/api/api.h>
+#include <cli/api/Configurations.h>
+
+#include <cli/cmd/StandardCommandPrompt.h>
+#include <cli/argument/ArgumentRules.h>
+#include <cli/argument/ArgumentIO.h>
+#include <cli/argument/ArgumentSource.h>
+#include <cli/argument/ArgumentCommandLineSource.h>
+#include <cli/argument/ArgumentUserInputSource.h>
+#include <cli/argument/ArgumentDefaultsSource.h>
+#include <cli/argument/ArgumentConfigSource.h>
+#include <cli/argument/ArgumentValueSource.h>
+#include <cli/argument/ArgumentValueFileSource.h>
+#include <cli/argument/ArgumentValueAgentSource.h>
+#include <cli/argument/ArgumentValueCacheSource.h>
+#include <cli/argument/ArgumentValueVirgilSource.h>
+#include <cli/argument/ArgumentValueTextSource.h>
+#include <cli/argument/ArgumentValueEnumSource.h>
+#include <cli/command/HubCommand.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/error/ExitError.h>
+#include <cli/io/Logger.h>
+#include <cli/io/ServeClient.h>
+#include <cli/model/CardCache.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+using cli::Application;
+using cli::argument::ArgumentRules;
+using cli::argument::ArgumentIO;
+using cli::argument::ArgumentSource;
+using cli::argument::ArgumentValueSource;
+using cli::argument::ArgumentCommandLineSource;
+using cli::argument::ArgumentConfigSource;
+using cli::argument::ArgumentDefaultsSource;
+using cli::argument::ArgumentUserInputSource;
+using cli::argument::ArgumentValueSource;
+using cli::argument::ArgumentValueFileSource;
+using cli::argument::ArgumentValueAgentSource;
+using cli::argument::ArgumentValueCacheSource;
+using cli::argument::ArgumentValueVirgilSource;
+using cli::argument::ArgumentValueEnumSource;
+using cli::argument::ArgumentValueTextSource;
+using cli::argument::ArgumentSourceType;
+using cli::cmd::StandardCommandPrompt;
+using cli::command::Command;
+using cli::command::HubCommand;
+using cli::error::ExitFailure;
+using cli::error::ExitSuccess;
+using cli::io::ServeClient;
+using cli::model::CardCache;
+
+static constexpr const char kEnvironment_ServeSocket[] = "VIRGIL_SERVE_SOCKET";
+
+static std::unique_ptr<ArgumentSource> createArgumentSource(int argc, const char* argv[], bool isInteractive) {
+    auto commandArgumentSource = std::make_unique<ArgumentCommandLineSource>(argv + 1, argv + argc);
+    auto defaultsSource = commandArgumentSource->
+            appendSource(std::make_unique<ArgumentConfigSource>(cli::Configurations::getDefaultConfigFilePath()))->
+            appendSource(std::make_unique<ArgumentDefaultsSource>());
+    if (isInteractive) {
+        defaultsSource->appendSource(
+                std::make_unique<ArgumentUserInputSource>(std::make_unique<StandardCommandPrompt>()));
+    }
+
+    commandArgumentSource->setupRules(std::make_unique<ArgumentRules>());
+    return std::move(commandArgumentSource);
+}
+
+static std::unique_ptr<ArgumentValueSource> createArgumentValueSource() {
+    // Cache is shared by all commands of the process, i.e. within virgil-batch and virgil-serve.
+    auto cardCache = CardCache::shared();
+    auto argumentValueSource = std::make_unique<ArgumentValueFileSource>();
+    argumentValueSource->appendSource(
+            std::make_unique<ArgumentValueAgentSource>()
+    )->appendSource(
+            std::make_unique<ArgumentValueCacheSource>(cardCache)
+    )->appendSource(
+            std::make_unique<ArgumentValueVirgilSource>(cardCache)
+    )->appendSource(
+            std::make_unique<ArgumentValueEnumSource>()
+    )->appendSource(
+            std::make_unique<ArgumentValueTextSource>()
+    );
+    argumentValueSource->resetFilter({ ArgumentSourceType::Any });
+    return std::move(argumentValueSource);
+}
+
+static std::unique_ptr<ArgumentIO> createArgumentIO(int argc, const char* argv[], bool isInteractive) {
+    return std::make_unique<ArgumentIO>(createArgumentSource(argc, argv, isInteractive), createArgumentValueSource());
+}
+
+static std::unique_ptr<Command> createRootCommand(int argc, const char* argv[], bool isInteractive) {
+    return std::make_unique<HubCommand>(createArgumentIO(argc, argv, isInteractive));
+}
+
+static int processRootCommand(int argc, const char* argv[], bool isInteractive) {
+    try {
+        createRootCommand(argc, argv, isInteractive)->process();
+    } catch (const ExitFailure&) {
+        // Was handled in-place, was rethrown for exit
+        return EXIT_FAILURE;
+    } catch (const ExitSuccess&) {
+        // Was handled in-place, was rethrown for exit
+        return EXIT_SUCCESS;
+    } catch (const std::exception& exception) {
+        LOG(FATAL) << exception.what();
+        ULOG(FATAL) << "Unexpected error occurred. Contact support for help.";
+        return EXIT_FAILURE;
+    } catch (...) {
+        ULOG(FATAL) << "Undefined error occurred. Contact support for help.";
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+/**
+ * @brief Pass command to the command server if it is configured.
+ * @return true - if command was run by the server, false - if server is not available.
+ */
+static bool tryRunByServer(int argc, const char* argv[], int& exitCode) {
+    const char* socketPath = std::getenv(kEnvironment_ServeSocket);
+    if (socketPath == nullptr || *socketPath == '\0') {
+        return false;
+    }
+    const std::vector<std::string> arguments(argv, argv + argc);
+    const auto serveCommand =
+            std::find(arguments.cbegin() + 1, arguments.cend(), cli::arg::value::VIRGIL_COMMAND_SERVE);
+    if (serveCommand != arguments.cend()) {
+        // Server itself is never run by the server
+        return false;
+    }
+    std::unique_ptr<ServeClient> client;
+    try {
+        client = std::make_unique<ServeClient>(socketPath);
+    } catch (const std::exception&) {
+        // Server is not running, so run command within this process
+        return false;
+    }
+    try {
+        exitCode = client->run(arguments);
+    } catch (const std::exception& exception) {
+        std::cerr << exception.what() << std::endl;
+        exitCode = EXIT_FAILURE;
+    }
+    return true;
+}
+
+int Application::run(int argc, const char* argv[]) {
+    int exitCode = EXIT_SUCCESS;
+    if (tryRunByServer(argc, argv, exitCode)) {
+        return exitCode;
+    }
+    try {
+        Configurations::init();
+        Configurations::apply(argc, argv);
+    } catch (const std::exception& exception) {
+        LOG(FATAL) << exception.what();
+        ULOG(FATAL) << "Unexpected error occurred. Contact support for help.";
+        return EXIT_FAILURE;
+    }
+    LOG(INFO) << "Start application.";
+    return runCommand(argc, argv);
+}
+
+int Application::runCommand(int argc, const char* argv[]) {
+    LOG(INFO) << "Verbose level:" << el::Loggers::verboseLevel();
+    return processRootCommand(argc, argv, true);
+}
+
+int Application::runNonInteractiveCommand(const std::vector<std::string>& arguments) {
+    std::vector<const char*> argv;
+    argv.push_back("virgil");
+    for (const auto& argument : arguments) {
+        argv.push_back(argument.c_str());
+    }
+    argv.push_back(nullptr);
+    return processRootCommand(static_cast<int>(argv.size() - 1), argv.data(), false);
+}
@@ -44,6 +44,9 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <map>
+#include <mutex>
+
 using cli::argument::Argument;
 using cli::argument::ArgumentConfigSource;
 using cli::argument::ArgumentParseOptions;
@@ -55,6 +58,25 @@ ArgumentConfigSource::ArgumentConfigSource(ArgumentConfigSource&&) = default;
 ArgumentConfigSource& ArgumentConfigSource::operator=(ArgumentConfigSource&&) = default;
 ArgumentConfigSource::~ArgumentConfigSource() noexcept = default;
 
+namespace {
+
+/**
+ * @brief Return configuration read from the given file, each file is parsed once per process.
+ * @note Long-running processes (i.e. command server) do not see changes of the file, so they must be restarted.
+ */
+YAML::Node loadConfig(const std::string& filePath) {
+    static std::mutex mutex;
+    static std::map<std::string, YAML::Node> configs;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = configs.find(filePath);
+    if (found == configs.end()) {
+        found = configs.emplace(filePath, YAML::LoadFile(filePath)).first;
+    }
+    return YAML::Clone(found->second);
+}
+
+}
+
 namespace cli { namespace argument {
 
 struct ArgumentConfigSource::Impl {
@@ -77,7 +99,7 @@ const char* ArgumentConfigSource::doGetName() const {
 }
 
 void ArgumentConfigSource::doInit(const std::string& usage, const ArgumentParseOptions& usageOptions) {
-    impl_->config = YAML::LoadFile(impl_->configFilePath);
+    impl_->config = loadConfig(impl_->configFilePath);
 }
 
 void ArgumentConfigSource::doUpdateRules() {
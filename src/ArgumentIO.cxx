@@ -49,6 +49,9 @@
 #include <cli/model/PasswordDecryptCredentials.h>
 #include <cli/model/KeyEncryptCredentials.h>
 #include <cli/model/KeyDecryptCredentials.h>
+#include <cli/model/AgentDecryptCredentials.h>
+#include <cli/model/KeySignerCredentials.h>
+#include <cli/model/AgentSignerCredentials.h>
 
 #include <cli/command/KeygenCommand.h>
 #include <cli/command/KeyToPubCommand.h>
@@ -57,6 +60,8 @@
 
 #include <cli/argument/validation/ArgumentValidationHub.h>
 
+#include <cli/concurrency/ThreadPool.h>
+
 #include <cli/memory.h>
 
 #include <istream>
@@ -64,20 +69,30 @@
 #include <fstream>
 #include <iostream>
 #include <algorithm>
+#include <future>
 #include <iterator>
+#include <limits>
+#include <set>
 
 using namespace cli;
 using namespace cli::argument;
 using namespace cli::argument::validation;
 using namespace cli::command;
 using namespace cli::model;
+using cli::concurrency::FileJob;
+using cli::concurrency::ThreadPool;
 
 #undef IN
 #undef OUT
 
+static constexpr const size_t kHeadChunkSize = 4 * 1024;
+static constexpr const size_t kCardLookups_Max = 8;
+
 ArgumentIO::ArgumentIO(std::unique_ptr<ArgumentSource> argumentSource,
         std::unique_ptr<ArgumentValueSource> argumentValueSource)
-        : argumentSource_(std::move(argumentSource)), argumentValueSource_(std::move(argumentValueSource))
+        : argumentSource_(std::move(argumentSource)), argumentValueSource_(std::move(argumentValueSource)),
+          ioBufferSize_(FileDataSource::kChunkSize_Default),
+          bufferPool_(std::make_shared<io::BufferPool>(ioBufferSize_)), useUring_(false)
 {
     DCHECK(argumentSource_);
     DCHECK(argumentValueSource_);
@@ -86,6 +101,12 @@ ArgumentIO::ArgumentIO(std::unique_ptr<ArgumentSource> argumentSource,
 void ArgumentIO::configureUsage(const char* usage, const ArgumentParseOptions& parseOptions) {
     argumentSource_->init(usage, parseOptions);
     argumentValueSource_->init(*argumentSource_);
+    auto ioBufferSize = readIOBufferSize();
+    if (ioBufferSize != ioBufferSize_) {
+        ioBufferSize_ = ioBufferSize;
+        bufferPool_ = std::make_shared<io::BufferPool>(ioBufferSize_);
+    }
+    useUring_ = readIOUring();
 }
 
 bool ArgumentIO::hasContentInfo() const {
@@ -93,6 +114,16 @@ bool ArgumentIO::hasContentInfo() const {
     return !argument.isEmpty();
 }
 
+bool ArgumentIO::hasSignature() const {
+    auto argument = argumentSource_->read(opt::SIGN, ArgumentImportance::Optional);
+    return !argument.isEmpty();
+}
+
+bool ArgumentIO::hasSession() const {
+    auto argument = argumentSource_->read(opt::SESSION, ArgumentImportance::Optional);
+    return !argument.isEmpty();
+}
+
 bool ArgumentIO::hasNoPassword() const {
     ULOG2(INFO) << "Check if password should be omitted.";
     auto argument = argumentSource_->read(opt::NO_PASSWORD, ArgumentImportance::Optional);
@@ -135,6 +166,47 @@ bool ArgumentIO::isAll() const {
     return argument.asValue().asOptionalBool();
 }
 
+bool ArgumentIO::isChunked() const {
+    ULOG2(INFO) << "Check if chunked format is requested.";
+    auto argument = argumentSource_->read(opt::CHUNKED, ArgumentImportance::Optional);
+    ArgumentValidationHub::isNumber()->validate(argument, ArgumentImportance::Optional);
+    return argument.asValue().asOptionalBool();
+}
+
+bool ArgumentIO::hasDataRange() const {
+    auto offset = argumentSource_->read(opt::OFFSET, ArgumentImportance::Optional);
+    auto length = argumentSource_->read(opt::LENGTH, ArgumentImportance::Optional);
+    return !offset.isEmpty() || !length.isEmpty();
+}
+
+bool ArgumentIO::isPipelined(const FileDataSource& source) const {
+    ULOG2(INFO) << "Read pipeline mode.";
+    auto argument = argumentSource_->read(arg::value::VIRGIL_CONFIG_IO_PIPELINE, ArgumentImportance::Optional);
+    ArgumentValidationHub::isEnum(
+            arg::value::VIRGIL_CONFIG_IO_PIPELINE_VALUES)->validate(argument, ArgumentImportance::Optional);
+    const auto mode = argument.isEmpty() ? std::string(arg::value::VIRGIL_CONFIG_IO_PIPELINE_AUTO)
+                                         : argument.asValue().asString();
+    if (mode == arg::value::VIRGIL_CONFIG_IO_PIPELINE_ON) {
+        return true;
+    } else if (mode == arg::value::VIRGIL_CONFIG_IO_PIPELINE_OFF) {
+        return false;
+    }
+    const auto size = source.size();
+    return size == FileDataSource::kSize_Unknown ||
+           size >= ioBufferSize_ * arg::value::VIRGIL_CONFIG_IO_PIPELINE_AUTO_MIN_CHUNKS;
+}
+
+bool ArgumentIO::isMultiFile() const {
+    auto inputArgument = argumentSource_->read(opt::IN, ArgumentImportance::Optional);
+    if (inputArgument.asList().size() > 1) {
+        return true;
+    }
+    if (inputArgument.isValue() && io::Path::existsDir(inputArgument.asValue().value())) {
+        return true;
+    }
+    return !argumentSource_->read(opt::OUT_DIR, ArgumentImportance::Optional).isEmpty();
+}
+
 SecureValue ArgumentIO::getInput(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read input value.";
     auto argument = argumentSource_->read(opt::IN, argumentImportance);
@@ -156,6 +228,16 @@ FileDataSource ArgumentIO::getInputSource(ArgumentImportance argumentImportance)
     return getSource(argument.asValue());
 }
 
+FileDataSource ArgumentIO::getInputHeadSource(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read input source head.";
+    auto argument = argumentSource_->read(opt::IN, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    if (argument.asValue().isEmpty()) {
+        return FileDataSource(kHeadChunkSize);
+    }
+    return FileDataSource(argument.asValue().value(), kHeadChunkSize);
+}
+
 FileDataSink ArgumentIO::getOutputSink(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read output destination.";
     auto argument = argumentSource_->read(opt::OUT, argumentImportance);
@@ -163,6 +245,69 @@ FileDataSink ArgumentIO::getOutputSink(ArgumentImportance argumentImportance) co
     return getSink(argument.asValue());
 }
 
+std::vector<FileJob> ArgumentIO::getFileJobs(
+        bool isSuffixRemoved, ArgumentImportance argumentImportance, const std::string& defaultSuffix) const {
+    if (!argumentSource_->read(opt::OUT, ArgumentImportance::Optional).isEmpty()) {
+        throw error::ArgumentNotAllowedError(opt::OUT);
+    }
+    ULOG2(INFO) << "Read output file suffix.";
+    auto suffixArgument = argumentSource_->read(opt::SUFFIX, ArgumentImportance::Optional);
+    ArgumentValidationHub::isText()->validate(suffixArgument, ArgumentImportance::Optional);
+    const auto suffix = suffixArgument.isEmpty() ? defaultSuffix : suffixArgument.asValue().value();
+
+    ULOG2(INFO) << "Read input files.";
+    auto inputArgument = argumentSource_->read(opt::IN, argumentImportance);
+    ArgumentValidationHub::isText()->validateList(inputArgument, argumentImportance);
+    std::vector<std::string> inputFiles;
+    for (const auto& inputValue : inputArgument.asList()) {
+        if (!io::Path::existsDir(inputValue.value())) {
+            inputFiles.push_back(inputValue.value());
+            continue;
+        }
+        // Files of the directory are filtered by suffix, so results of the previous run are not processed again.
+        size_t dirFileCount = 0;
+        for (auto& dirFile : io::Path::listFiles(inputValue.value())) {
+            const bool hasSuffix = el::base::utils::Str::endsWith(dirFile, suffix);
+            if (suffix.empty() || hasSuffix == isSuffixRemoved) {
+                inputFiles.push_back(std::move(dirFile));
+                ++dirFileCount;
+            }
+        }
+        ULOG3(INFO) << tfm::format("Read %d file(s) from the directory '%s'.", dirFileCount, inputValue.value());
+    }
+
+    ULOG2(INFO) << "Read output directory.";
+    auto outputDirArgument = argumentSource_->read(opt::OUT_DIR, ArgumentImportance::Optional);
+    ArgumentValidationHub::isText()->validate(outputDirArgument, ArgumentImportance::Optional);
+    const auto outputDir = outputDirArgument.asValue().value();
+    if (!outputDir.empty() && !io::Path::createDir(outputDir)) {
+        throw error::ArgumentRuntimeError(tfm::format("Can not create output directory '%s'.", outputDir));
+    }
+
+    std::vector<FileJob> result;
+    result.reserve(inputFiles.size());
+    std::set<std::string> outputFiles;
+    for (auto& inputFile : inputFiles) {
+        auto outputFile = outputDir.empty() ? inputFile : io::Path::joinPath(outputDir, io::Path::fileName(inputFile));
+        outputFile = isSuffixRemoved ? io::Path::removeSubPath(outputFile, suffix) : outputFile + suffix;
+        // Jobs are run concurrently, so two jobs must not write the same file.
+        if (!outputFiles.insert(outputFile).second) {
+            throw error::ArgumentRuntimeError(tfm::format(
+                    "Several input files have the same output file '%s', i.e. files with the same name are "
+                    "given from different directories with --out-dir.", outputFile));
+        }
+        result.push_back(FileJob{ std::move(inputFile), std::move(outputFile) });
+    }
+    return result;
+}
+
+FileDataSource ArgumentIO::getFileSource(const std::string& filePath) const {
+    return getSource(ArgumentValue(filePath));
+}
+
+FileDataSink ArgumentIO::getFileSink(const std::string& filePath) const {
+    return getSink(ArgumentValue(filePath));
+}
 
 FileDataSource ArgumentIO::getContentInfoSource(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read content info source.";
@@ -178,18 +323,73 @@ FileDataSink ArgumentIO::getContentInfoSink(ArgumentImportance argumentImportanc
     return getSink(argument.asValue());
 }
 
+Crypto::Text ArgumentIO::getSessionPath(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read session header file.";
+    auto argument = argumentSource_->read(opt::SESSION, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().asString();
+}
+
 std::vector<std::unique_ptr<EncryptCredentials>>
 ArgumentIO::getEncryptCredentials(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read recipients for encryption.";
-    auto argument = argumentSource_->read(arg::RECIPIENT_ID, argumentImportance);
+    auto recipientsArgument = argumentSource_->read(opt::RECIPIENTS, ArgumentImportance::Optional);
+    ArgumentValidationHub::isText()->validate(recipientsArgument, ArgumentImportance::Optional);
+    const bool hasRecipientsFile = !recipientsArgument.isEmpty();
+    auto argument = argumentSource_->read(
+            arg::RECIPIENT_ID, hasRecipientsFile ? ArgumentImportance::Optional : argumentImportance);
+    if (hasRecipientsFile) {
+        auto recipientIds = argument.asStringList();
+        auto recipientsSource = getSource(recipientsArgument.asValue());
+        for (auto&& line : recipientsSource.readMultiLine()) {
+            const auto begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == '#') {
+                continue;
+            }
+            const auto end = line.find_last_not_of(" \t\r");
+            recipientIds.push_back(line.substr(begin, end - begin + 1));
+        }
+        ULOG2(INFO) << tfm::format("Read %d recipient(s) from the file: '%s'.",
+                recipientIds.size(), recipientsArgument.asValue().value());
+        argument = Argument(std::move(recipientIds));
+    }
     argument.parse();
     auto validation = ArgumentValidationHub::isKeyValue();
     validation->setKeyValidation(ArgumentValidationHub::isEnum(arg::value::VIRGIL_ENCRYPT_RECIPIENT_ID_VALUES));
     validation->setValueValidation(ArgumentValidationHub::isNotEmpty());
     validation->validateList(argument, argumentImportance);
+    // Recipients that are resolved by the Cards service are looked up concurrently,
+    // others are read in order, because they may prompt the user.
+    const auto argumentValues = argument.asList();
+    const auto isRemote = [](const ArgumentValue& argumentValue) {
+        return argumentValue.key() == arg::value::VIRGIL_ENCRYPT_RECIPIENT_ID_EMAIL ||
+                argumentValue.key() == arg::value::VIRGIL_ENCRYPT_RECIPIENT_ID_VCARD;
+    };
+    const auto remoteCount = static_cast<size_t>(
+            std::count_if(argumentValues.cbegin(), argumentValues.cend(), isRemote));
+    std::unique_ptr<ThreadPool> lookupPool;
+    if (remoteCount > 1) {
+        lookupPool = std::make_unique<ThreadPool>(std::min(remoteCount, kCardLookups_Max));
+        ULOG2(INFO) << tfm::format("Look up %d recipient(s) in the Cards service with %d thread(s).",
+                remoteCount, lookupPool->size());
+    }
+    std::vector<std::future<std::vector<std::unique_ptr<EncryptCredentials>>>> remoteCredentials;
+    std::vector<std::vector<std::unique_ptr<EncryptCredentials>>> credentialsList(argumentValues.size());
+    for (size_t i = 0; i < argumentValues.size(); ++i) {
+        if (lookupPool && isRemote(argumentValues[i])) {
+            const auto& argumentValue = argumentValues[i];
+            remoteCredentials.push_back(lookupPool->submit([this, &argumentValue]() {
+                return readEncryptCredentials(argumentValue);
+            }));
+        } else {
+            credentialsList[i] = readEncryptCredentials(argumentValues[i]);
+        }
+    }
     std::vector<std::unique_ptr<EncryptCredentials>> result;
-    for (const auto& argumentValue : argument.asList()) {
-        auto credentials = readEncryptCredentials(argumentValue);
+    auto remoteCredentialsIt = remoteCredentials.begin();
+    for (size_t i = 0; i < argumentValues.size(); ++i) {
+        auto credentials = (lookupPool && isRemote(argumentValues[i])) ?
+                (remoteCredentialsIt++)->get() : std::move(credentialsList[i]);
         result.insert(result.end(),
                 std::make_move_iterator(credentials.begin()), std::make_move_iterator(credentials.end()));
     }
@@ -202,7 +402,18 @@ ArgumentIO::getEncryptCredentials(ArgumentImportance argumentImportance) const {
 std::vector<std::unique_ptr<DecryptCredentials>>
 ArgumentIO::getDecryptCredentials(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read decryption credentials.";
-    auto argument = argumentSource_->read(arg::KEYPASS, argumentImportance);
+    return readDecryptCredentials(arg::KEYPASS, argumentImportance);
+}
+
+std::vector<std::unique_ptr<DecryptCredentials>>
+ArgumentIO::getKeypassCredentials(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read decryption credentials from the option.";
+    return readDecryptCredentials(opt::KEYPASS, argumentImportance);
+}
+
+std::vector<std::unique_ptr<DecryptCredentials>>
+ArgumentIO::readDecryptCredentials(const char* argumentKey, ArgumentImportance argumentImportance) const {
+    auto argument = argumentSource_->read(argumentKey, argumentImportance);
     argument.parse();
     auto validation = ArgumentValidationHub::isKeyValue();
     validation->setKeyValidation(ArgumentValidationHub::isEnum(arg::value::VIRGIL_DECRYPT_KEYPASS_VALUES));
@@ -243,6 +454,79 @@ PrivateKey ArgumentIO::getPrivateKeyFromInput(ArgumentImportance argumentImporta
     return std::move(privateKey);
 }
 
+PrivateKey ArgumentIO::getPrivateKeyFromFile(const std::string& filePath) const {
+    ULOG2(INFO) << tfm::format("Read private key from the file '%s'.", filePath);
+    auto source = getFileSource(filePath);
+    PrivateKey privateKey(source.readAll(), Crypto::Bytes());
+    readPrivateKeyPassword(privateKey, ArgumentValue(filePath), opt::PRIVATE_KEY_PASSWORD);
+    return std::move(privateKey);
+}
+
+std::unique_ptr<SignerCredentials> ArgumentIO::getSignerCredentials(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read signer credentials.";
+    auto argument = argumentSource_->read(opt::PRIVATE_KEY, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    auto agentKeyValue = argument.asValue();
+    agentKeyValue.parse();
+    if (agentKeyValue.isKeyValue() && agentKeyValue.key() == arg::value::VIRGIL_SIGN_PRIVATE_KEY_AGENT &&
+            !io::Path::existsFile(argument.asValue().value())) {
+        return std::make_unique<AgentSignerCredentials>(argumentValueSource_->readAgentKey(agentKeyValue));
+    }
+    auto privateKey = argumentValueSource_->readPrivateKey(argument.asValue());
+    readPrivateKeyPassword(privateKey, argument.asValue(), opt::PRIVATE_KEY_PASSWORD);
+    return std::make_unique<KeySignerCredentials>(std::move(privateKey));
+}
+
+std::vector<PrivateKey> ArgumentIO::getAgentKeys(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read private keys for the key agent.";
+    auto argument = argumentSource_->read(arg::KEYPASS, argumentImportance);
+    argument.parse();
+    auto validation = ArgumentValidationHub::isKeyValueAlias();
+    validation->setKeyValidation(ArgumentValidationHub::isEnum(arg::value::VIRGIL_AGENT_KEYPASS_VALUES));
+    validation->setValueValidation(ArgumentValidationHub::isNotEmpty());
+    validation->validateList(argument, argumentImportance);
+    std::vector<PrivateKey> result;
+    for (const auto& argumentValue : argument.asList()) {
+        auto privateKey = argumentValueSource_->readPrivateKey(argumentValue);
+        // Agent holds unlocked keys in the locked memory only, so they are not copied to the process cache.
+        readPrivateKeyPassword(privateKey, argumentValue, opt::PRIVATE_KEY_PASSWORD, PrivateKey::CacheMode::None);
+        result.push_back(std::move(privateKey));
+    }
+    return result;
+}
+
+Crypto::Text ArgumentIO::getAgentSocket(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read key agent socket path.";
+    auto argument = argumentSource_->read(arg::value::VIRGIL_CONFIG_AGENT_SOCKET, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().value();
+}
+
+std::vector<PrivateKey> ArgumentIO::getServeKeys(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read private keys for the command server.";
+    auto argument = argumentSource_->read(arg::KEYPASS, argumentImportance);
+    argument.parse();
+    auto validation = ArgumentValidationHub::isKeyValue();
+    validation->setKeyValidation(ArgumentValidationHub::isEnum(arg::value::VIRGIL_SERVE_KEYPASS_VALUES));
+    validation->setValueValidation(ArgumentValidationHub::isNotEmpty());
+    validation->validateList(argument, argumentImportance);
+    std::vector<PrivateKey> result;
+    for (const auto& argumentValue : argument.asList()) {
+        auto privateKey = argumentValueSource_->readPrivateKey(argumentValue);
+        // Keys are unlocked once and kept until exit, so commands of the server inherit them.
+        readPrivateKeyPassword(privateKey, argumentValue, opt::PRIVATE_KEY_PASSWORD, PrivateKey::CacheMode::Pinned);
+        result.push_back(std::move(privateKey));
+    }
+    return result;
+}
+
+Crypto::Text ArgumentIO::getServeSocket(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read command server socket path.";
+    auto argument = argumentSource_->read(arg::value::VIRGIL_CONFIG_SERVE_SOCKET, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().value();
+}
+
 Password ArgumentIO::getKeyPassword(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read private key password.";
     auto argument = argumentSource_->readSecure(opt::PRIVATE_KEY_PASSWORD, argumentImportance);
@@ -404,6 +688,67 @@ std::vector<Card> ArgumentIO::getCardListFromInput(ArgumentImportance argumentIm
     return result;
 }
 
+std::vector<std::string> ArgumentIO::getCardIds(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read Virgil Card ID(s).";
+    auto argument = argumentSource_->read(arg::CARD_ID, ArgumentImportance::Optional);
+    ArgumentValidationHub::isText()->validateList(argument, ArgumentImportance::Optional);
+    if (argument.isList()) {
+        return argument.asStringList();
+    }
+
+    auto inputArgument = argumentSource_->read(opt::IN, ArgumentImportance::Optional);
+    ArgumentValidationHub::isText()->validate(inputArgument, ArgumentImportance::Optional);
+    const auto inputValue = inputArgument.asValue();
+    if (!inputValue.isEmpty() && !io::Path::existsFile(inputValue.value())) {
+        return { inputValue.value() };
+    }
+    std::vector<std::string> result;
+    for (auto&& line : getSource(inputValue).readMultiLine()) {
+        const auto begin = line.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            continue;
+        }
+        const auto end = line.find_last_not_of(" \t\r");
+        result.push_back(line.substr(begin, end - begin + 1));
+    }
+    if (result.empty() && argumentImportance == ArgumentImportance::Required) {
+        throw error::ArgumentNotFoundError(arg::CARD_ID);
+    }
+    return result;
+}
+
+std::string ArgumentIO::getOutputDir(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read output directory.";
+    auto argument = argumentSource_->read(opt::OUT_DIR, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().value();
+}
+
+std::string ArgumentIO::getCardMirrorDir(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read Virgil Card mirror directory.";
+    auto argument = argumentSource_->read(opt::DIRECTORY, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().value();
+}
+
+std::string ArgumentIO::getOfflineCardMirrorDir(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read offline Virgil Card mirror directory.";
+    auto argument = argumentSource_->read(opt::OFFLINE, argumentImportance);
+    ArgumentValidationHub::isText()->validate(argument, argumentImportance);
+    return argument.asValue().value();
+}
+
+size_t ArgumentIO::getMaxAge(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read maximum age.";
+    auto argument = argumentSource_->read(opt::MAX_AGE, argumentImportance);
+    if (argument.isEmpty()) {
+        return 0;
+    }
+    argument.parse();
+    ArgumentValidationHub::isNumber()->validate(argument, argumentImportance);
+    return argument.asValue().asNumber();
+}
+
 CardRevocationReason ArgumentIO::getCardRevokeReason(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read Virgil Card revocation reason.";
     auto argument = argumentSource_->read(opt::REVOCATION_REASON, argumentImportance);
@@ -435,6 +780,44 @@ size_t ArgumentIO::getIterationCount(ArgumentImportance argumentImportance) cons
     return argument.asValue().asNumber();
 }
 
+size_t ArgumentIO::getJobs(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read number of jobs.";
+    auto argument = argumentSource_->read(opt::JOBS, argumentImportance);
+    if (argument.isEmpty()) {
+        return arg::value::VIRGIL_JOBS_AUTO;
+    }
+    argument.parse();
+    ArgumentValidationHub::isRange(
+            arg::value::VIRGIL_JOBS_MIN, arg::value::VIRGIL_JOBS_MAX)->validate(argument, argumentImportance);
+    return argument.asValue().asNumber();
+}
+
+size_t ArgumentIO::getDataOffset(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read data offset.";
+    auto argument = argumentSource_->read(opt::OFFSET, argumentImportance);
+    if (argument.isEmpty()) {
+        return 0;
+    }
+    argument.parse();
+    ArgumentValidationHub::isNumber()->validate(argument, argumentImportance);
+    return argument.asValue().asNumber();
+}
+
+size_t ArgumentIO::getDataLength(ArgumentImportance argumentImportance) const {
+    ULOG2(INFO) << "Read data length.";
+    auto argument = argumentSource_->read(opt::LENGTH, argumentImportance);
+    if (argument.isEmpty()) {
+        return std::numeric_limits<size_t>::max();
+    }
+    argument.parse();
+    ArgumentValidationHub::isNumber()->validate(argument, argumentImportance);
+    return argument.asValue().asNumber();
+}
+
+size_t ArgumentIO::getIOBufferSize() const {
+    return ioBufferSize_;
+}
+
 Crypto::Text ArgumentIO::getKeyFormat(ArgumentImportance argumentImportance) const {
     ULOG2(INFO) << "Read key format.";
     auto argument = argumentSource_->read(arg::KEY_FORMAT, argumentImportance);
@@ -446,25 +829,26 @@ Crypto::Text ArgumentIO::getKeyFormat(ArgumentImportance argumentImportance) con
 FileDataSource ArgumentIO::getSource(const ArgumentValue& argumentValue) const {
     if (argumentValue.isEmpty()) {
         ULOG3(INFO) << tfm::format("Read source is standard input.");
-        return FileDataSource();
+        return FileDataSource(ioBufferSize_);
     } else {
         ULOG3(INFO) << tfm::format("Read source is file: '%s'.", argumentValue.value());
-        return FileDataSource(argumentValue.value());
+        return FileDataSource(argumentValue.value(), ioBufferSize_, bufferPool_, useUring_);
     }
 }
 
 FileDataSink ArgumentIO::getSink(const ArgumentValue& argumentValue) const {
     if (argumentValue.isEmpty()) {
         ULOG3(INFO) << tfm::format("Write destination is standard output.");
-        return FileDataSink();
+        return FileDataSink(ioBufferSize_);
     } else {
         ULOG3(INFO) << tfm::format("Write destination is file: '%s'.", argumentValue.value());
-        return FileDataSink(argumentValue.value());
+        return FileDataSink(argumentValue.value(), bufferPool_, useUring_);
     }
 }
 
 void ArgumentIO::readPrivateKeyPassword(
-        PrivateKey& privateKey, const ArgumentValue& argumentValue, const char* passwordArgumentKey) const {
+        PrivateKey& privateKey, const ArgumentValue& argumentValue, const char* passwordArgumentKey,
+        PrivateKey::CacheMode cacheMode) const {
     ULOG2(INFO) << "Read private key password.";
     if (!privateKey.isEncrypted()) {
         return;
@@ -474,8 +858,7 @@ void ArgumentIO::readPrivateKeyPassword(
         DLOG(INFO) << tfm::format("Read password for the private key: '%s'.", std::to_string(argumentValue));
         auto argument = argumentSource_->readSecure(passwordOption.c_str(), ArgumentImportance::Required);
         auto password = argumentValueSource_->readPassword(argument.asValue());
-        if (privateKey.checkPassword(password)) {
-            privateKey.setPassword(std::move(password));
+        if (privateKey.unlock(password, cacheMode)) {
             return;
         }
         passwordOption = argumentValue.value();
@@ -530,6 +913,10 @@ ArgumentIO::readDecryptCredentials(const ArgumentValue& argumentValue) const {
         auto privateKey = argumentValueSource_->readPrivateKey(argumentValue);
         readPrivateKeyPassword(privateKey, argumentValue, opt::PRIVATE_KEY_PASSWORD);
         result.push_back(std::make_unique<KeyDecryptCredentials>(std::move(privateKey)));
+    } else if (recipientType == arg::value::VIRGIL_DECRYPT_KEYPASS_AGENT) {
+        result.push_back(std::make_unique<AgentDecryptCredentials>(
+                argumentValueSource_->readAgentKey(argumentValue)
+        ));
     } else {
         throw error::ArgumentLogicError(
                 tfm::format("Undefined key of the <%s>. Validation must fail first.", arg::KEYPASS));
@@ -548,3 +935,35 @@ PublicKey ArgumentIO::readSenderKey(const ArgumentValue& argumentValue) const {
     throw error::ArgumentLogicError(
             tfm::format("Undefined key of the <%s>. Validation must fail first.", arg::RECIPIENT_ID));
 }
+
+size_t ArgumentIO::readIOBufferSize() const {
+    ULOG2(INFO) << "Read IO buffer size.";
+    auto argument = argumentSource_->read(arg::value::VIRGIL_CONFIG_IO_BUFFER_SIZE, ArgumentImportance::Optional);
+    if (argument.isEmpty()) {
+        return FileDataSource::kChunkSize_Default;
+    }
+    argument.parse();
+    ArgumentValidationHub::isRange(
+            arg::value::VIRGIL_CONFIG_IO_BUFFER_SIZE_MIN,
+            arg::value::VIRGIL_CONFIG_IO_BUFFER_SIZE_MAX)->validate(argument, ArgumentImportance::Optional);
+    return argument.asValue().asNumber();
+}
+
+bool ArgumentIO::readIOUring() const {
+    ULOG2(INFO) << "Read io_uring mode.";
+    auto argument = argumentSource_->read(arg::value::VIRGIL_CONFIG_IO_URING, ArgumentImportance::Optional);
+    ArgumentValidationHub::isEnum(
+            arg::value::VIRGIL_CONFIG_IO_URING_VALUES)->validate(argument, ArgumentImportance::Optional);
+    const auto mode = argument.isEmpty() ? std::string(arg::value::VIRGIL_CONFIG_IO_URING_AUTO)
+                                         : argument.asValue().asString();
+    if (mode == arg::value::VIRGIL_CONFIG_IO_URING_OFF) {
+        return false;
+    }
+#if !USE_IO_URING
+    if (mode == arg::value::VIRGIL_CONFIG_IO_URING_ON) {
+        LOG(WARNING) << "CLI is built without io_uring engine, files are read and written in the standard way.";
+    }
+#endif //USE_IO_URING
+    // If kernel does not support io_uring, then sources and sinks fall back to the standard reading and writing.
+    return true;
+}
@@ -0,0 +1,79 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/argument/ArgumentValueAgentSource.h>
+
+#include <cli/api/api.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/AgentClient.h>
+#include <cli/io/Logger.h>
+#include <cli/memory.h>
+
+using cli::argument::ArgumentValue;
+using cli::argument::ArgumentValueAgentSource;
+using cli::argument::ArgumentSourceType;
+using cli::error::ArgumentNotFoundError;
+using cli::io::AgentClient;
+using cli::model::AgentKey;
+using cli::model::PublicKey;
+
+const char* ArgumentValueAgentSource::doGetName() const {
+    return "ArgumentValueAgentSource";
+}
+
+ArgumentSourceType ArgumentValueAgentSource::doGetType() const {
+    return ArgumentSourceType::Agent;
+}
+
+void ArgumentValueAgentSource::doInit(const ArgumentSource& argumentSource) {
+    auto argument = argumentSource.read(arg::value::VIRGIL_CONFIG_AGENT_SOCKET, ArgumentImportance::Optional);
+    if (argument.isValue() && argument.asValue().isString()) {
+        socketPath_ = argument.asValue().value();
+    }
+}
+
+std::unique_ptr<AgentKey> ArgumentValueAgentSource::doReadAgentKey(const ArgumentValue& argumentValue) const {
+    if (argumentValue.value().empty()) {
+        return nullptr;
+    }
+    if (socketPath_.empty()) {
+        throw ArgumentNotFoundError(arg::value::VIRGIL_CONFIG_AGENT_SOCKET);
+    }
+    auto alias = argumentValue.value();
+    ULOG3(INFO) << tfm::format("Request public key '%s' from the key agent: '%s'.", alias, socketPath_);
+    auto publicKey = AgentClient(socketPath_).publicKey(alias);
+    return std::make_unique<AgentKey>(socketPath_, PublicKey(publicKey, alias));
+}
@@ -0,0 +1,112 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/argument/ArgumentValueCacheSource.h>
+
+#include <cli/api/api.h>
+#include <cli/argument/validation/ArgumentValidationHub.h>
+#include <cli/io/Logger.h>
+#include <cli/memory.h>
+
+#include <iterator>
+
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentSource;
+using cli::argument::ArgumentValue;
+using cli::argument::ArgumentValueCacheSource;
+using cli::argument::ArgumentSourceType;
+using cli::argument::validation::ArgumentValidationHub;
+using cli::model::Card;
+using cli::model::CardCache;
+using cli::model::CardScope;
+
+static std::time_t read_ttl(const ArgumentSource& argumentSource, const char* configKey, std::time_t defaultTtl) {
+    auto argument = argumentSource.read(configKey, ArgumentImportance::Optional);
+    if (argument.isEmpty()) {
+        return defaultTtl;
+    }
+    argument.parse();
+    ArgumentValidationHub::isNumber()->validate(argument, ArgumentImportance::Optional);
+    return static_cast<std::time_t>(argument.asValue().asNumber());
+}
+
+ArgumentValueCacheSource::ArgumentValueCacheSource(std::shared_ptr<CardCache> cardCache)
+        : cardCache_(std::move(cardCache)) {
+}
+
+const char* ArgumentValueCacheSource::doGetName() const {
+    return "ArgumentValueCacheSource";
+}
+
+ArgumentSourceType ArgumentValueCacheSource::doGetType() const {
+    return ArgumentSourceType::Cache;
+}
+
+void ArgumentValueCacheSource::doInit(const ArgumentSource& argumentSource) {
+    cardCache_->setTtl(read_ttl(argumentSource, arg::value::VIRGIL_CONFIG_CARD_CACHE_TTL, CardCache::kTtl_Default));
+    cardCache_->setNegativeTtl(read_ttl(
+            argumentSource, arg::value::VIRGIL_CONFIG_CARD_CACHE_NEGATIVE_TTL, CardCache::kNegativeTtl_Default));
+}
+
+std::unique_ptr<std::vector<Card>> ArgumentValueCacheSource::doReadCards(const ArgumentValue& argumentValue) const {
+    if (argumentValue.isEmpty()) {
+        return nullptr;
+    }
+    auto globalCards = cardCache_->findCards(argumentValue.value(), argumentValue.key(), CardScope::global);
+    if (!globalCards) {
+        return nullptr;
+    }
+    auto applicationCards = cardCache_->findCards(argumentValue.value(), argumentValue.key(), CardScope::application);
+    if (!applicationCards) {
+        return nullptr;
+    }
+    ULOG1(INFO) << tfm::format("Found %d cached Virgil Card(s) with identity '%s:%s'.",
+            globalCards->size() + applicationCards->size(), argumentValue.key(), argumentValue.value());
+    globalCards->insert(globalCards->end(),
+            std::make_move_iterator(applicationCards->begin()), std::make_move_iterator(applicationCards->end()));
+    return globalCards;
+}
+
+std::unique_ptr<Card> ArgumentValueCacheSource::doReadCard(const ArgumentValue& argumentValue) const {
+    if (argumentValue.isEmpty()) {
+        return nullptr;
+    }
+    auto card = cardCache_->findCard(argumentValue.value());
+    if (card) {
+        ULOG1(INFO) << tfm::format("Found cached Virgil Card with id: '%s'.", argumentValue.value());
+    }
+    return card;
+}
@@ -45,6 +45,7 @@ using cli::argument::ArgumentSourceType;
 using cli::error::ArgumentValueSourceError;
 using cli::model::PublicKey;
 using cli::model::PrivateKey;
+using cli::model::AgentKey;
 using cli::model::Password;
 using cli::model::KeyAlgorithm;
 using cli::model::Card;
@@ -60,6 +61,7 @@ static constexpr const char kLogFormatMessage_ReadValueTotalFail[] = "Read '%s'
 static constexpr const char kValueName_KeyAlgorithm[] = "Key Algorithm";
 static constexpr const char kValueName_PublicKey[] = "Public Key";
 static constexpr const char kValueName_PrivateKey[] = "Private Key";
+static constexpr const char kValueName_AgentKey[] = "Agent Key";
 static constexpr const char kValueName_Password[] = "Password";
 static constexpr const char kValueName_VirgilCards[] = "Virgil Card(s)";
 static constexpr const char kValueName_HashAlgorithm[] = "Hash Algorithm";
@@ -130,6 +132,10 @@ PrivateKey ArgumentValueSource::readPrivateKey(const ArgumentValue& argumentValu
     FOR_EACH_SOURCE(doReadPrivateKey, argumentValue, kValueName_PrivateKey);
 }
 
+AgentKey ArgumentValueSource::readAgentKey(const ArgumentValue& argumentValue) const {
+    FOR_EACH_SOURCE(doReadAgentKey, argumentValue, kValueName_AgentKey);
+}
+
 std::vector<Card> ArgumentValueSource::readCards(const ArgumentValue& argumentValue) const {
     FOR_EACH_SOURCE(doReadCards, argumentValue, kValueName_VirgilCards);
 }
@@ -165,6 +171,10 @@ std::unique_ptr<PrivateKey> ArgumentValueSource::doReadPrivateKey(const Argument
     CAN_NOT_HANDLE(argumentValue);
 }
 
+std::unique_ptr<AgentKey> ArgumentValueSource::doReadAgentKey(const ArgumentValue& argumentValue) const {
+    CAN_NOT_HANDLE(argumentValue);
+}
+
 std::unique_ptr<std::vector<Card>> ArgumentValueSource::doReadCards(const ArgumentValue& argumentValue) const {
     CAN_NOT_HANDLE(argumentValue);
 }
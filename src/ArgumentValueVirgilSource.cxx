@@ -42,11 +42,10 @@
 #include <cli/api/api.h>
 #include <cli/api/Configurations.h>
 #include <cli/error/ArgumentError.h>
+#include <cli/model/ServiceClient.h>
 
-#include <virgil/sdk/crypto/Crypto.h>
 #include <virgil/sdk/VirgilSdkException.h>
 #include <virgil/sdk/client/Client.h>
-#include <virgil/sdk/client/CardValidator.h>
 #include <virgil/sdk/client/interfaces/ClientInterface.h>
 #include <virgil/sdk/client/models/ClientCommon.h>
 #include <virgil/sdk/client/models/SearchCardsCriteria.h>
@@ -64,17 +63,15 @@ using cli::model::PublicKey;
 using cli::model::PrivateKey;
 using cli::model::Password;
 using cli::model::Card;
+using cli::model::CardCache;
+using cli::model::ServiceClient;
 using cli::model::Password;
-using cli::error::ArgumentNotFoundError;
 
 using virgil::sdk::VirgilSdkException;
 using virgil::sdk::client::Client;
-using virgil::sdk::client::CardValidator;
-using virgil::sdk::client::ServiceConfig;
 using virgil::sdk::client::interfaces::ClientInterface;
 using virgil::sdk::client::models::SearchCardsCriteria;
 using virgil::sdk::client::models::CardScope;
-using ServiceCrypto = virgil::sdk::crypto::Crypto;
 
 ArgumentValueVirgilSource::ArgumentValueVirgilSource(ArgumentValueVirgilSource&&) = default;
 
@@ -86,28 +83,30 @@ namespace cli { namespace argument {
 
 class ArgumentValueVirgilSource::Impl {
 public:
+    explicit Impl(std::shared_ptr<CardCache> cardCache) : cardCache_(std::move(cardCache)) {
+    }
+
     void setAccessToken(std::string accessToken) {
         accessToken_ = std::move(accessToken);
     }
 
-    std::unique_ptr<Client> buildClient() const {
-        if (accessToken_.empty()) {
-            throw ArgumentNotFoundError(arg::value::VIRGIL_CONFIG_APP_ACCESS_TOKEN);
-        }
+    std::shared_ptr<Client> client() const {
+        return ServiceClient::get(accessToken_);
+    }
 
-        auto serviceConfig = ServiceConfig::createConfig(accessToken_);
-        serviceConfig.cardValidator(std::make_unique<CardValidator>(std::make_shared<ServiceCrypto>()));
-        return std::make_unique<Client>(std::move(serviceConfig));
+    CardCache* cardCache() const {
+        return cardCache_.get();
     }
 
 private:
     std::string accessToken_;
+    std::shared_ptr<CardCache> cardCache_;
 };
 
 }}
 
-ArgumentValueVirgilSource::ArgumentValueVirgilSource()
-        : impl_(std::make_unique<ArgumentValueVirgilSource::Impl>()) {
+ArgumentValueVirgilSource::ArgumentValueVirgilSource(std::shared_ptr<CardCache> cardCache)
+        : impl_(std::make_unique<ArgumentValueVirgilSource::Impl>(std::move(cardCache))) {
 }
 
 const char* ArgumentValueVirgilSource::doGetName() const {
@@ -130,7 +129,7 @@ std::unique_ptr<std::vector<Card>> ArgumentValueVirgilSource::doReadCards(const
         return nullptr;
     }
 
-    auto client = impl_->buildClient();
+    auto client = impl_->client();
 
     auto globalCardsFuture = client->searchCards(SearchCardsCriteria::createCriteria(
             { argumentValue.value() }, CardScope::global, argumentValue.key()));
@@ -145,6 +144,14 @@ std::unique_ptr<std::vector<Card>> ArgumentValueVirgilSource::doReadCards(const
         ULOG1(INFO) << tfm::format("Found %d Virgil Cards in the global scope.", globalCards.size());
         auto&& applicationCards = applicationCardsFuture.get();
         ULOG1(INFO) << tfm::format("Found %d Virgil Cards in the application scope.", applicationCards.size());
+        ServiceClient::validate(globalCards);
+        ServiceClient::validate(applicationCards);
+
+        if (impl_->cardCache()) {
+            impl_->cardCache()->addCards(argumentValue.value(), argumentValue.key(), CardScope::global, globalCards);
+            impl_->cardCache()->addCards(
+                    argumentValue.value(), argumentValue.key(), CardScope::application, applicationCards);
+        }
 
         globalCards.insert(globalCards.end(),
                 std::make_move_iterator(applicationCards.begin()), std::make_move_iterator(applicationCards.end()));
@@ -163,8 +170,13 @@ std::unique_ptr<Card> ArgumentValueVirgilSource::doReadCard(const ArgumentValue&
     }
     try {
         ULOG1(INFO) << tfm::format("Get Virgil Card with id: '%s' from the Cards service.", argumentValue.value());
-        auto client = impl_->buildClient();
-        return std::make_unique<Card>(client->getCard(argumentValue.value()).get());
+        auto client = impl_->client();
+        auto card = std::make_unique<Card>(client->getCard(argumentValue.value()).get());
+        ServiceClient::validate(*card);
+        if (impl_->cardCache()) {
+            impl_->cardCache()->addCard(*card);
+        }
+        return card;
     } catch (const VirgilSdkException& exception) {
         ULOG(ERROR) << "Failed to get Virgil Card by it's identifier.";
         ULOG(ERROR) << exception.what();
@@ -0,0 +1,360 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/command/BatchCommand.h>
+
+#include <cli/api/api.h>
+#include <cli/api/Application.h>
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <cctype>
+#include <cstdlib>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
+using cli::command::BatchCommand;
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentParseOptions;
+using cli::concurrency::ThreadPool;
+using cli::model::FileDataSink;
+using cli::model::FileDataSource;
+
+namespace {
+
+/**
+ * @brief Maximum number of the scheduled commands per job, that wait for their status to be reported.
+ */
+constexpr const size_t kPendingCommandsPerJob = 4;
+
+constexpr const char kCommentPrefix = '#';
+
+constexpr const char kProgramName[] = "virgil";
+
+constexpr const char kEndOfOptions[] = "--";
+
+struct BatchLine {
+    size_t number;
+    std::vector<std::string> arguments;
+    //! Reason why the line can not be parsed, empty if line is valid.
+    std::string error;
+};
+
+/**
+ * @brief Split given line to the arguments by the shell like rules.
+ * @note Arguments are separated by whitespaces, single and double quotes group characters,
+ *     backslash escapes next character outside of single quotes.
+ * @throw ArgumentRuntimeError - if line contains unterminated quote.
+ */
+std::vector<std::string> splitArguments(const std::string& line, size_t lineNumber) {
+    std::vector<std::string> result;
+    std::string current;
+    bool hasCurrent = false;
+    char quote = '\0';
+    for (size_t i = 0; i < line.size(); ++i) {
+        const char symbol = line[i];
+        if (quote == '\'') {
+            if (symbol == quote) {
+                quote = '\0';
+            } else {
+                current.push_back(symbol);
+            }
+        } else if (symbol == '\\' && i + 1 < line.size()) {
+            current.push_back(line[++i]);
+            hasCurrent = true;
+        } else if (quote == '"') {
+            if (symbol == quote) {
+                quote = '\0';
+            } else {
+                current.push_back(symbol);
+            }
+        } else if (symbol == '\'' || symbol == '"') {
+            quote = symbol;
+            hasCurrent = true;
+        } else if (std::isspace(static_cast<unsigned char>(symbol))) {
+            if (hasCurrent) {
+                result.push_back(std::move(current));
+                current.clear();
+                hasCurrent = false;
+            }
+        } else {
+            current.push_back(symbol);
+            hasCurrent = true;
+        }
+    }
+    if (quote != '\0') {
+        throw cli::error::ArgumentRuntimeError(
+                tfm::format("Batch line %d contains unterminated quote.", lineNumber));
+    }
+    if (hasCurrent) {
+        result.push_back(std::move(current));
+    }
+    return result;
+}
+
+inline bool startsWith(const std::string& value, const char* prefix) {
+    return value.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+}
+
+/**
+ * @brief Return true if command of the given batch line writes its data to the standard output.
+ * @note Command writes to the standard output if it has output, and neither -o nor --out-dir is given.
+ */
+bool writesStandardOutput(const BatchLine& batchLine) {
+    const auto& commandName = batchLine.arguments.front();
+    if (commandName == cli::arg::value::VIRGIL_COMMAND_CARD_REVOKE ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_CARD_SYNC ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_VERIFY) {
+        return false;
+    }
+    for (auto argument = batchLine.arguments.cbegin() + 1;
+            argument != batchLine.arguments.cend() && *argument != kEndOfOptions; ++argument) {
+        if (startsWith(*argument, "-o") || startsWith(*argument, "--out")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Return true if command of the given batch line reads its data from the standard input.
+ * @note Command reads the standard input if it has input, and neither -i nor --in-dir is given.
+ */
+bool readsStandardInput(const BatchLine& batchLine) {
+    const auto& commandName = batchLine.arguments.front();
+    if (commandName == cli::arg::value::VIRGIL_COMMAND_CARD_CREATE ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_CARD_SEARCH ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_CARD_SYNC ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_KEYGEN) {
+        return false;
+    }
+    for (auto argument = batchLine.arguments.cbegin() + 1;
+            argument != batchLine.arguments.cend() && *argument != kEndOfOptions; ++argument) {
+        if (startsWith(*argument, "-i") || startsWith(*argument, "--in")) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Run command of the given batch line.
+ * @note Lines that can not be parsed, long running commands (agent, serve) and nested batches are rejected.
+ * @param isStandardInputShared - if true, then standard input is used by the batch itself or by the concurrent
+ *     commands, so commands that read from the standard input are rejected.
+ * @param isStandardOutputShared - if true, then standard output is used by the batch report or by the concurrent
+ *     commands, so commands that write to the standard output are rejected.
+ * @return Command exit code.
+ */
+int runBatchLine(const BatchLine& batchLine, bool isStandardInputShared, bool isStandardOutputShared) {
+    if (!batchLine.error.empty()) {
+        ULOG(WARNING) << tfm::format("Batch line %d: %s", batchLine.number, batchLine.error);
+        return EXIT_FAILURE;
+    }
+    const auto& commandName = batchLine.arguments.front();
+    if (commandName == cli::arg::value::VIRGIL_COMMAND_AGENT || commandName == cli::arg::value::VIRGIL_COMMAND_SERVE ||
+            commandName == cli::arg::value::VIRGIL_COMMAND_BATCH) {
+        ULOG(WARNING) << tfm::format("Batch line %d: command '%s' can not be run within a batch.",
+                batchLine.number, commandName);
+        return EXIT_FAILURE;
+    }
+    if (isStandardInputShared && readsStandardInput(batchLine)) {
+        ULOG(WARNING) << tfm::format("Batch line %d: command '%s' reads from the standard input, that is shared "
+                "with the batch commands source or with the concurrent commands, so -i must be given to the command.",
+                batchLine.number, commandName);
+        return EXIT_FAILURE;
+    }
+    if (isStandardOutputShared && writesStandardOutput(batchLine)) {
+        ULOG(WARNING) << tfm::format("Batch line %d: command '%s' writes to the standard output, that is shared "
+                "with the batch report or with the concurrent commands, so -o must be given to the command.",
+                batchLine.number, commandName);
+        return EXIT_FAILURE;
+    }
+    return cli::Application::runNonInteractiveCommand(batchLine.arguments);
+}
+
+/**
+ * @brief Reads command lines from the given source without loading it entirely.
+ */
+class BatchReader {
+public:
+    explicit BatchReader(FileDataSource& source) : source_(source), lineNumber_(0) {}
+
+    /**
+     * @brief Read next line that contains a command.
+     * @note Line that can not be split to the arguments is returned with the error, so it is reported as failed.
+     * @return false - if source has no more commands.
+     */
+    bool next(BatchLine& batchLine) {
+        std::string line;
+        while (readLine(line)) {
+            ++lineNumber_;
+            const auto begin = line.find_first_not_of(" \t\r");
+            if (begin == std::string::npos || line[begin] == kCommentPrefix) {
+                continue;
+            }
+            std::vector<std::string> arguments;
+            try {
+                arguments = splitArguments(line, lineNumber_);
+            } catch (const cli::error::ArgumentRuntimeError& error) {
+                batchLine.number = lineNumber_;
+                batchLine.arguments.clear();
+                batchLine.error = error.what();
+                return true;
+            }
+            if (!arguments.empty() && arguments.front() == kProgramName) {
+                arguments.erase(arguments.begin());
+            }
+            if (arguments.empty()) {
+                continue;
+            }
+            batchLine.number = lineNumber_;
+            batchLine.arguments = std::move(arguments);
+            batchLine.error.clear();
+            return true;
+        }
+        return false;
+    }
+
+private:
+    bool readLine(std::string& line) {
+        line.clear();
+        while (true) {
+            const auto end = buffer_.find('\n', position_);
+            if (end != std::string::npos) {
+                line.assign(buffer_, position_, end - position_);
+                position_ = end + 1;
+                return true;
+            }
+            if (!source_.hasData()) {
+                break;
+            }
+            buffer_.erase(0, position_);
+            position_ = 0;
+            const auto chunk = source_.read();
+            buffer_.append(chunk.cbegin(), chunk.cend());
+        }
+        if (position_ < buffer_.size()) {
+            line.assign(buffer_, position_, std::string::npos);
+            buffer_.clear();
+            position_ = 0;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    FileDataSource& source_;
+    std::string buffer_;
+    size_t position_ = 0;
+    size_t lineNumber_;
+};
+
+}
+
+const char* BatchCommand::doGetName() const {
+    return arg::value::VIRGIL_COMMAND_BATCH;
+}
+
+const char* BatchCommand::doGetUsage() const {
+    return usage::VIRGIL_BATCH;
+}
+
+ArgumentParseOptions BatchCommand::doGetArgumentParseOptions() const {
+    return ArgumentParseOptions().disableOptionsFirst();
+}
+
+void BatchCommand::doProcess() const {
+    ULOG1(INFO) << "Read arguments.";
+    auto source = getArgumentIO()->getInputSource(ArgumentImportance::Optional);
+    auto report = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    if (jobs == arg::value::VIRGIL_JOBS_AUTO) {
+        jobs = ThreadPool::hardwareConcurrency();
+    }
+
+    size_t succeededCount = 0;
+    size_t failedCount = 0;
+    auto reportStatus = [&](size_t lineNumber, int exitCode) {
+        const bool isSucceeded = (exitCode == EXIT_SUCCESS);
+        isSucceeded ? ++succeededCount : ++failedCount;
+        report.write(tfm::format("%d: %s\n", lineNumber, isSucceeded ? "success" : "failure"));
+    };
+
+    ULOG1(INFO) << tfm::format("Run batch commands within %d job(s).", jobs);
+    // Each command reads the standard input with its own source, so commands would steal data from each other.
+    const bool isStandardInputShared = !source.isFileInput() || jobs > 1;
+    // Each command writes to the standard output with its own sink, so the output would be mixed up.
+    const bool isStandardOutputShared = !report.isFileOutput() || jobs > 1;
+    BatchReader reader(source);
+    BatchLine batchLine;
+    if (jobs == 1) {
+        // Commands are run one by one, so each command can rely on the result of the previous one.
+        while (reader.next(batchLine)) {
+            reportStatus(batchLine.number, runBatchLine(batchLine, isStandardInputShared, isStandardOutputShared));
+        }
+    } else {
+        // Statuses are reported in the order of the lines, so number of the pending commands is bounded.
+        ThreadPool threadPool(jobs);
+        std::deque<std::pair<size_t, std::future<int>>> pending;
+        auto reportFirst = [&]() {
+            reportStatus(pending.front().first, pending.front().second.get());
+            pending.pop_front();
+        };
+        while (reader.next(batchLine)) {
+            if (pending.size() >= jobs * kPendingCommandsPerJob) {
+                reportFirst();
+            }
+            pending.emplace_back(batchLine.number,
+                    threadPool.submit([batchLine, isStandardInputShared, isStandardOutputShared]() {
+                        return runBatchLine(batchLine, isStandardInputShared, isStandardOutputShared);
+                    }));
+        }
+        while (!pending.empty()) {
+            reportFirst();
+        }
+    }
+    report.flush();
+
+    ULOG(INFO) << tfm::format("Batch finished: %d succeeded, %d failed.", succeededCount, failedCount);
+    if (failedCount > 0) {
+        throw error::ArgumentRuntimeError(tfm::format("%d of the batch commands failed.", failedCount));
+    }
+}
@@ -0,0 +1,190 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/io/BufferPool.h>
+
+#include <algorithm>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if OS_UNIX
+#include <stdlib.h>
+#elif OS_WIN32
+#include <malloc.h>
+#endif
+
+using cli::io::BufferPool;
+
+namespace {
+
+unsigned char* allocateBuffer(size_t size) {
+#if OS_UNIX
+    void* data = nullptr;
+    if (::posix_memalign(&data, BufferPool::kAlignment, size) != 0) {
+        throw std::bad_alloc();
+    }
+    return static_cast<unsigned char*>(data);
+#elif OS_WIN32
+    void* data = ::_aligned_malloc(size, BufferPool::kAlignment);
+    if (data == nullptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<unsigned char*>(data);
+#else
+    return new unsigned char[size];
+#endif
+}
+
+void freeBuffer(unsigned char* data) noexcept {
+#if OS_UNIX
+    ::free(data);
+#elif OS_WIN32
+    ::_aligned_free(data);
+#else
+    delete[] data;
+#endif
+}
+
+}
+
+class BufferPool::Impl {
+public:
+    Impl(size_t bufferSize, size_t maxIdleBuffers)
+            : bufferSize(std::max(bufferSize, size_t(1))), maxIdleBuffers(maxIdleBuffers), idle(), mutex() {
+    }
+
+    ~Impl() noexcept {
+        for (auto data : idle) {
+            freeBuffer(data);
+        }
+    }
+
+    unsigned char* take() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                auto data = idle.back();
+                idle.pop_back();
+                return data;
+            }
+        }
+        return allocateBuffer(bufferSize);
+    }
+
+    void put(unsigned char* data) noexcept {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (idle.size() < maxIdleBuffers) {
+            try {
+                idle.push_back(data);
+                return;
+            } catch (...) {
+                // Fall through to free buffer.
+            }
+        }
+        lock.unlock();
+        freeBuffer(data);
+    }
+
+public:
+    const size_t bufferSize;
+    const size_t maxIdleBuffers;
+    std::vector<unsigned char*> idle;
+    std::mutex mutex;
+};
+
+BufferPool::Buffer::Buffer() : pool_(), data_(nullptr) {
+}
+
+BufferPool::Buffer::Buffer(std::shared_ptr<Impl> pool, unsigned char* data) : pool_(std::move(pool)), data_(data) {
+}
+
+BufferPool::Buffer::Buffer(Buffer&& other) noexcept : pool_(std::move(other.pool_)), data_(other.data_) {
+    other.data_ = nullptr;
+}
+
+BufferPool::Buffer& BufferPool::Buffer::operator=(Buffer&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = std::move(other.pool_);
+        data_ = other.data_;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+BufferPool::Buffer::~Buffer() noexcept {
+    release();
+}
+
+unsigned char* BufferPool::Buffer::data() const {
+    return data_;
+}
+
+size_t BufferPool::Buffer::capacity() const {
+    return pool_ ? pool_->bufferSize : 0;
+}
+
+BufferPool::Buffer::operator bool() const noexcept {
+    return data_ != nullptr;
+}
+
+void BufferPool::Buffer::release() noexcept {
+    if (data_ != nullptr && pool_) {
+        pool_->put(data_);
+    }
+    data_ = nullptr;
+    pool_.reset();
+}
+
+BufferPool::BufferPool(size_t bufferSize, size_t maxIdleBuffers)
+        : impl_(std::make_shared<Impl>(bufferSize, maxIdleBuffers)) {
+}
+
+BufferPool::BufferPool(BufferPool&&) noexcept = default;
+
+BufferPool& BufferPool::operator=(BufferPool&&) noexcept = default;
+
+BufferPool::~BufferPool() noexcept = default;
+
+BufferPool::Buffer BufferPool::acquire() {
+    return Buffer(impl_, impl_->take());
+}
+
+size_t BufferPool::bufferSize() const {
+    return impl_->bufferSize;
+}
@@ -0,0 +1,232 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/model/CardCache.h>
+
+#include <cli/crypto/Crypto.h>
+#include <cli/io/Logger.h>
+#include <cli/io/Path.h>
+#include <cli/memory.h>
+#include <cli/model/ServiceClient.h>
+
+#include <cstdio>
+#include <fstream>
+
+using cli::Crypto;
+using cli::io::Path;
+using cli::model::Card;
+using cli::model::CardCache;
+using cli::model::CardScope;
+using cli::model::ServiceClient;
+
+namespace {
+
+constexpr const char kCacheDirName[] = "cards";
+
+constexpr const char kEntryPrefix_Card[] = "card";
+constexpr const char kEntryPrefix_Search[] = "search";
+
+std::string make_card_key(const std::string& cardId) {
+    return std::string(kEntryPrefix_Card) + ":" + cardId;
+}
+
+std::string make_search_key(const std::string& identity, const std::string& identityType, CardScope scope) {
+    return std::string(kEntryPrefix_Search) + ":" + std::to_string(scope) + ":" + identityType + ":" + identity;
+}
+
+/**
+ * @brief Return unique name of the temporary file for the given file, so concurrent writers never share it.
+ */
+std::string make_temp_path(const std::string& path) {
+    Crypto::Random random(Crypto::ByteUtils::stringToBytes("virgil-cli-card-cache"));
+    return path + "." + Crypto::ByteUtils::bytesToHex(random.randomize(8)) + ".tmp";
+}
+
+}
+
+constexpr const std::time_t CardCache::kTtl_Default;
+constexpr const std::time_t CardCache::kNegativeTtl_Default;
+
+std::shared_ptr<CardCache> CardCache::shared() {
+    static auto cardCache = std::make_shared<CardCache>(Path::joinPath(Path::cfgPath(), kCacheDirName));
+    return cardCache;
+}
+
+CardCache::CardCache(std::string dirPath)
+        : dirPath_(std::move(dirPath)), ttl_(kTtl_Default), negativeTtl_(kNegativeTtl_Default), mutex_(),
+          entries_() {
+}
+
+void CardCache::setTtl(std::time_t ttl) {
+    ttl_ = ttl;
+}
+
+void CardCache::setNegativeTtl(std::time_t ttl) {
+    negativeTtl_ = ttl;
+}
+
+std::unique_ptr<Card> CardCache::findCard(const std::string& cardId) const {
+    auto cards = findEntry(make_card_key(cardId));
+    if (!cards || cards->size() != 1) {
+        return nullptr;
+    }
+    return std::make_unique<Card>(std::move(cards->front()));
+}
+
+std::unique_ptr<std::vector<Card>> CardCache::findCards(
+        const std::string& identity, const std::string& identityType, CardScope scope) const {
+    return findEntry(make_search_key(identity, identityType, scope));
+}
+
+void CardCache::addCard(const Card& card) {
+    addEntry(make_card_key(card.identifier()), { card });
+}
+
+void CardCache::addCards(
+        const std::string& identity, const std::string& identityType, CardScope scope,
+        const std::vector<Card>& cards) {
+    addEntry(make_search_key(identity, identityType, scope), cards);
+}
+
+void CardCache::removeCard(const Card& card) {
+    removeEntry(make_card_key(card.identifier()));
+    removeEntry(make_search_key(card.identity(), card.identityType(), card.scope()));
+}
+
+std::unique_ptr<std::vector<Card>> CardCache::findEntry(const std::string& key) const {
+    if (ttl_ == 0 && negativeTtl_ == 0) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = entries_.find(key);
+    if (found == entries_.end() || isExpired(found->second)) {
+        // Entry may be already refreshed by another process.
+        auto entry = loadEntry(key);
+        if (!entry || isExpired(*entry)) {
+            DLOG(INFO) << tfm::format("Cache entry '%s' is not found or expired.", key);
+            return nullptr;
+        }
+        found = entries_.emplace(key, Entry()).first;
+        found->second = std::move(*entry);
+    }
+    return std::make_unique<std::vector<Card>>(found->second.cards);
+}
+
+bool CardCache::isExpired(const Entry& entry) const {
+    const std::time_t ttl = entry.cards.empty() ? negativeTtl_.load() : ttl_.load();
+    return std::time(nullptr) - entry.storedAt >= ttl;
+}
+
+void CardCache::addEntry(const std::string& key, const std::vector<Card>& cards) {
+    if ((cards.empty() ? negativeTtl_.load() : ttl_.load()) == 0) {
+        return;
+    }
+    Entry entry{ std::time(nullptr), cards };
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!Path::createDir(dirPath_)) {
+        LOG(WARNING) << tfm::format("Can not create card cache directory '%s'.", dirPath_);
+    } else {
+        // Write to the temporary file and then replace entry, so concurrent processes never read partial entry.
+        const auto path = entryPath(key);
+        const auto tmpPath = make_temp_path(path);
+        bool isWritten = false;
+        {
+            std::ofstream file(tmpPath, std::ios::out | std::ios::trunc);
+            file << entry.storedAt << '\n';
+            for (const auto& card : entry.cards) {
+                file << card.exportAsString() << '\n';
+            }
+            file.flush();
+            isWritten = file.good();
+        }
+#if OS_WIN32
+        if (isWritten) {
+            std::remove(path.c_str());
+        }
+#endif //OS_WIN32
+        if (!isWritten || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            LOG(WARNING) << tfm::format("Can not write card cache entry '%s'.", path);
+            std::remove(tmpPath.c_str());
+        }
+    }
+    entries_[key] = std::move(entry);
+}
+
+void CardCache::removeEntry(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(key);
+    const auto path = entryPath(key);
+    if (std::remove(path.c_str()) == 0) {
+        ULOG3(INFO) << tfm::format("Remove card cache entry '%s'.", key);
+    }
+}
+
+std::unique_ptr<CardCache::Entry> CardCache::loadEntry(const std::string& key) const {
+    const auto path = entryPath(key);
+    std::ifstream file(path);
+    if (!file) {
+        return nullptr;
+    }
+    auto entry = std::make_unique<Entry>();
+    if (!(file >> entry->storedAt)) {
+        LOG(WARNING) << tfm::format("Card cache entry '%s' is malformed and ignored.", path);
+        return nullptr;
+    }
+    try {
+        for (std::string line; std::getline(file, line);) {
+            if (line.empty()) {
+                continue;
+            }
+            auto card = Card::importFromString(line);
+            if (!ServiceClient::isValid(card)) {
+                LOG(WARNING) << tfm::format("Card cache entry '%s' has invalid signature and is removed.", path);
+                std::remove(path.c_str());
+                return nullptr;
+            }
+            entry->cards.push_back(std::move(card));
+        }
+    } catch (const std::exception& exception) {
+        LOG(WARNING) << tfm::format("Card cache entry '%s' is malformed and ignored: %s", path, exception.what());
+        return nullptr;
+    }
+    ULOG3(INFO) << tfm::format("Load %d Virgil Card(s) from the cache entry '%s'.", entry->cards.size(), path);
+    return entry;
+}
+
+std::string CardCache::entryPath(const std::string& key) const {
+    const auto hash = Crypto::Hash(Crypto::HashAlgorithm::SHA256).hash(Crypto::ByteUtils::stringToBytes(key));
+    return Path::joinPath(dirPath_, Crypto::ByteUtils::bytesToHex(hash));
+}
@@ -42,13 +42,13 @@
 #include <cli/error/ArgumentError.h>
 #include <cli/formatter/BorderFormatter.h>
 #include <cli/formatter/CardKeyValueFormatter.h>
+#include <cli/model/CardCache.h>
+#include <cli/model/ServiceClient.h>
 
 #include <cli/memory.h>
 
 #include <virgil/sdk/crypto/Crypto.h>
-#include <virgil/sdk/client/Client.h>
 #include <virgil/sdk/client/RequestSigner.h>
-#include <virgil/sdk/client/CardValidator.h>
 #include <virgil/sdk/client/models/interfaces/SignableRequestInterface.h>
 #include <virgil/sdk/client/models/serialization/JsonSerializer.h>
 
@@ -61,10 +61,9 @@ using cli::error::ArgumentRuntimeError;
 using cli::error::ArgumentLogicError;
 using cli::formatter::BorderFormatter;
 using cli::formatter::CardKeyValueFormatter;
+using cli::model::CardCache;
+using cli::model::ServiceClient;
 
-using virgil::sdk::client::Client;
-using virgil::sdk::client::ServiceConfig;
-using virgil::sdk::client::CardValidator;
 using virgil::sdk::client::RequestSigner;
 using virgil::sdk::client::models::requests::CreateCardRequest;
 using virgil::sdk::client::models::interfaces::SignableRequestInterface;
@@ -102,7 +101,7 @@ void CardCreateCommand::doProcess() const {
     ULOG1(INFO) << "Sign request with given private key.";
     auto crypto = std::make_shared<ServiceCrypto>();
     RequestSigner signer(crypto);
-    auto selfPrivateKey = crypto->importPrivateKey(privateKey.key(), privateKey.password().stringValue());
+    auto selfPrivateKey = crypto->importPrivateKey(privateKey.unlockedKey(), std::string());
     signer.selfSign(createCardRequest, selfPrivateKey);
 
     if (scope == arg::value::VIRGIL_CARD_CREATE_SCOPE_APPLICATION) {
@@ -110,7 +109,7 @@ void CardCreateCommand::doProcess() const {
         auto appCredentials = getArgumentIO()->getAppCredentials(ArgumentImportance::Required);
         ULOG1(INFO) << "Import application private key.";
         auto appPrivateKey = crypto->importPrivateKey(
-                appCredentials.appPrivateKey().key(), appCredentials.appPrivateKey().password().stringValue());
+                appCredentials.appPrivateKey().unlockedKey(), std::string());
         ULOG1(INFO) << "Sign request with application private key (authority sign).";
         signer.authoritySign(createCardRequest, appCredentials.appId().stringValue(), appPrivateKey);
     } else if (scope == arg::value::VIRGIL_CARD_CREATE_SCOPE_GLOBAL) {
@@ -128,14 +127,16 @@ void CardCreateCommand::doProcess() const {
     ULOG1(INFO) << "Request card creation.";
     LOG(INFO) << "Card create request:\n"
               << JsonSerializer<SignableRequestInterface>::toJson(createCardRequest);
-    auto serviceConfig = ServiceConfig::createConfig(appAccessToken.stringValue());
-    serviceConfig.cardValidator(std::make_unique<CardValidator>(crypto));
-    Client client(std::move(serviceConfig));
-    auto card = client.createCard(createCardRequest).get();
+    auto client = ServiceClient::get(appAccessToken.stringValue());
+    auto card = client->createCard(createCardRequest).get();
+    ServiceClient::validate(card);
+    // Cached search result of the identity (even the empty one) does not contain the created card.
+    CardCache::shared()->removeCard(card);
     ULOG1(INFO) << "Write card to the output.";
     if (noFormat || output.isFileOutput()) {
         output.write(card.exportAsString());
     } else {
         output.write(BorderFormatter().format(CardKeyValueFormatter().showBaseProperties().format(card)));
     }
+    output.flush();
 }
@@ -37,22 +37,26 @@
 #include <cli/command/CardGetCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/concurrency/ConcurrentTaskRunner.h>
 #include <cli/crypto/Crypto.h>
 #include <cli/io/Logger.h>
 #include <cli/error/ArgumentError.h>
 #include <cli/formatter/BorderFormatter.h>
 #include <cli/formatter/CardKeyValueFormatter.h>
 #include <cli/formatter/CardRawFormatter.h>
+#include <cli/io/Path.h>
+#include <cli/model/Card.h>
+#include <cli/model/FileDataSink.h>
+#include <cli/model/ServiceClient.h>
 
 #include <cli/memory.h>
 
-#include <virgil/sdk/crypto/Crypto.h>
-#include <virgil/sdk/client/Client.h>
 #include <virgil/sdk/client/RequestSigner.h>
-#include <virgil/sdk/client/CardValidator.h>
+
 
 using cli::Crypto;
 using cli::command::CardGetCommand;
+using cli::concurrency::ConcurrentTaskRunner;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentParseOptions;
@@ -60,11 +64,19 @@ using cli::error::ArgumentRuntimeError;
 using cli::formatter::BorderFormatter;
 using cli::formatter::CardKeyValueFormatter;
 using cli::formatter::CardRawFormatter;
+using cli::io::Path;
+using cli::model::Card;
+using cli::model::FileDataSink;
+using cli::model::ServiceClient;
+
+namespace {
+
+struct FetchResult {
+    std::unique_ptr<Card> card;
+    std::string error;
+};
 
-using virgil::sdk::client::Client;
-using virgil::sdk::client::ServiceConfig;
-using virgil::sdk::client::CardValidator;
-using ServiceCrypto = virgil::sdk::crypto::Crypto;
+}
 
 const char* CardGetCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_CARD_GET;
@@ -80,20 +92,60 @@ ArgumentParseOptions CardGetCommand::doGetArgumentParseOptions() const {
 
 void CardGetCommand::doProcess() const {
     ULOG1(INFO) << "Read arguments.";
-    auto input = getArgumentIO()->getInput(ArgumentImportance::Optional);
+    auto cardIds = getArgumentIO()->getCardIds(ArgumentImportance::Required);
+    auto outputDir = getArgumentIO()->getOutputDir(ArgumentImportance::Optional);
     auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
     auto appAccessToken = getArgumentIO()->getAppAccessToken(ArgumentImportance::Required);
     auto noFormat = getArgumentIO()->isNoFormat();
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+
+    if (!outputDir.empty() && !Path::createDir(outputDir)) {
+        throw ArgumentRuntimeError(tfm::format("Can not create output directory '%s'.", outputDir));
+    }
+    // Single card is written as is, so it can be read back by the other commands.
+    const bool isMultiple = cardIds.size() > 1;
+    auto writeCard = [&](const Card& card) {
+        if (!outputDir.empty()) {
+            auto fileName = Path::joinPath(outputDir, card.identifier() + ".vcard");
+            ULOG1(INFO) << tfm::format("Write Virgil Card to the file '%s'.", fileName);
+            FileDataSink fileDataSink(fileName);
+            fileDataSink.write(card.exportAsString());
+            fileDataSink.flush();
+        } else if (noFormat || output.isFileOutput()) {
+            output.write(isMultiple ? card.exportAsString() + "\n" : card.exportAsString());
+        } else {
+            output.write(BorderFormatter().format(CardKeyValueFormatter().showBaseProperties().format(card)));
+        }
+    };
 
-    ULOG1(INFO) << "Request card.";
-    auto serviceConfig = ServiceConfig::createConfig(appAccessToken.stringValue());
-    serviceConfig.cardValidator(std::make_unique<CardValidator>(std::make_shared<ServiceCrypto>()));
-    Client client(std::move(serviceConfig));
-    auto card = client.getCard(input.stringValue()).get();
-    ULOG1(INFO) << "Write card to the output.";
-    if (noFormat || output.isFileOutput()) {
-        output.write(card.exportAsString());
-    } else {
-        output.write(BorderFormatter().format(CardKeyValueFormatter().showBaseProperties().format(card)));
+    ULOG1(INFO) << tfm::format("Request %d card(s).", cardIds.size());
+    auto client = ServiceClient::get(appAccessToken.stringValue());
+    // Card that was not fetched is reported and does not stop fetching of the other cards.
+    size_t failedCount = 0;
+    ConcurrentTaskRunner<FetchResult>(jobs).run(cardIds.size(),
+            [&client, &cardIds](size_t index) {
+                FetchResult result;
+                try {
+                    result.card = std::make_unique<Card>(client->getCard(cardIds[index]).get());
+                    ServiceClient::validate(*result.card);
+                } catch (const std::exception& exception) {
+                    result.card.reset();
+                    result.error = exception.what();
+                }
+                return result;
+            },
+            [&cardIds, &failedCount, &writeCard](size_t index, FetchResult& result) {
+                if (!result.card) {
+                    ULOG(ERROR) << tfm::format("Failed to get Virgil Card '%s'. %s", cardIds[index], result.error);
+                    ++failedCount;
+                    return;
+                }
+                ULOG1(INFO) << tfm::format("Write card '%s' to the output.", cardIds[index]);
+                writeCard(*result.card);
+            });
+    output.flush();
+    if (failedCount > 0) {
+        throw ArgumentRuntimeError(
+                tfm::format("Failed to get %d of %d Virgil Card(s).", failedCount, cardIds.size()));
     }
 }
@@ -136,4 +136,5 @@ void CardInfoCommand::doProcess() const {
         ULOG1(INFO) << "Write card info to the output.";
         output.write(cardInfo);
     }
+    output.flush();
 }
@@ -0,0 +1,460 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/model/CardMirror.h>
+
+#include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/io/Path.h>
+#include <cli/memory.h>
+#include <cli/model/ServiceClient.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <limits>
+
+#if OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif //OS_UNIX
+
+using cli::Crypto;
+using cli::error::ArgumentRuntimeError;
+using cli::io::Path;
+using cli::model::Card;
+using cli::model::CardIdentityGroup;
+using cli::model::CardMirror;
+using cli::model::ServiceClient;
+using cli::model::internal::CardMirrorIndex;
+
+namespace {
+
+constexpr const char kIndexFileName[] = "index";
+constexpr const char kIndexHeader[] = "VIRGIL-CARD-INDEX 1";
+constexpr const char kCardFileExtension[] = ".vcard";
+constexpr const char kFieldSeparator = '\t';
+
+/**
+ * @note Separator is less than any character that is allowed in the identity and identity type,
+ *     so keys are ordered by identity type first, and then by identity.
+ */
+std::string make_key(const std::string& identity, const std::string& identityType) {
+    return identityType + kFieldSeparator + identity;
+}
+
+/**
+ * @brief Return unique name of the temporary file for the given file, so concurrent writers never share it.
+ */
+std::string make_temp_path(const std::string& path) {
+    Crypto::Random random(Crypto::ByteUtils::stringToBytes("virgil-cli-card-mirror"));
+    return path + "." + Crypto::ByteUtils::bytesToHex(random.randomize(8)) + ".tmp";
+}
+
+bool is_indexable(const std::string& value) {
+    return std::none_of(value.cbegin(), value.cend(), [](char c) { return static_cast<unsigned char>(c) < 0x20; });
+}
+
+}
+
+namespace cli { namespace model { namespace internal {
+
+/**
+ * @brief Read only view of the index file, file is mapped to the memory if it is supported.
+ */
+class CardMirrorIndex {
+public:
+    /**
+     * @return Index, or nullptr if index file does not exist.
+     * @throw error::ArgumentRuntimeError - if file is not an index.
+     */
+    static std::unique_ptr<CardMirrorIndex> open(const std::string& path) {
+        std::unique_ptr<CardMirrorIndex> result;
+#if OS_UNIX
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+                static_cast<unsigned long long>(info.st_size) <= std::numeric_limits<size_t>::max()) {
+            const auto size = static_cast<size_t>(info.st_size);
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                result.reset(new CardMirrorIndex(static_cast<const char*>(data), size));
+            }
+        }
+        (void)::close(fd);
+#endif //OS_UNIX
+        if (!result) {
+            std::ifstream file(path, std::ios::in | std::ios::binary);
+            if (!file) {
+                return nullptr;
+            }
+            result.reset(new CardMirrorIndex(std::string(
+                    std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>())));
+        }
+        const auto headerSize = std::strlen(kIndexHeader);
+        if (result->size_ <= headerSize || std::memcmp(result->data_, kIndexHeader, headerSize) != 0 ||
+                result->data_[headerSize] != '\n') {
+            throw ArgumentRuntimeError(tfm::format("File '%s' is not an index of the Virgil Card mirror.", path));
+        }
+        result->records_ = result->data_ + headerSize + 1;
+        return result;
+    }
+
+    ~CardMirrorIndex() noexcept {
+#if OS_UNIX
+        if (isMapped_) {
+            (void)::munmap(const_cast<char*>(data_), size_);
+        }
+#endif //OS_UNIX
+    }
+
+    /**
+     * @brief Find record with the given key, with the binary search over the sorted lines.
+     * @return true if record is found, false - otherwise.
+     */
+    bool find(const std::string& key, std::vector<std::string>& fields) const {
+        const char* low = records_;
+        const char* high = data_ + size_;
+        while (low < high) {
+            const char* lineBegin = low + (high - low) / 2;
+            while (lineBegin > low && *(lineBegin - 1) != '\n') {
+                --lineBegin;
+            }
+            const char* lineEnd = findLineEnd(lineBegin);
+            if (compareKey(lineBegin, lineEnd, key) < 0) {
+                low = std::min(lineEnd + 1, high);
+            } else {
+                high = lineBegin;
+            }
+        }
+        const char* lineEnd = findLineEnd(low);
+        if (low == data_ + size_ || compareKey(low, lineEnd, key) != 0) {
+            return false;
+        }
+        fields = splitFields(low, lineEnd);
+        return true;
+    }
+
+    void forEach(const std::function<void(std::vector<std::string>)>& handler) const {
+        for (const char* lineBegin = records_; lineBegin < data_ + size_;) {
+            const char* lineEnd = findLineEnd(lineBegin);
+            if (lineEnd != lineBegin) {
+                handler(splitFields(lineBegin, lineEnd));
+            }
+            lineBegin = lineEnd + 1;
+        }
+    }
+
+private:
+    CardMirrorIndex(const char* data, size_t size)
+            : buffer_(), data_(data), size_(size), records_(data), isMapped_(true) {
+    }
+
+    explicit CardMirrorIndex(std::string buffer)
+            : buffer_(std::move(buffer)), data_(buffer_.data()), size_(buffer_.size()),
+              records_(data_), isMapped_(false) {
+    }
+
+    const char* findLineEnd(const char* lineBegin) const {
+        const auto end = data_ + size_;
+        const auto lineEnd = static_cast<const char*>(std::memchr(lineBegin, '\n', end - lineBegin));
+        return lineEnd != nullptr ? lineEnd : end;
+    }
+
+    /**
+     * @brief Compare key of the record (identity type and identity) with the given key, as std::string does.
+     */
+    static int compareKey(const char* lineBegin, const char* lineEnd, const std::string& key) {
+        const char* keyEnd = lineEnd;
+        const auto typeEnd = static_cast<const char*>(std::memchr(lineBegin, kFieldSeparator, lineEnd - lineBegin));
+        if (typeEnd != nullptr) {
+            const auto identityEnd = static_cast<const char*>(
+                    std::memchr(typeEnd + 1, kFieldSeparator, lineEnd - typeEnd - 1));
+            keyEnd = identityEnd != nullptr ? identityEnd : lineEnd;
+        }
+        const auto recordKeySize = static_cast<size_t>(keyEnd - lineBegin);
+        const int result = std::char_traits<char>::compare(lineBegin, key.data(), std::min(recordKeySize, key.size()));
+        if (result != 0) {
+            return result;
+        }
+        return recordKeySize < key.size() ? -1 : (recordKeySize > key.size() ? 1 : 0);
+    }
+
+    static std::vector<std::string> splitFields(const char* lineBegin, const char* lineEnd) {
+        std::vector<std::string> result;
+        for (const char* fieldBegin = lineBegin;;) {
+            const auto fieldEnd = static_cast<const char*>(
+                    std::memchr(fieldBegin, kFieldSeparator, lineEnd - fieldBegin));
+            result.emplace_back(fieldBegin, fieldEnd != nullptr ? fieldEnd : lineEnd);
+            if (fieldEnd == nullptr) {
+                return result;
+            }
+            fieldBegin = fieldEnd + 1;
+        }
+    }
+
+private:
+    const std::string buffer_;
+    const char* const data_;
+    const size_t size_;
+    const char* records_;
+    const bool isMapped_;
+};
+
+}}}
+
+CardMirror::CardMirror(std::string dirPath)
+        : dirPath_(std::move(dirPath)), index_(), records_(), staleCardIds_() {
+}
+
+CardMirror::~CardMirror() noexcept = default;
+
+std::unique_ptr<std::vector<Card>> CardMirror::findCards(
+        const std::string& identity, const std::string& identityType) const {
+    auto mirrorIndex = index();
+    std::vector<std::string> fields;
+    if (mirrorIndex == nullptr || !mirrorIndex->find(make_key(identity, identityType), fields)) {
+        return nullptr;
+    }
+    auto cards = std::make_unique<std::vector<Card>>();
+    for (const auto& cardId : parseRecord(std::move(fields)).cardIds) {
+        auto card = loadCard(cardId);
+        if (!card) {
+            continue;
+        }
+        if (card->identity() != identity || card->identityType() != identityType) {
+            LOG(WARNING) << tfm::format("Virgil Card '%s' of the mirror does not belong to the identity '%s:%s'.",
+                    cardId, identityType, identity);
+            continue;
+        }
+        cards->push_back(std::move(*card));
+    }
+    return cards;
+}
+
+CardIdentityGroup CardMirror::identities() const {
+    CardIdentityGroup result;
+    for (const auto& entry : records()) {
+        result.append(entry.second.identity, entry.second.identityType);
+    }
+    return result;
+}
+
+std::time_t CardMirror::syncedAt(const std::string& identity, const std::string& identityType) const {
+    const auto& allRecords = records();
+    auto found = allRecords.find(make_key(identity, identityType));
+    return found != allRecords.cend() ? found->second.syncedAt : 0;
+}
+
+size_t CardMirror::update(
+        const std::string& identity, const std::string& identityType, const std::vector<Card>& cards) {
+    if (!is_indexable(identity) || !is_indexable(identityType)) {
+        throw ArgumentRuntimeError(tfm::format(
+                "Identity '%s:%s' can not be mirrored, because it contains control characters.",
+                identityType, identity));
+    }
+    if (!Path::createDir(dirPath_)) {
+        throw ArgumentRuntimeError(tfm::format("Can not create card mirror directory '%s'.", dirPath_));
+    }
+    Record record{ identityType, identity, std::time(nullptr), {} };
+    size_t writtenCount = 0;
+    for (const auto& card : cards) {
+        record.cardIds.push_back(card.identifier());
+        // Virgil Card identifier is the fingerprint of its content, so the mirrored file is never outdated.
+        const auto path = cardPath(card.identifier());
+        if (Path::existsFile(path)) {
+            continue;
+        }
+        ULOG2(INFO) << tfm::format("Write Virgil Card: %s:%s (%s), to the file '%s'.",
+                card.identityType(), card.identity(), card.identifier(), path);
+        const auto tmpPath = make_temp_path(path);
+        bool isWritten = false;
+        {
+            std::ofstream file(tmpPath, std::ios::out | std::ios::trunc);
+            file << card.exportAsString();
+            file.flush();
+            isWritten = file.good();
+        }
+        if (!isWritten || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            // Concurrent synchronization may write the same Virgil Card first.
+            if (!isWritten || !Path::existsFile(path)) {
+                throw ArgumentRuntimeError(tfm::format("Can not write Virgil Card to the file '%s'.", path));
+            }
+        }
+        ++writtenCount;
+    }
+    std::sort(record.cardIds.begin(), record.cardIds.end());
+    record.cardIds.erase(std::unique(record.cardIds.begin(), record.cardIds.end()), record.cardIds.end());
+
+    auto& allRecords = records();
+    const auto key = make_key(identity, identityType);
+    auto found = allRecords.find(key);
+    if (found == allRecords.end()) {
+        allRecords.emplace(key, std::move(record));
+    } else {
+        std::set_difference(
+                found->second.cardIds.cbegin(), found->second.cardIds.cend(),
+                record.cardIds.cbegin(), record.cardIds.cend(),
+                std::inserter(staleCardIds_, staleCardIds_.end()));
+        found->second = std::move(record);
+    }
+    return writtenCount;
+}
+
+size_t CardMirror::commit() {
+    if (!records_) {
+        return 0;
+    }
+    if (!Path::createDir(dirPath_)) {
+        throw ArgumentRuntimeError(tfm::format("Can not create card mirror directory '%s'.", dirPath_));
+    }
+    // Write to the temporary file and then replace index, so concurrent readers never read partial index.
+    const auto path = Path::joinPath(dirPath_, kIndexFileName);
+    const auto tmpPath = make_temp_path(path);
+    bool isWritten = false;
+    {
+        std::ofstream file(tmpPath, std::ios::out | std::ios::trunc | std::ios::binary);
+        file << kIndexHeader << '\n';
+        for (const auto& entry : *records_) {
+            const auto& record = entry.second;
+            file << record.identityType << kFieldSeparator << record.identity << kFieldSeparator << record.syncedAt;
+            for (const auto& cardId : record.cardIds) {
+                file << kFieldSeparator << cardId;
+            }
+            file << '\n';
+        }
+        file.flush();
+        isWritten = file.good();
+    }
+    // Mapped index is released before it is replaced.
+    index_.reset();
+#if OS_WIN32
+    if (isWritten) {
+        std::remove(path.c_str());
+    }
+#endif //OS_WIN32
+    if (!isWritten || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        throw ArgumentRuntimeError(tfm::format("Can not write index of the Virgil Card mirror '%s'.", path));
+    }
+    ULOG2(INFO) << tfm::format("Write %d identities to the index of the Virgil Card mirror '%s'.",
+            records_->size(), path);
+
+    std::set<std::string> referencedCardIds;
+    for (const auto& entry : *records_) {
+        referencedCardIds.insert(entry.second.cardIds.cbegin(), entry.second.cardIds.cend());
+    }
+    size_t removedCount = 0;
+    for (const auto& cardId : staleCardIds_) {
+        if (referencedCardIds.count(cardId) == 0 && std::remove(cardPath(cardId).c_str()) == 0) {
+            ULOG2(INFO) << tfm::format("Remove Virgil Card '%s' from the mirror.", cardId);
+            ++removedCount;
+        }
+    }
+    staleCardIds_.clear();
+    return removedCount;
+}
+
+const CardMirrorIndex* CardMirror::index() const {
+    if (!index_) {
+        index_ = CardMirrorIndex::open(Path::joinPath(dirPath_, kIndexFileName));
+    }
+    return index_.get();
+}
+
+std::map<std::string, CardMirror::Record>& CardMirror::records() const {
+    if (!records_) {
+        records_ = std::make_unique<std::map<std::string, Record>>();
+        if (auto mirrorIndex = index()) {
+            mirrorIndex->forEach([this](std::vector<std::string> fields) {
+                auto record = parseRecord(std::move(fields));
+                auto key = make_key(record.identity, record.identityType);
+                records_->emplace(std::move(key), std::move(record));
+            });
+        }
+    }
+    return *records_;
+}
+
+CardMirror::Record CardMirror::parseRecord(std::vector<std::string> fields) const {
+    if (fields.size() < 3) {
+        throw ArgumentRuntimeError(tfm::format(
+                "Index of the Virgil Card mirror '%s' is malformed, remove it and synchronize the mirror again.",
+                dirPath_));
+    }
+    Record record{ std::move(fields[0]), std::move(fields[1]), std::strtoll(fields[2].c_str(), nullptr, 10), {} };
+    record.cardIds.assign(
+            std::make_move_iterator(fields.begin() + 3), std::make_move_iterator(fields.end()));
+    return record;
+}
+
+std::unique_ptr<Card> CardMirror::loadCard(const std::string& cardId) const {
+    const auto path = cardPath(cardId);
+    std::ifstream file(path);
+    if (!file) {
+        LOG(WARNING) << tfm::format("Virgil Card '%s' is not found in the mirror.", cardId);
+        return nullptr;
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    text.erase(text.find_last_not_of(" \t\r\n") + 1);
+    try {
+        auto card = std::make_unique<Card>(Card::importFromString(text));
+        if (card->identifier() != cardId || !ServiceClient::isValid(*card)) {
+            LOG(WARNING) << tfm::format("Virgil Card file '%s' has invalid signature and is ignored.", path);
+            return nullptr;
+        }
+        return card;
+    } catch (const std::exception& exception) {
+        LOG(WARNING) << tfm::format("Virgil Card file '%s' is malformed and ignored: %s", path, exception.what());
+        return nullptr;
+    }
+}
+
+std::string CardMirror::cardPath(const std::string& cardId) const {
+    return Path::joinPath(dirPath_, cardId + kCardFileExtension);
+}
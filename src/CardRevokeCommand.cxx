@@ -40,13 +40,13 @@
 #include <cli/crypto/Crypto.h>
 #include <cli/io/Logger.h>
 #include <cli/error/ArgumentError.h>
+#include <cli/model/CardCache.h>
+#include <cli/model/ServiceClient.h>
 
 #include <cli/memory.h>
 
 #include <virgil/sdk/crypto/Crypto.h>
-#include <virgil/sdk/client/Client.h>
 #include <virgil/sdk/client/RequestSigner.h>
-#include <virgil/sdk/client/CardValidator.h>
 #include <virgil/sdk/client/models/interfaces/SignableRequestInterface.h>
 #include <virgil/sdk/client/models/serialization/JsonSerializer.h>
 
@@ -56,11 +56,10 @@ using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentParseOptions;
 using cli::error::ArgumentRuntimeError;
+using cli::model::CardCache;
 using cli::model::CardScope;
+using cli::model::ServiceClient;
 
-using virgil::sdk::client::Client;
-using virgil::sdk::client::ServiceConfig;
-using virgil::sdk::client::CardValidator;
 using virgil::sdk::client::RequestSigner;
 using virgil::sdk::client::models::requests::RevokeCardRequest;
 using virgil::sdk::client::models::interfaces::SignableRequestInterface;
@@ -98,7 +97,7 @@ void CardRevokeCommand::doProcess() const {
             auto appCredentials = getArgumentIO()->getAppCredentials(ArgumentImportance::Required);
             ULOG1(INFO) << "Import application private key.";
             auto appPrivateKey = crypto->importPrivateKey(
-                    appCredentials.appPrivateKey().key(), appCredentials.appPrivateKey().password().stringValue());
+                    appCredentials.appPrivateKey().unlockedKey(), std::string());
             ULOG1(INFO) << "Sign request with application private key (authority sign).";
             signer.authoritySign(revokeCardRequest, appCredentials.appId().stringValue(), appPrivateKey);
         }
@@ -117,9 +116,9 @@ void CardRevokeCommand::doProcess() const {
     ULOG1(INFO) << "Request card revocation.";
     LOG(INFO) << "Card revoke request:\n"
               << JsonSerializer<SignableRequestInterface>::toJson(revokeCardRequest);
-    auto serviceConfig = ServiceConfig::createConfig(appAccessToken.stringValue());
-    serviceConfig.cardValidator(std::make_unique<CardValidator>(crypto));
-    Client client(std::move(serviceConfig));
-    client.revokeCard(revokeCardRequest).get();
+    auto client = ServiceClient::get(appAccessToken.stringValue());
+    client->revokeCard(revokeCardRequest).get();
     ULOG1(INFO) << tfm::format("Card with id '%s' was revoked.", card.identifier());
+    // Revoked card must not be used as recipient anymore, even if it was cached.
+    CardCache::shared()->removeCard(card);
 }
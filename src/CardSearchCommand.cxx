@@ -43,13 +43,11 @@
 #include <cli/error/ArgumentError.h>
 #include <cli/formatter/BorderFormatter.h>
 #include <cli/formatter/CardKeyValueFormatter.h>
+#include <cli/model/CardMirror.h>
+#include <cli/model/ServiceClient.h>
 
 #include <cli/memory.h>
 
-#include <virgil/sdk/crypto/Crypto.h>
-#include <virgil/sdk/client/Client.h>
-#include <virgil/sdk/client/CardValidator.h>
-
 #include <iostream>
 
 using cli::Crypto;
@@ -59,18 +57,15 @@ using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentParseOptions;
 using cli::error::ArgumentRuntimeError;
 using cli::model::Card;
+using cli::model::CardIdentityGroup;
+using cli::model::CardMirror;
 using cli::model::CardScope;
 using cli::model::card_scope_from;
 using cli::model::FileDataSink;
 using cli::io::Path;
 using cli::formatter::BorderFormatter;
 using cli::formatter::CardKeyValueFormatter;
-
-using virgil::sdk::client::Client;
-using virgil::sdk::client::ServiceConfig;
-using virgil::sdk::client::CardValidator;
-using virgil::sdk::client::models::SearchCardsCriteria;
-using ServiceCrypto = virgil::sdk::crypto::Crypto;
+using cli::model::ServiceClient;
 
 const char* CardSearchCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_CARD_SEARCH;
@@ -94,6 +89,9 @@ static void purgeCardsToStandardOut(const std::vector<Card>& cards, bool noForma
             std::cout << BorderFormatter().format(CardKeyValueFormatter().showBaseProperties().format(card));
         }
     }
+    if (!std::cout.flush()) {
+        throw ArgumentRuntimeError("Output was not written completely, i.e. output pipe is closed.");
+    }
 }
 
 static void purgeCardsToDir(const std::vector<Card>& cards, const std::string& outDir) {
@@ -102,11 +100,8 @@ static void purgeCardsToDir(const std::vector<Card>& cards, const std::string& o
         ULOG1(INFO) << tfm::format("Write Virgil Card: %s:%s (%s), to the file '%s'.",
                 card.identityType(), card.identity(), card.identifier(), fileName);
         FileDataSink fileDataSink(fileName);
-        if (fileDataSink.isGood()) {
-            fileDataSink.write(card.exportAsString());
-        } else {
-            ULOG(ERROR) << tfm::format("File '%s' was not written due to errors.", fileName);
-        }
+        fileDataSink.write(card.exportAsString());
+        fileDataSink.flush();
     }
 }
 
@@ -142,27 +137,48 @@ std::string format_list(const std::vector<T>& v) {
     return format_list(v.cbegin(), v.cend());
 }
 
+static void searchCardsOffline(
+        const CardIdentityGroup& cardIdentityGroup, const std::string& mirrorDir, const std::string& outDir,
+        bool noFormat) {
+    CardMirror mirror(mirrorDir);
+    for (const auto& cardIdentity : cardIdentityGroup.identities()) {
+        for (const auto& identity : cardIdentity.second) {
+            auto cards = mirror.findCards(identity, cardIdentity.first);
+            if (!cards) {
+                ULOG(WARNING) << tfm::format("Identity '%s:%s' is not found in the Virgil Card mirror '%s'.",
+                        cardIdentity.first, identity, mirrorDir);
+                continue;
+            }
+            UVLOG(INFO, (cards->empty() ? 0 : 1)) << tfm::format("Found %d Virgil Card(s) for identity: %s",
+                    cards->size(), identity);
+            purgeCards(*cards, outDir, noFormat);
+        }
+    }
+}
+
 void CardSearchCommand::doProcess() const {
     ULOG1(INFO) << "Read arguments.";
     auto output = getArgumentIO()->getOutput(ArgumentImportance::Optional);
     auto scope = getArgumentIO()->getCardScope(ArgumentImportance::Required);
     auto cardIdentityGroup = getArgumentIO()->getCardIdentityGroup(ArgumentImportance::Required);
+    auto offlineDir = getArgumentIO()->getOfflineCardMirrorDir(ArgumentImportance::Optional);
+    if (!offlineDir.empty()) {
+        if (card_scope_from(scope) != CardScope::application) {
+            throw ArgumentRuntimeError("Offline search is supported for the application scope only.");
+        }
+        ULOG1(INFO) << tfm::format("Search for Virgil Cards in the mirror '%s'.", offlineDir);
+        searchCardsOffline(cardIdentityGroup, offlineDir, output.stringValue(), getArgumentIO()->isNoFormat());
+        return;
+    }
     auto appAccessToken = getArgumentIO()->getAppAccessToken(ArgumentImportance::Required);
     auto noFormat = getArgumentIO()->isNoFormat();
 
-    auto serviceConfig = ServiceConfig::createConfig(appAccessToken.stringValue());
-    serviceConfig.cardValidator(std::make_unique<CardValidator>(std::make_shared<ServiceCrypto>()));
-    Client client(std::move(serviceConfig));
-
-    ULOG1(INFO) << "Start searching for Virgil Cards.";
-    for (const auto& cardIdentity : cardIdentityGroup.identities()) {
-        auto identityType = cardIdentity.first;
-        auto identities = cardIdentity.second;
-        ULOG1(INFO) << tfm::format("Search cards for identities: %s", format_list(identities));
-        auto searchCriteria = SearchCardsCriteria::createCriteria(identities, card_scope_from(scope), identityType);
-        auto cards = client.searchCards(searchCriteria).get();
-        UVLOG(INFO, (cards.empty() ? 0 : 1))
-                << tfm::format("Found %d Virgil Card(s) for identities: %s", cards.size(), format_list(identities));
-        purgeCards(cards, output.stringValue(), noFormat);
-    }
+    auto client = ServiceClient::get(appAccessToken.stringValue());
+    // Batches are searched concurrently, and found cards are written in the order the searches complete.
+    ServiceClient::searchCards(client, cardIdentityGroup, card_scope_from(scope),
+            [&output, noFormat](const ServiceClient::SearchBatch& batch, std::vector<Card>& cards) {
+                UVLOG(INFO, (cards.empty() ? 0 : 1)) << tfm::format("Found %d Virgil Card(s) for identities: %s",
+                        cards.size(), format_list(batch.identities));
+                purgeCards(cards, output.stringValue(), noFormat);
+            });
 }
@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/command/CardSyncCommand.h>
+
+#include <cli/api/api.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/model/CardMirror.h>
+#include <cli/model/ServiceClient.h>
+
+#include <cli/memory.h>
+
+#include <ctime>
+#include <exception>
+#include <map>
+
+using cli::command::CardSyncCommand;
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentParseOptions;
+using cli::model::Card;
+using cli::model::CardIdentityGroup;
+using cli::model::CardMirror;
+using cli::model::CardScope;
+using cli::model::ServiceClient;
+
+const char* CardSyncCommand::doGetName() const {
+    return arg::value::VIRGIL_COMMAND_CARD_SYNC;
+}
+
+const char* CardSyncCommand::doGetUsage() const {
+    return usage::VIRGIL_CARD_SYNC;
+}
+
+ArgumentParseOptions CardSyncCommand::doGetArgumentParseOptions() const {
+    return ArgumentParseOptions().disableOptionsFirst();
+}
+
+void CardSyncCommand::doProcess() const {
+    ULOG1(INFO) << "Read arguments.";
+    auto mirrorDir = getArgumentIO()->getCardMirrorDir(ArgumentImportance::Required);
+    auto cardIdentityGroup = getArgumentIO()->getCardIdentityGroup(ArgumentImportance::Optional);
+    auto maxAge = static_cast<std::time_t>(getArgumentIO()->getMaxAge(ArgumentImportance::Optional));
+    auto appAccessToken = getArgumentIO()->getAppAccessToken(ArgumentImportance::Required);
+
+    CardMirror mirror(mirrorDir);
+    if (cardIdentityGroup.identities().empty()) {
+        ULOG1(INFO) << tfm::format("Synchronize identities of the Virgil Card mirror '%s'.", mirrorDir);
+        cardIdentityGroup = mirror.identities();
+        if (cardIdentityGroup.identities().empty()) {
+            throw error::ArgumentNotFoundError(arg::IDENTITY);
+        }
+    }
+
+    // Identities that were synchronized recently are not requested, so periodic sync of the large mirror
+    // requests only the part of it.
+    const auto now = std::time(nullptr);
+    size_t upToDateCount = 0;
+    size_t requestedCount = 0;
+    CardIdentityGroup requestedIdentityGroup;
+    for (const auto& cardIdentity : cardIdentityGroup.identities()) {
+        for (const auto& identity : cardIdentity.second) {
+            if (maxAge > 0 && now - mirror.syncedAt(identity, cardIdentity.first) < maxAge) {
+                ++upToDateCount;
+            } else {
+                requestedIdentityGroup.append(identity, cardIdentity.first);
+                ++requestedCount;
+            }
+        }
+    }
+
+    ULOG1(INFO) << tfm::format("Request Virgil Cards of %d identities, %d identities are up to date.",
+            requestedCount, upToDateCount);
+    auto client = ServiceClient::get(appAccessToken.stringValue());
+    // Mirror is updated in this thread only, results that are received before an error are kept,
+    // so the next synchronization does not request them again.
+    size_t addedCount = 0;
+    try {
+        ServiceClient::searchCards(client, requestedIdentityGroup, CardScope::application,
+                [&mirror, &addedCount](const ServiceClient::SearchBatch& batch, std::vector<Card>& cards) {
+                    std::map<std::string, std::vector<Card>> identityCards;
+                    for (auto& card : cards) {
+                        identityCards[card.identity()].push_back(std::move(card));
+                    }
+                    for (const auto& identity : batch.identities) {
+                        addedCount += mirror.update(identity, batch.identityType, identityCards[identity]);
+                    }
+                });
+    } catch (...) {
+        try {
+            mirror.commit();
+        } catch (const std::exception& exception) {
+            LOG(WARNING) << exception.what();
+        }
+        throw;
+    }
+    const auto removedCount = mirror.commit();
+    ULOG(INFO) << tfm::format("Virgil Card mirror '%s' is synchronized: %d Virgil Card(s) added, %d removed.",
+            mirrorDir, addedCount, removedCount);
+}
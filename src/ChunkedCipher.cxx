@@ -0,0 +1,389 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/model/ChunkedCipher.h>
+
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/model/KeyEnvelope.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+
+using cli::Crypto;
+using cli::concurrency::ThreadPool;
+using cli::model::ChunkedCipher;
+using cli::model::DecryptCredentials;
+using cli::model::EncryptCredentials;
+using cli::model::FileDataSource;
+using cli::model::KeyEnvelope;
+
+namespace {
+
+constexpr const unsigned char kMagic[] = { 'V', 'C', 'L', 'I', 'C', 'H', 'K', '1' };
+constexpr const size_t kMagicSize = sizeof(kMagic);
+constexpr const size_t kHeaderSize = kMagicSize + 4 + 4;
+constexpr const size_t kEnvelopeSize_Max = 16 * 1024 * 1024; // 16MB
+constexpr const size_t kKeySize = 32;
+constexpr const size_t kNonceSize = 12;
+constexpr const size_t kTagSize = 16;
+constexpr const size_t kPendingChunksPerJob = 2;
+constexpr const uint64_t kIndex_End = std::numeric_limits<uint64_t>::max();
+
+using ChunkProcessor = std::function<Crypto::Bytes(uint64_t index, bool isLast, const Crypto::Bytes& chunk)>;
+
+void appendNumber(Crypto::Bytes& data, uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; --i) {
+        data.push_back(static_cast<unsigned char>(value >> ((i - 1) * 8)));
+    }
+}
+
+uint64_t readNumber(const unsigned char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Splits data of the underlying source to the chunks of the requested size.
+ */
+class ChunkReader {
+public:
+    explicit ChunkReader(Crypto::DataSource& source) : source_(source), buffer_(), offset_(0) {
+    }
+
+    /**
+     * @return Chunk of the given size, or shorter one if underlying source is exhausted.
+     */
+    Crypto::Bytes read(size_t size) {
+        Crypto::Bytes chunk;
+        while (chunk.size() < size) {
+            if (offset_ == buffer_.size()) {
+                if (!source_.hasData()) {
+                    break;
+                }
+                buffer_ = source_.read();
+                offset_ = 0;
+                if (chunk.empty() && buffer_.size() == size) {
+                    chunk.swap(buffer_);
+                    break;
+                }
+                chunk.reserve(size);
+                continue;
+            }
+            const auto count = std::min(size - chunk.size(), buffer_.size() - offset_);
+            chunk.insert(chunk.end(), buffer_.cbegin() + offset_, buffer_.cbegin() + offset_ + count);
+            offset_ += count;
+        }
+        return chunk;
+    }
+
+    /**
+     * @return true if underlying source has no more data.
+     */
+    bool isExhausted() {
+        while (offset_ == buffer_.size()) {
+            if (!source_.hasData()) {
+                return true;
+            }
+            buffer_ = source_.read();
+            offset_ = 0;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Drop data that was read ahead, i.e. when underlying source position was changed.
+     */
+    void reset() {
+        buffer_.clear();
+        offset_ = 0;
+    }
+
+private:
+    Crypto::DataSource& source_;
+    Crypto::Bytes buffer_;
+    size_t offset_;
+};
+
+Crypto::Bytes makeHeader(size_t chunkSize, const Crypto::Bytes& envelope) {
+    Crypto::Bytes header(kMagic, kMagic + kMagicSize);
+    appendNumber(header, chunkSize, 4);
+    appendNumber(header, envelope.size(), 4);
+    header.insert(header.end(), envelope.cbegin(), envelope.cend());
+    return header;
+}
+
+void setupChunkCipher(
+        Crypto::SymmetricCipher& cipher, size_t chunkSize, uint64_t index, bool isLast) {
+    Crypto::Bytes nonce(kNonceSize - 8, 0);
+    appendNumber(nonce, index, 8);
+    Crypto::Bytes authData(kMagic, kMagic + kMagicSize);
+    appendNumber(authData, chunkSize, 4);
+    appendNumber(authData, index, 8);
+    authData.push_back(isLast ? 1 : 0);
+    cipher.setIV(nonce);
+    cipher.reset();
+    cipher.setAuthData(authData);
+}
+
+Crypto::Bytes sealChunk(const Crypto::Bytes& key, size_t chunkSize, uint64_t index, bool isLast,
+        const Crypto::Bytes& chunk) {
+    Crypto::SymmetricCipher cipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM);
+    cipher.setEncryptionKey(key);
+    setupChunkCipher(cipher, chunkSize, index, isLast);
+    auto record = cipher.update(chunk);
+    auto tail = cipher.finish();
+    record.insert(record.end(), tail.cbegin(), tail.cend());
+    return record;
+}
+
+Crypto::Bytes openChunk(const Crypto::Bytes& key, size_t chunkSize, uint64_t index, bool isLast,
+        const Crypto::Bytes& record) {
+    if (record.size() < kTagSize) {
+        throw cli::error::ArgumentRuntimeError("Encrypted data is truncated.");
+    }
+    Crypto::SymmetricCipher cipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM);
+    cipher.setDecryptionKey(key);
+    setupChunkCipher(cipher, chunkSize, index, isLast);
+    auto chunk = cipher.update(record);
+    auto tail = cipher.finish();
+    chunk.insert(chunk.end(), tail.cbegin(), tail.cend());
+    return chunk;
+}
+
+/**
+ * @brief Read chunks of the given size, process them in parallel and write results in the original order.
+ * @param firstIndex - index of the first chunk that is read from the reader.
+ * @param endIndex - processing stops before chunk with this index, or after the last chunk.
+ * @return true - if the last chunk was processed.
+ */
+bool processChunks(size_t jobs, ChunkReader& reader, Crypto::DataSink& sink, size_t chunkSize,
+        uint64_t firstIndex, uint64_t endIndex, const ChunkProcessor& processor) {
+    ThreadPool pool(jobs);
+    const auto maxPendingChunks = pool.size() * kPendingChunksPerJob;
+    DLOG(INFO) << tfm::format("Process chunks of %d bytes with %d thread(s).", chunkSize, pool.size());
+    std::deque<std::future<Crypto::Bytes>> pendingChunks;
+    uint64_t index = firstIndex;
+    bool isLast = false;
+    while (!isLast && index < endIndex) {
+        auto chunk = std::make_shared<Crypto::Bytes>(reader.read(chunkSize));
+        isLast = chunk->size() < chunkSize;
+        pendingChunks.push_back(pool.submit([&processor, chunk, index, isLast]() {
+            return processor(index, isLast, *chunk);
+        }));
+        ++index;
+        const bool isEnd = isLast || index == endIndex;
+        while (!pendingChunks.empty() && (isEnd || pendingChunks.size() >= maxPendingChunks)) {
+            sink.write(pendingChunks.front().get());
+            pendingChunks.pop_front();
+            if (!sink.isGood()) {
+                throw cli::error::ArgumentRuntimeError("Failed to write output data.");
+            }
+        }
+    }
+    return isLast;
+}
+
+/**
+ * @brief Check that nothing follows the last record, so appended data is not silently ignored.
+ * @throw ArgumentRuntimeError - if reader has data after the last record.
+ */
+void checkNoTrailingData(ChunkReader& reader) {
+    if (!reader.isExhausted()) {
+        throw cli::error::ArgumentRuntimeError("Encrypted data contains unexpected data after the last chunk.");
+    }
+}
+
+ChunkedCipher::Header parseHeader(ChunkReader& reader) {
+    const auto header = reader.read(kHeaderSize);
+    if (header.size() < kHeaderSize || !ChunkedCipher::isChunked(header)) {
+        throw cli::error::ArgumentRuntimeError("Encrypted data is not in the chunked format.");
+    }
+    const auto chunkSize = readNumber(header.data() + kMagicSize, 4);
+    const auto envelopeSize = readNumber(header.data() + kMagicSize + 4, 4);
+    if (chunkSize == 0 || chunkSize > ChunkedCipher::kChunkSize_Max ||
+            envelopeSize == 0 || envelopeSize > kEnvelopeSize_Max) {
+        throw cli::error::ArgumentRuntimeError("Encrypted data has malformed header.");
+    }
+    auto envelope = reader.read(envelopeSize);
+    if (envelope.size() < envelopeSize) {
+        throw cli::error::ArgumentRuntimeError("Encrypted data is truncated.");
+    }
+    return ChunkedCipher::Header{ chunkSize, std::move(envelope) };
+}
+
+}
+
+size_t ChunkedCipher::Header::size() const {
+    return kHeaderSize + envelope.size();
+}
+
+ChunkedCipher::ChunkedCipher(size_t jobs) : jobs_(jobs) {
+}
+
+bool ChunkedCipher::isChunked(const Crypto::Bytes& data) {
+    return data.size() >= kMagicSize && std::equal(kMagic, kMagic + kMagicSize, data.cbegin());
+}
+
+ChunkedCipher::Header ChunkedCipher::readHeader(Crypto::DataSource& source) {
+    ChunkReader reader(source);
+    return parseHeader(reader);
+}
+
+void ChunkedCipher::encrypt(
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients,
+        Crypto::DataSource& source, Crypto::DataSink& sink, size_t chunkSize) const {
+    if (chunkSize == 0 || chunkSize > kChunkSize_Max) {
+        throw error::ArgumentLogicError("ChunkedCipher: invalid chunk size.");
+    }
+    Crypto::Random random(Crypto::ByteUtils::stringToBytes("virgil-cli-chunked"));
+    const auto key = random.randomize(kKeySize);
+
+    sink.write(makeHeader(chunkSize, KeyEnvelope::wrap(recipients, key, jobs_)));
+
+    ChunkReader reader(source);
+    processChunks(jobs_, reader, sink, chunkSize, 0, kIndex_End,
+            [&key, chunkSize](uint64_t index, bool isLast, const Crypto::Bytes& chunk) {
+                return sealChunk(key, chunkSize, index, isLast, chunk);
+            });
+}
+
+bool ChunkedCipher::decrypt(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& recipients,
+        Crypto::DataSource& source, Crypto::DataSink& sink) const {
+    ChunkReader reader(source);
+    const auto header = parseHeader(reader);
+    const auto key = KeyEnvelope::unwrap(recipients, header.envelope, kKeySize);
+    if (key.empty()) {
+        return false;
+    }
+    const auto chunkSize = header.chunkSize;
+    processChunks(jobs_, reader, sink, chunkSize + kTagSize, 0, kIndex_End,
+            [&key, chunkSize](uint64_t index, bool isLast, const Crypto::Bytes& record) {
+                return openChunk(key, chunkSize, index, isLast, record);
+            });
+    checkNoTrailingData(reader);
+    return true;
+}
+
+bool ChunkedCipher::rekey(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& credentials,
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients,
+        Crypto::DataSource& source, Crypto::DataSink& sink) const {
+    if (recipients.empty()) {
+        throw error::ArgumentLogicError("ChunkedCipher: recipients are not defined.");
+    }
+    ChunkReader reader(source);
+    const auto header = parseHeader(reader);
+    const auto key = KeyEnvelope::unwrap(credentials, header.envelope, kKeySize);
+    if (key.empty()) {
+        return false;
+    }
+    sink.write(makeHeader(header.chunkSize, KeyEnvelope::wrap(recipients, key, jobs_)));
+    // Chunks are authenticated independently of the envelope, so they are valid with the new header.
+    const auto recordSize = header.chunkSize + kTagSize;
+    for (auto record = reader.read(recordSize); !record.empty(); record = reader.read(recordSize)) {
+        sink.write(record);
+        if (!sink.isGood()) {
+            throw error::ArgumentRuntimeError("Failed to write output data.");
+        }
+    }
+    return true;
+}
+
+bool ChunkedCipher::decryptRange(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& recipients,
+        FileDataSource& source, Crypto::DataSink& sink, size_t offset, size_t length) const {
+    ChunkReader reader(source);
+    const auto header = parseHeader(reader);
+    const auto key = KeyEnvelope::unwrap(recipients, header.envelope, kKeySize);
+    if (key.empty()) {
+        return false;
+    }
+    if (length == 0) {
+        return true;
+    }
+    const uint64_t chunkSize = header.chunkSize;
+    const uint64_t recordSize = chunkSize + kTagSize;
+    const uint64_t end = length > kIndex_End - offset ? kIndex_End : offset + length;
+    const uint64_t firstIndex = offset / chunkSize;
+    const uint64_t endIndex = (end - 1) / chunkSize + 1;
+
+    if (source.isSeekable()) {
+        const auto recordOffset = header.size() + firstIndex * recordSize;
+        if (firstIndex > source.size() / recordSize || recordOffset >= source.size()) {
+            // Requested range starts after the end of data.
+            return true;
+        }
+        DLOG(INFO) << tfm::format("Seek to the chunk %d at offset %d.", firstIndex, recordOffset);
+        source.seek(recordOffset);
+        reader.reset();
+    } else {
+        DLOG(INFO) << tfm::format("Skip %d chunk(s) of the input data.", firstIndex);
+        for (uint64_t index = 0; index < firstIndex; ++index) {
+            if (reader.read(recordSize).size() < recordSize) {
+                // Requested range starts after the end of data.
+                return true;
+            }
+        }
+    }
+
+    const bool isLastProcessed = processChunks(jobs_, reader, sink, recordSize, firstIndex, endIndex,
+            [&key, chunkSize, offset, end](uint64_t index, bool isLast, const Crypto::Bytes& record) -> Crypto::Bytes {
+                auto chunk = openChunk(key, chunkSize, index, isLast, record);
+                const uint64_t chunkOffset = index * chunkSize;
+                const auto rangeBegin =
+                        offset > chunkOffset ? std::min<uint64_t>(offset - chunkOffset, chunk.size()) : 0;
+                const auto rangeEnd = std::min<uint64_t>(end - chunkOffset, chunk.size());
+                if (rangeBegin == 0 && rangeEnd == chunk.size()) {
+                    return chunk;
+                }
+                return Crypto::Bytes(chunk.cbegin() + rangeBegin, chunk.cbegin() + rangeEnd);
+            });
+    if (isLastProcessed) {
+        checkNoTrailingData(reader);
+    }
+    return true;
+}
@@ -0,0 +1,125 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/model/ContentInfo.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <virgil/crypto/foundation/cms/VirgilCMSContentInfo.h>
+#include <virgil/crypto/foundation/cms/VirgilCMSEnvelopedData.h>
+#include <virgil/crypto/VirgilCryptoException.h>
+
+#include <algorithm>
+
+using cli::Crypto;
+using cli::model::ContentInfo;
+using virgil::crypto::foundation::cms::VirgilCMSContentInfo;
+using virgil::crypto::foundation::cms::VirgilCMSContentType;
+using virgil::crypto::foundation::cms::VirgilCMSEnvelopedData;
+using virgil::crypto::VirgilCryptoException;
+
+ContentInfo::ContentInfo(const Crypto::Bytes& contentInfo)
+        : keyRecipientIds_(), passwordRecipientCount_(0), dataCipherName_() {
+    VirgilCMSContentInfo cmsContentInfo;
+    cmsContentInfo.fromAsn1(contentInfo);
+    if (cmsContentInfo.cmsContent.contentType != VirgilCMSContentType::EnvelopedData) {
+        throw error::ArgumentRuntimeError("Content info does not describe encrypted data.");
+    }
+    VirgilCMSEnvelopedData envelopedData;
+    envelopedData.fromAsn1(cmsContentInfo.cmsContent.content);
+    keyRecipientIds_.reserve(envelopedData.keyTransRecipients.size());
+    for (const auto& recipient : envelopedData.keyTransRecipients) {
+        keyRecipientIds_.emplace(recipient.recipientIdentifier.cbegin(), recipient.recipientIdentifier.cend());
+    }
+    passwordRecipientCount_ = envelopedData.passwordRecipients.size();
+    try {
+        Crypto::SymmetricCipher dataCipher;
+        dataCipher.fromAsn1(envelopedData.encryptedContent.contentEncryptionAlgorithm);
+        dataCipherName_ = dataCipher.name();
+    } catch (const VirgilCryptoException& exception) {
+        DLOG(INFO) << "Data encryption algorithm is not recognized: " << exception.what();
+    }
+    DLOG(INFO) << tfm::format("Content info has %d key recipient(s) and %d password recipient(s).",
+            keyRecipientIds_.size(), passwordRecipientCount_);
+}
+
+ContentInfo ContentInfo::readEmbedded(Crypto::Bytes& head, Crypto::DataSource& source) {
+    const auto contentInfoSize = Crypto::CipherBase::defineContentInfoSize(head);
+    if (contentInfoSize == 0) {
+        throw error::ArgumentRuntimeError(
+                "Content info is not embedded to the encrypted data, use --content-info option.");
+    }
+    while (head.size() < contentInfoSize && source.hasData()) {
+        const auto chunk = source.read();
+        head.insert(head.end(), chunk.cbegin(), chunk.cend());
+    }
+    if (head.size() < contentInfoSize) {
+        throw error::ArgumentRuntimeError("Encrypted data is truncated.");
+    }
+    return ContentInfo(Crypto::Bytes(head.cbegin(), head.cbegin() + contentInfoSize));
+}
+
+bool ContentInfo::hasKeyRecipient(const Crypto::Bytes& recipientId) const {
+    return keyRecipientIds_.find(std::string(recipientId.cbegin(), recipientId.cend())) != keyRecipientIds_.cend();
+}
+
+bool ContentInfo::hasPasswordRecipient() const {
+    return passwordRecipientCount_ > 0;
+}
+
+size_t ContentInfo::keyRecipientCount() const {
+    return keyRecipientIds_.size();
+}
+
+size_t ContentInfo::passwordRecipientCount() const {
+    return passwordRecipientCount_;
+}
+
+std::vector<Crypto::Bytes> ContentInfo::keyRecipientIds() const {
+    std::vector<Crypto::Bytes> result;
+    result.reserve(keyRecipientIds_.size());
+    for (const auto& recipientId : keyRecipientIds_) {
+        result.emplace_back(recipientId.cbegin(), recipientId.cend());
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+std::string ContentInfo::dataCipherName() const {
+    return dataCipherName_;
+}
@@ -0,0 +1,121 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/command/ContentInfoCommand.h>
+
+#include <cli/api/api.h>
+#include <cli/api/Engine.h>
+#include <cli/crypto/Crypto.h>
+#include <cli/io/Logger.h>
+#include <cli/formatter/KeyValueFormatter.h>
+
+#include <algorithm>
+#include <cctype>
+
+using cli::Crypto;
+using cli::Engine;
+using cli::EncryptedDataInfo;
+using cli::command::ContentInfoCommand;
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentParseOptions;
+using cli::formatter::KeyValueFormatter;
+
+const char* ContentInfoCommand::doGetName() const {
+    return arg::value::VIRGIL_COMMAND_CONTENT_INFO;
+}
+
+const char* ContentInfoCommand::doGetUsage() const {
+    return usage::VIRGIL_CONTENT_INFO;
+}
+
+ArgumentParseOptions ContentInfoCommand::doGetArgumentParseOptions() const {
+    return ArgumentParseOptions().disableOptionsFirst();
+}
+
+static std::string format_name(EncryptedDataInfo::Format format) {
+    switch (format) {
+        case EncryptedDataInfo::Format::Default:
+            return "default";
+        case EncryptedDataInfo::Format::Chunked:
+            return "chunked";
+        case EncryptedDataInfo::Format::SessionHeader:
+            return "session header";
+        case EncryptedDataInfo::Format::SessionMessage:
+            return "session message";
+    }
+    return "unknown";
+}
+
+static std::string recipient_id_to_string(const Crypto::Bytes& recipientId) {
+    // Identifiers of the Virgil Cards and aliases are printable, derived identifiers are binary.
+    const bool isPrintable = !recipientId.empty() && std::all_of(recipientId.cbegin(), recipientId.cend(),
+            [](unsigned char symbol) { return std::isprint(symbol) != 0; });
+    return isPrintable ? Crypto::ByteUtils::bytesToString(recipientId) : Crypto::ByteUtils::bytesToHex(recipientId);
+}
+
+void ContentInfoCommand::doProcess() const {
+    ULOG1(INFO) << "Read parameters.";
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    EncryptedDataInfo info;
+    if (getArgumentIO()->hasContentInfo()) {
+        info = Engine::inspect(getArgumentIO()->getContentInfoSource(ArgumentImportance::Required).readAll());
+    } else {
+        auto input = getArgumentIO()->getInputHeadSource(ArgumentImportance::Optional);
+        info = Engine::inspect(input);
+    }
+
+    ULOG1(INFO) << "Write content info to the output.";
+    KeyValueFormatter::Container values;
+    values.emplace_back("format", format_name(info.format));
+    values.emplace_back("data cipher", info.dataCipher.empty() ? "unknown" : info.dataCipher);
+    if (info.format == EncryptedDataInfo::Format::Chunked) {
+        values.emplace_back("chunk size", std::to_string(info.chunkSize));
+    }
+    if (!info.sessionId.empty()) {
+        values.emplace_back("session id", Crypto::ByteUtils::bytesToHex(info.sessionId));
+    }
+    if (info.contentInfoSize > 0) {
+        values.emplace_back("content info size", std::to_string(info.contentInfoSize));
+    }
+    for (const auto& recipientId : info.keyRecipientIds) {
+        values.emplace_back("recipient (key)", recipient_id_to_string(recipientId));
+    }
+    if (info.passwordRecipientCount > 0) {
+        values.emplace_back("password recipients", std::to_string(info.passwordRecipientCount));
+    }
+    output.write(KeyValueFormatter().format(values));
+    output.flush();
+}
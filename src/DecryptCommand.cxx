@@ -37,16 +37,24 @@
 #include <cli/command/DecryptCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/api/Engine.h>
+#include <cli/concurrency/FileJobRunner.h>
 #include <cli/crypto/Crypto.h>
 #include <cli/io/Logger.h>
 #include <cli/error/ArgumentError.h>
 
 using cli::Crypto;
+using cli::Engine;
+using cli::DecryptOptions;
 using cli::command::DecryptCommand;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentSource;
 using cli::argument::ArgumentParseOptions;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
+using cli::model::DecryptCredentials;
+using cli::model::SessionCipher;
 
 const char* DecryptCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_DECRYPT;
@@ -61,28 +69,82 @@ ArgumentParseOptions DecryptCommand::doGetArgumentParseOptions() const {
 }
 
 void DecryptCommand::doProcess() const {
+    if (getArgumentIO()->isMultiFile()) {
+        processFiles();
+        return;
+    }
     ULOG1(INFO)  << "Read parameters.";
     auto input = getArgumentIO()->getInputSource(ArgumentImportance::Optional);
     auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
     bool hasContentInfo = getArgumentIO()->hasContentInfo();
-    auto recipients = getArgumentIO()->getDecryptCredentials(ArgumentImportance::Required);
+    DecryptOptions options;
+    options.recipients = getArgumentIO()->getDecryptCredentials(ArgumentImportance::Required);
+    options.jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+
+    if (getArgumentIO()->hasDataRange()) {
+        if (hasContentInfo) {
+            throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+        }
+        if (getArgumentIO()->hasSession()) {
+            throw error::ArgumentNotAllowedError(opt::SESSION);
+        }
+        const auto offset = getArgumentIO()->getDataOffset(ArgumentImportance::Optional);
+        const auto length = getArgumentIO()->getDataLength(ArgumentImportance::Optional);
+        Engine::decryptRange(options, input, output, offset, length);
+        return;
+    }
 
-    Crypto::StreamCipher cipher;
     if (hasContentInfo) {
-        auto contentInfo = getArgumentIO()->getContentInfoSource(ArgumentImportance::Required).readAll();
-        ULOG1(INFO)  << "Set content info.";
-        cipher.setContentInfo(contentInfo);
+        options.contentInfo = getArgumentIO()->getContentInfoSource(ArgumentImportance::Required).readAll();
+    }
+    if (getArgumentIO()->hasSession()) {
+        options.session = openSession(options.recipients);
     }
+    options.isPipelined = getArgumentIO()->isPipelined(input);
 
-    ULOG1(INFO)  << "Decrypt and write to the output.";
-    bool decrypted = false;
-    for (const auto& recipient : recipients) {
-        decrypted = recipient->decrypt(cipher, input, output);
-        if (decrypted){
-            break;
-        }
+    Engine::decrypt(options, input, output);
+}
+
+void DecryptCommand::processFiles() const {
+    ULOG1(INFO) << "Read parameters.";
+    if (getArgumentIO()->hasContentInfo()) {
+        throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+    }
+    if (getArgumentIO()->hasDataRange()) {
+        throw error::ArgumentNotAllowedError(getArgumentIO()->getDataOffset(ArgumentImportance::Optional) > 0 ?
+                opt::OFFSET : opt::LENGTH);
     }
-    if (!decrypted) {
+    auto fileJobs = getArgumentIO()->getFileJobs(true, ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    // Recipients are resolved once and shared by all files, each file is decrypted by its own cipher.
+    // Files are processed concurrently, so each file is processed by the single thread.
+    DecryptOptions options;
+    options.recipients = getArgumentIO()->getDecryptCredentials(ArgumentImportance::Required);
+    options.jobs = 1;
+    if (getArgumentIO()->hasSession()) {
+        // Data key is decrypted once, and then each file is decrypted as the message of the session.
+        options.session = openSession(options.recipients);
+    }
+
+    ULOG1(INFO) << tfm::format("Decrypt %d file(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, true).run(fileJobs, [this, &options](const FileJob& fileJob) {
+        auto input = getArgumentIO()->getFileSource(fileJob.inputFile);
+        auto output = getArgumentIO()->getFileSink(fileJob.outputFile);
+        Engine::decrypt(options, input, output);
+    });
+    if (failedCount > 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Decryption failed for %d of %d file(s).", failedCount, fileJobs.size()));
+    }
+}
+
+std::shared_ptr<const SessionCipher> DecryptCommand::openSession(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& recipients) const {
+    auto sessionPath = getArgumentIO()->getSessionPath(ArgumentImportance::Required);
+    ULOG1(INFO) << "Open the session.";
+    auto session = SessionCipher::open(recipients, getArgumentIO()->getFileSource(sessionPath).readAll());
+    if (!session) {
         throw error::ArgumentRecipientDecryptionError();
     }
+    return session;
 }
@@ -36,8 +36,13 @@
 
 #include <cli/model/DecryptCredentials.h>
 
+using cli::model::ContentInfo;
 using cli::model::DecryptCredentials;
 
+bool DecryptCredentials::isRecipientOf(const ContentInfo& contentInfo) const {
+    return doIsRecipientOf(contentInfo);
+}
+
 bool DecryptCredentials::decrypt(
         Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const {
     return doDecrypt(cipher, source, sink);
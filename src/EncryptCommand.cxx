@@ -37,16 +37,50 @@
 #include <cli/command/EncryptCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/api/Engine.h>
+#include <cli/concurrency/FileJobRunner.h>
 #include <cli/crypto/Crypto.h>
 #include <cli/io/Logger.h>
+#include <cli/io/Path.h>
 #include <cli/error/ArgumentError.h>
+#include <cli/memory.h>
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
 
 using cli::Crypto;
+using cli::Engine;
+using cli::EncryptOptions;
 using cli::command::EncryptCommand;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentSource;
 using cli::argument::ArgumentParseOptions;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
+using cli::model::FileDataSink;
+using cli::model::SessionCipher;
+
+namespace {
+
+/**
+ * @brief Return mutex that serializes start and continuation of the session with the given header path.
+ * @note Concurrent commands of the same process (i.e. batch jobs) must not both start the session.
+ */
+std::mutex& session_mutex(const std::string& sessionPath) {
+    static std::mutex registryMutex;
+    static std::map<std::string, std::unique_ptr<std::mutex>> registry;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& sessionMutex = registry[sessionPath];
+    if (!sessionMutex) {
+        sessionMutex = std::make_unique<std::mutex>();
+    }
+    return *sessionMutex;
+}
+
+}
 
 const char* EncryptCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_ENCRYPT;
@@ -61,28 +95,99 @@ ArgumentParseOptions EncryptCommand::doGetArgumentParseOptions() const {
 }
 
 void EncryptCommand::doProcess() const {
+    if (getArgumentIO()->isMultiFile()) {
+        processFiles();
+        return;
+    }
     ULOG1(INFO) << "Read parameters.";
     auto input = getArgumentIO()->getInputSource(ArgumentImportance::Optional);
     auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
-    auto encryptCredentials = getArgumentIO()->getEncryptCredentials(ArgumentImportance::Required);
-    bool doWriteContentInfo = getArgumentIO()->hasContentInfo();
-    bool embedContentInfo = !doWriteContentInfo;
-
-    if (encryptCredentials.empty()) {
-        throw error::ArgumentRuntimeError("Encryption terminated. Any of the given recipients cannot be used.");
+    EncryptOptions options;
+    if (getArgumentIO()->hasSession()) {
+        if (getArgumentIO()->hasContentInfo()) {
+            throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+        }
+        options.session = getSession();
+        options.isPipelined = getArgumentIO()->isPipelined(input);
+        Engine::encrypt(options, input, output);
+        return;
+    }
+    options.recipients = getArgumentIO()->getEncryptCredentials(ArgumentImportance::Required);
+    options.isChunked = getArgumentIO()->isChunked();
+    options.isPipelined = getArgumentIO()->isPipelined(input);
+    if (options.isChunked) {
+        options.chunkSize = getArgumentIO()->getIOBufferSize();
+        options.jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    }
+    std::unique_ptr<FileDataSink> contentInfoSink;
+    if (getArgumentIO()->hasContentInfo()) {
+        if (options.isChunked) {
+            throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+        }
+        contentInfoSink = std::make_unique<FileDataSink>(
+                getArgumentIO()->getContentInfoSink(ArgumentImportance::Required));
+        options.contentInfoSink = contentInfoSink.get();
     }
 
-    ULOG1(INFO) << "Add recipients.";
-    Crypto::StreamCipher cipher;
-    for (const auto& credential : encryptCredentials) {
-        credential->addSelfTo(cipher);
+    Engine::encrypt(options, input, output);
+}
+
+void EncryptCommand::processFiles() const {
+    ULOG1(INFO) << "Read parameters.";
+    if (getArgumentIO()->hasContentInfo()) {
+        throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+    }
+    auto fileJobs = getArgumentIO()->getFileJobs(false, ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    // Recipients are resolved once and shared by all files, each file is encrypted by its own cipher.
+    // Files are processed concurrently, so each file is processed by the single thread.
+    EncryptOptions options;
+    if (getArgumentIO()->hasSession()) {
+        // Data key is encrypted for the recipients once, and each file becomes the message of the session.
+        options.session = getSession();
+    } else {
+        options.recipients = getArgumentIO()->getEncryptCredentials(ArgumentImportance::Required);
+        options.isChunked = getArgumentIO()->isChunked();
+        options.chunkSize = getArgumentIO()->getIOBufferSize();
     }
+    options.jobs = 1;
 
-    ULOG1(INFO) << "Encrypt data and write to the output.";
-    cipher.encrypt(input, output, embedContentInfo);
+    ULOG1(INFO) << tfm::format("Encrypt %d file(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, true).run(fileJobs, [this, &options](const FileJob& fileJob) {
+        auto input = getArgumentIO()->getFileSource(fileJob.inputFile);
+        auto output = getArgumentIO()->getFileSink(fileJob.outputFile);
+        Engine::encrypt(options, input, output);
+    });
+    if (failedCount > 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Encryption failed for %d of %d file(s).", failedCount, fileJobs.size()));
+    }
+}
 
-    if (doWriteContentInfo) {
-        ULOG1(INFO) << "Write content info.";
-        getArgumentIO()->getContentInfoSink(ArgumentImportance::Required).write(cipher.getContentInfo());
+std::shared_ptr<const SessionCipher> EncryptCommand::getSession() const {
+    auto sessionPath = getArgumentIO()->getSessionPath(ArgumentImportance::Required);
+    std::lock_guard<std::mutex> lock(session_mutex(sessionPath));
+    if (io::Path::existsFile(sessionPath)) {
+        ULOG1(INFO) << "Continue the session.";
+        auto session = SessionCipher::find(getArgumentIO()->getFileSource(sessionPath).readAll());
+        if (!session) {
+            throw error::ArgumentRuntimeError(tfm::format(
+                    "Session key of '%s' is not available, session can be continued only by the process "
+                    "that started it.", sessionPath));
+        }
+        return session;
+    }
+    ULOG1(INFO) << "Start new session.";
+    auto session = SessionCipher::start(getArgumentIO()->getEncryptCredentials(ArgumentImportance::Required));
+    ULOG1(INFO) << "Write session header.";
+    try {
+        auto sessionSink = getArgumentIO()->getFileSink(sessionPath);
+        sessionSink.write(session->header());
+        sessionSink.flush();
+    } catch (const error::ArgumentRuntimeError&) {
+        // Partially written header can not be continued, so it is removed to let the session be started again.
+        (void)std::remove(sessionPath.c_str());
+        throw;
     }
+    return session;
 }
@@ -0,0 +1,371 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/api/Engine.h>
+
+#include <cli/api/api.h>
+#include <cli/io/Logger.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/model/ChunkedCipher.h>
+#include <cli/model/ContentInfo.h>
+#include <cli/model/FileDataSink.h>
+#include <cli/model/KeyEnvelope.h>
+#include <cli/model/PipelinedDataSource.h>
+#include <cli/model/PipelinedDataSink.h>
+#include <cli/model/PrefixedDataSource.h>
+
+#include <virgil/crypto/VirgilCryptoException.h>
+
+#include <cli/memory.h>
+
+#include <algorithm>
+
+using cli::Crypto;
+using cli::Engine;
+using cli::EncryptOptions;
+using cli::DecryptOptions;
+using cli::EncryptedDataInfo;
+using cli::RekeyOptions;
+using cli::SignOptions;
+using cli::VerifyOptions;
+using cli::model::ChunkedCipher;
+using cli::model::ContentInfo;
+using cli::model::DecryptCredentials;
+using cli::model::FileDataSink;
+using cli::model::FileDataSource;
+using cli::model::KeyEnvelope;
+using cli::model::PipelinedDataSource;
+using cli::model::PipelinedDataSink;
+using cli::model::PrefixedDataSource;
+using cli::model::SessionCipher;
+using virgil::crypto::VirgilCryptoException;
+
+namespace {
+
+void describeRecipients(EncryptedDataInfo& info, const ContentInfo& contentInfo) {
+    info.keyRecipientIds = contentInfo.keyRecipientIds();
+    info.passwordRecipientCount = contentInfo.passwordRecipientCount();
+}
+
+/**
+ * @brief Describe recipients of the data key envelope, that is used by the chunked format and sessions.
+ */
+void describeEnvelope(EncryptedDataInfo& info, const Crypto::Bytes& envelope) {
+    info.contentInfoSize = 0;
+    for (const auto& contentInfoData : KeyEnvelope::readContentInfos(envelope)) {
+        const ContentInfo contentInfo(contentInfoData);
+        const auto recipientIds = contentInfo.keyRecipientIds();
+        info.keyRecipientIds.insert(info.keyRecipientIds.end(), recipientIds.cbegin(), recipientIds.cend());
+        info.passwordRecipientCount += contentInfo.passwordRecipientCount();
+        info.contentInfoSize += contentInfoData.size();
+    }
+    std::sort(info.keyRecipientIds.begin(), info.keyRecipientIds.end());
+    info.dataCipher = Crypto::SymmetricCipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM).name();
+}
+
+/**
+ * @brief Write buffered data of the sink to the destination and check that nothing was lost.
+ *
+ * Flush in the sink destructor is a fallback only, it can not report an error.
+ *
+ * @throw error::ArgumentRuntimeError - if output was not written completely, i.e. disk is full or pipe is closed.
+ */
+void finishOutput(Crypto::DataSink& sink) {
+    auto fileSink = dynamic_cast<FileDataSink*>(&sink);
+    if (fileSink) {
+        fileSink->flush();
+        return;
+    }
+    if (!sink.isGood()) {
+        throw cli::error::ArgumentRuntimeError(
+                "Output was not written completely, i.e. disk is full or output pipe is closed.");
+    }
+}
+
+}
+
+void Engine::encrypt(const EncryptOptions& options, Crypto::DataSource& source, Crypto::DataSink& sink) {
+    const bool doWriteContentInfo = options.contentInfoSink != nullptr;
+    const bool embedContentInfo = !doWriteContentInfo;
+
+    if (options.session) {
+        if (options.isChunked) {
+            throw error::ArgumentNotAllowedError(opt::CHUNKED);
+        }
+        if (doWriteContentInfo) {
+            throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+        }
+        if (options.isPipelined) {
+            ULOG1(INFO) << "Encrypt data as the session message and write to the output (pipelined).";
+            PipelinedDataSource pipelinedInput(source);
+            PipelinedDataSink pipelinedOutput(sink);
+            options.session->encrypt(pipelinedInput, pipelinedOutput);
+            pipelinedOutput.finish();
+        } else {
+            ULOG1(INFO) << "Encrypt data as the session message and write to the output.";
+            options.session->encrypt(source, sink);
+        }
+        finishOutput(sink);
+        return;
+    }
+
+    if (options.recipients.empty()) {
+        throw error::ArgumentRuntimeError("Encryption terminated. Any of the given recipients cannot be used.");
+    }
+
+    if (options.isChunked) {
+        if (doWriteContentInfo) {
+            throw error::ArgumentNotAllowedError(opt::CONTENT_INFO);
+        }
+        ChunkedCipher cipher(options.jobs);
+        if (options.isPipelined) {
+            ULOG1(INFO) << "Encrypt data in chunks and write to the output (pipelined).";
+            PipelinedDataSource pipelinedInput(source);
+            PipelinedDataSink pipelinedOutput(sink);
+            cipher.encrypt(options.recipients, pipelinedInput, pipelinedOutput, options.chunkSize);
+            pipelinedOutput.finish();
+        } else {
+            ULOG1(INFO) << "Encrypt data in chunks and write to the output.";
+            cipher.encrypt(options.recipients, source, sink, options.chunkSize);
+        }
+        finishOutput(sink);
+        return;
+    }
+
+    ULOG1(INFO) << "Add recipients.";
+    Crypto::StreamCipher cipher;
+    for (const auto& credential : options.recipients) {
+        credential->addSelfTo(cipher);
+    }
+
+    if (options.isPipelined) {
+        ULOG1(INFO) << "Encrypt data and write to the output (pipelined).";
+        PipelinedDataSource pipelinedInput(source);
+        PipelinedDataSink pipelinedOutput(sink);
+        cipher.encrypt(pipelinedInput, pipelinedOutput, embedContentInfo);
+        pipelinedOutput.finish();
+    } else {
+        ULOG1(INFO) << "Encrypt data and write to the output.";
+        cipher.encrypt(source, sink, embedContentInfo);
+    }
+    finishOutput(sink);
+
+    if (doWriteContentInfo) {
+        ULOG1(INFO) << "Write content info.";
+        options.contentInfoSink->write(cipher.getContentInfo());
+        finishOutput(*options.contentInfoSink);
+    }
+}
+
+void Engine::decrypt(const DecryptOptions& options, Crypto::DataSource& input, Crypto::DataSink& output) {
+    const bool hasContentInfo = !options.contentInfo.empty();
+
+    std::unique_ptr<PipelinedDataSource> pipelinedInput;
+    std::unique_ptr<PipelinedDataSink> pipelinedOutput;
+    if (options.isPipelined) {
+        ULOG1(INFO)  << "Decrypt and write to the output (pipelined).";
+        pipelinedInput = std::make_unique<PipelinedDataSource>(input);
+        pipelinedOutput = std::make_unique<PipelinedDataSink>(output);
+    } else {
+        ULOG1(INFO)  << "Decrypt and write to the output.";
+    }
+    Crypto::DataSource& source = pipelinedInput ? static_cast<Crypto::DataSource&>(*pipelinedInput) : input;
+    Crypto::DataSink& sink = pipelinedOutput ? static_cast<Crypto::DataSink&>(*pipelinedOutput) : output;
+
+    if (options.session) {
+        ULOG1(INFO)  << "Decrypt the session message.";
+        options.session->decrypt(source, sink);
+        if (pipelinedOutput) {
+            pipelinedOutput->finish();
+        }
+        finishOutput(output);
+        return;
+    }
+
+    ULOG1(INFO)  << "Detect encrypted data format.";
+    auto head = source.hasData() ? source.read() : Crypto::Bytes();
+    bool decrypted = false;
+    if (SessionCipher::isMessage(head)) {
+        throw error::ArgumentRuntimeError("Encrypted data is the session message, session header should be given.");
+    }
+    if (!hasContentInfo && ChunkedCipher::isChunked(head)) {
+        ULOG1(INFO)  << "Decrypt data in chunks.";
+        ChunkedCipher chunkedCipher(options.jobs);
+        PrefixedDataSource chunkedSource(std::move(head), source);
+        decrypted = chunkedCipher.decrypt(options.recipients, chunkedSource, sink);
+    } else {
+        ULOG1(INFO)  << "Match recipients with the content info.";
+        const auto parsedContentInfo =
+                hasContentInfo ? ContentInfo(options.contentInfo) : ContentInfo::readEmbedded(head, source);
+        std::vector<const DecryptCredentials*> matchedRecipients;
+        for (const auto& recipient : options.recipients) {
+            if (recipient->isRecipientOf(parsedContentInfo)) {
+                matchedRecipients.push_back(recipient.get());
+            }
+        }
+        ULOG2(INFO) << tfm::format("Found %d matching recipient(s).", matchedRecipients.size());
+        for (size_t i = 0; i < matchedRecipients.size() && !decrypted; ++i) {
+            const bool isLastRecipient = i + 1 == matchedRecipients.size();
+            Crypto::StreamCipher cipher;
+            if (hasContentInfo) {
+                cipher.setContentInfo(options.contentInfo);
+            }
+            PrefixedDataSource recipientSource(isLastRecipient ? std::move(head) : head, source);
+            try {
+                decrypted = matchedRecipients[i]->decrypt(cipher, recipientSource, sink);
+            } catch (const VirgilCryptoException&) {
+                // Wrong password is detected before the data behind the head is read,
+                // so next recipient can start from the same position.
+                if (isLastRecipient || recipientSource.isSourceRead()) {
+                    throw;
+                }
+                ULOG2(INFO) << "Recipient does not match, try next one.";
+            }
+        }
+    }
+    if (pipelinedOutput) {
+        pipelinedOutput->finish();
+    }
+    if (!decrypted) {
+        throw error::ArgumentRecipientDecryptionError();
+    }
+    finishOutput(output);
+}
+
+void Engine::decryptRange(
+        const DecryptOptions& options, FileDataSource& source, Crypto::DataSink& sink, size_t offset, size_t length) {
+    ULOG1(INFO)  << "Decrypt requested range of the chunked data and write to the output.";
+    ChunkedCipher chunkedCipher(options.jobs);
+    if (!chunkedCipher.decryptRange(options.recipients, source, sink, offset, length)) {
+        throw error::ArgumentRecipientDecryptionError();
+    }
+    finishOutput(sink);
+}
+
+void Engine::rekey(const RekeyOptions& options, Crypto::DataSource& source, Crypto::DataSink& sink) {
+    if (options.recipients.empty()) {
+        throw error::ArgumentRuntimeError("Re-key terminated. Any of the given recipients cannot be used.");
+    }
+    ULOG1(INFO) << "Detect encrypted data format.";
+    auto head = source.hasData() ? source.read() : Crypto::Bytes();
+    if (ChunkedCipher::isChunked(head)) {
+        ULOG1(INFO) << "Replace recipients of the chunked data and write to the output.";
+        PrefixedDataSource chunkedSource(std::move(head), source);
+        if (!ChunkedCipher(1).rekey(options.credentials, options.recipients, chunkedSource, sink)) {
+            throw error::ArgumentRecipientDecryptionError();
+        }
+        finishOutput(sink);
+    } else if (SessionCipher::isHeader(head)) {
+        ULOG1(INFO) << "Replace recipients of the session header and write to the output.";
+        while (source.hasData()) {
+            const auto data = source.read();
+            head.insert(head.end(), data.cbegin(), data.cend());
+        }
+        const auto header = SessionCipher::rekey(options.credentials, options.recipients, head);
+        if (header.empty()) {
+            throw error::ArgumentRecipientDecryptionError();
+        }
+        sink.write(header);
+        finishOutput(sink);
+    } else if (SessionCipher::isMessage(head)) {
+        throw error::ArgumentRuntimeError(
+                "Session message has no recipients, re-key the session header instead.");
+    } else {
+        // Data key of the default format is held by the content info internally, and can not be re-encrypted.
+        throw error::ArgumentRuntimeError(
+                "Only data encrypted in the chunked format and session headers can be re-keyed. "
+                "Decrypt data encrypted in the default format and encrypt it again, i.e. with --chunked.");
+    }
+}
+
+EncryptedDataInfo Engine::inspect(Crypto::DataSource& source) {
+    ULOG1(INFO) << "Detect encrypted data format.";
+    auto head = source.hasData() ? source.read() : Crypto::Bytes();
+    EncryptedDataInfo info;
+    if (ChunkedCipher::isChunked(head)) {
+        ULOG1(INFO) << "Read header of the chunked data.";
+        PrefixedDataSource chunkedSource(std::move(head), source);
+        auto header = ChunkedCipher::readHeader(chunkedSource);
+        info.format = EncryptedDataInfo::Format::Chunked;
+        info.chunkSize = header.chunkSize;
+        describeEnvelope(info, header.envelope);
+    } else if (SessionCipher::isHeader(head)) {
+        ULOG1(INFO) << "Read session header.";
+        while (source.hasData()) {
+            const auto data = source.read();
+            head.insert(head.end(), data.cbegin(), data.cend());
+        }
+        info.format = EncryptedDataInfo::Format::SessionHeader;
+        info.sessionId = SessionCipher::readSessionId(head);
+        describeEnvelope(info, SessionCipher::readEnvelope(head));
+    } else if (SessionCipher::isMessage(head)) {
+        info.format = EncryptedDataInfo::Format::SessionMessage;
+        info.sessionId = SessionCipher::readSessionId(head);
+        info.dataCipher = Crypto::SymmetricCipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM).name();
+    } else {
+        ULOG1(INFO) << "Read embedded content info.";
+        const auto contentInfo = ContentInfo::readEmbedded(head, source);
+        info.contentInfoSize = Crypto::CipherBase::defineContentInfoSize(head);
+        info.dataCipher = contentInfo.dataCipherName();
+        describeRecipients(info, contentInfo);
+    }
+    return info;
+}
+
+EncryptedDataInfo Engine::inspect(const Crypto::Bytes& contentInfo) {
+    ULOG1(INFO) << "Read detached content info.";
+    const ContentInfo parsedContentInfo(contentInfo);
+    EncryptedDataInfo info;
+    info.contentInfoSize = contentInfo.size();
+    info.dataCipher = parsedContentInfo.dataCipherName();
+    describeRecipients(info, parsedContentInfo);
+    return info;
+}
+
+Crypto::Bytes Engine::sign(const SignOptions& options, Crypto::DataSource& source) {
+    if (!options.signer) {
+        throw error::ArgumentRuntimeError("Signer is not defined.");
+    }
+    ULOG1(INFO) << "Sign input data.";
+    return options.signer->sign(source, options.hashAlgorithm);
+}
+
+bool Engine::verify(const VerifyOptions& options, Crypto::DataSource& source) {
+    ULOG1(INFO) << "Verify input data with given sign.";
+    Crypto::StreamSigner signer;
+    return signer.verify(source, options.signature, options.senderKey.key());
+}
@@ -34,26 +34,241 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include <cli/model/FileDataSink.h>
 
 #include <cli/crypto/Crypto.h>
 #include <cli/error/ArgumentError.h>
+#include <cli/io/UringFile.h>
 
 #include <iostream>
 #include <fstream>
+#include <functional>
+#include <cstring>
+#include <vector>
+
+#if OS_UNIX
+#include <cerrno>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif //OS_UNIX
 
 using cli::model::FileDataSink;
+using cli::model::internal::FileDataSinkBackend;
+using cli::io::BufferPool;
+using cli::io::UringFileWriter;
+
+namespace cli { namespace model { namespace internal {
+
+class FileDataSinkBackend {
+public:
+    virtual ~FileDataSinkBackend() noexcept = default;
+    virtual bool isGood() = 0;
+    virtual void write(const unsigned char* data, size_t size) = 0;
+    virtual void flush() = 0;
+};
+
+}}}
+
+namespace {
+
+class StreamBackend : public FileDataSinkBackend {
+public:
+    using ostream_deleter = std::function<void(std::ostream*)>;
+    using ostream_ptr = std::unique_ptr<std::ostream, ostream_deleter>;
+
+    explicit StreamBackend(ostream_ptr out) : out_(std::move(out)) {
+    }
+
+    virtual bool isGood() override {
+        return out_->good();
+    }
+
+    virtual void write(const unsigned char* data, size_t size) override {
+        out_->write(reinterpret_cast<const std::ostream::char_type*>(data), size);
+    }
+
+    virtual void flush() override {
+        out_->flush();
+    }
+
+private:
+    ostream_ptr out_;
+};
+
+#if OS_UNIX
+
+/**
+ * @brief Write to the file descriptor directly with write(2) / writev(2), bypassing iostream buffers.
+ *
+ * Small writes are accumulated in the buffer, large writes are passed to the descriptor
+ * together with buffered data by single writev(2) call.
+ */
+class DescriptorBackend : public FileDataSinkBackend {
+public:
+    DescriptorBackend(int fd, size_t bufferSize)
+            : fd_(fd), bufferSize_(bufferSize), buffer_(), size_(0), good_(true),
+              isTerminal_(::isatty(fd) == 1), isStarted_(false) {
+    }
+
+    virtual ~DescriptorBackend() noexcept {
+        flush();
+    }
+
+    virtual bool isGood() override {
+        return good_;
+    }
+
+    virtual void write(const unsigned char* data, size_t size) override {
+        if (!good_ || size == 0) {
+            return;
+        }
+        if (!isStarted_) {
+            // Data that was written via std::cout before MUST precede sink data.
+            std::cout.flush();
+            isStarted_ = true;
+        }
+        if (buffer_.empty()) {
+            buffer_.resize(bufferSize_);
+        }
+        if (size_ + size <= buffer_.size()) {
+            std::memcpy(buffer_.data() + size_, data, size);
+            size_ += size;
+            if (isTerminal_) {
+                flush();
+            }
+            return;
+        }
+        struct iovec chunks[2];
+        chunks[0].iov_base = buffer_.data();
+        chunks[0].iov_len = size_;
+        chunks[1].iov_base = const_cast<unsigned char*>(data);
+        chunks[1].iov_len = size;
+        writeChunks(chunks, 2);
+        size_ = 0;
+    }
+
+    virtual void flush() override {
+        if (size_ == 0) {
+            return;
+        }
+        struct iovec chunk;
+        chunk.iov_base = buffer_.data();
+        chunk.iov_len = size_;
+        writeChunks(&chunk, 1);
+        size_ = 0;
+    }
+
+private:
+    /**
+     * @brief Write all given chunks, partial writes are continued.
+     * @note On error sink becomes not good, as std::ostream does.
+     */
+    void writeChunks(struct iovec* chunks, int count) {
+        while (count > 0 && good_) {
+            if (chunks->iov_len == 0) {
+                ++chunks;
+                --count;
+                continue;
+            }
+            const auto written = ::writev(fd_, chunks, count);
+            if (written < 0) {
+                if (errno != EINTR) {
+                    good_ = false;
+                }
+                continue;
+            }
+            auto left = static_cast<size_t>(written);
+            while (count > 0 && left >= chunks->iov_len) {
+                left -= chunks->iov_len;
+                ++chunks;
+                --count;
+            }
+            if (count > 0) {
+                chunks->iov_base = static_cast<unsigned char*>(chunks->iov_base) + left;
+                chunks->iov_len -= left;
+            }
+        }
+    }
+
+private:
+    const int fd_;
+    const size_t bufferSize_;
+    std::vector<unsigned char> buffer_;
+    size_t size_;
+    bool good_;
+    const bool isTerminal_;
+    bool isStarted_;
+};
+
+#endif //OS_UNIX
+
+#if USE_IO_URING
+
+class UringBackend : public FileDataSinkBackend {
+public:
+    explicit UringBackend(std::unique_ptr<UringFileWriter> writer) : writer_(std::move(writer)) {
+    }
+
+    virtual bool isGood() override {
+        return writer_->isGood();
+    }
+
+    virtual void write(const unsigned char* data, size_t size) override {
+        writer_->write(data, size);
+    }
+
+    virtual void flush() override {
+        writer_->flush();
+    }
+
+private:
+    std::unique_ptr<UringFileWriter> writer_;
+};
+
+#endif //USE_IO_URING
 
-FileDataSink::FileDataSink() : out_(ostream_ptr(&std::cout, [](std::ostream*) {})), isFileOutput_(false) {
 }
 
-FileDataSink::FileDataSink(const std::string& fileName)
-        : out_(ostream_ptr(new std::ofstream(fileName), std::default_delete<std::ostream>())), isFileOutput_(true) {
-    if (!*out_) {
+FileDataSink::FileDataSink(size_t bufferSize) : backend_(), isFileOutput_(false) {
+#if OS_UNIX
+    backend_.reset(new DescriptorBackend(STDOUT_FILENO, bufferSize));
+#else
+    (void)bufferSize;
+    backend_.reset(new StreamBackend(StreamBackend::ostream_ptr(&std::cout, [](std::ostream*) {})));
+#endif //OS_UNIX
+}
+
+FileDataSink::FileDataSink(const std::string& fileName, std::shared_ptr<BufferPool> bufferPool, bool useUring)
+        : backend_(), isFileOutput_(true) {
+#if USE_IO_URING
+    if (useUring) {
+        if (!bufferPool) {
+            bufferPool = std::make_shared<BufferPool>(kBufferSize_Default, UringFileWriter::kQueueDepth_Default);
+        }
+        auto writer = UringFileWriter::create(fileName, std::move(bufferPool));
+        if (writer) {
+            backend_.reset(new UringBackend(std::move(writer)));
+            return;
+        }
+    }
+#else
+    (void)bufferPool;
+    (void)useUring;
+#endif //USE_IO_URING
+    StreamBackend::ostream_ptr out(new std::ofstream(fileName), std::default_delete<std::ostream>());
+    if (!*out) {
         throw error::ArgumentFileNotFound(fileName);
     }
+    backend_.reset(new StreamBackend(std::move(out)));
 }
 
+FileDataSink::FileDataSink(FileDataSink&&) = default;
+
+FileDataSink& FileDataSink::operator=(FileDataSink&&) = default;
+
+FileDataSink::~FileDataSink() noexcept = default;
+
 bool FileDataSink::isFileOutput() const {
     return isFileOutput_;
 }
@@ -63,17 +278,26 @@ bool FileDataSink::isConsoleOutput() const {
 }
 
 void FileDataSink::addNewLine() {
-    *out_ << std::endl;
+    static const unsigned char kNewLine = '\n';
+    backend_->write(&kNewLine, 1);
+}
+
+void FileDataSink::flush() {
+    backend_->flush();
+    if (!backend_->isGood()) {
+        throw error::ArgumentRuntimeError(
+                "Output was not written completely, i.e. disk is full or output pipe is closed.");
+    }
 }
 
 bool FileDataSink::isGood() {
-    return out_->good();
+    return backend_->isGood();
 }
 
 void FileDataSink::write(const virgil::crypto::VirgilByteArray& data) {
-    out_->write(reinterpret_cast<const std::ostream::char_type*>(data.data()), data.size());
+    backend_->write(data.data(), data.size());
 }
 
 void FileDataSink::write(const std::string& text) {
-    out_->write(reinterpret_cast<const std::ostream::char_type*>(text.data()), text.size());
+    backend_->write(reinterpret_cast<const unsigned char*>(text.data()), text.size());
 }
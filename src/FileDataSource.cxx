@@ -34,63 +34,633 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+
 #include <cli/model/FileDataSource.h>
 
 #include <cli/crypto/Crypto.h>
 #include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/io/UringFile.h>
 
 #include <iostream>
 #include <fstream>
+#include <functional>
 #include <algorithm>
 #include <iterator>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#if OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif //OS_UNIX
 
 using cli::Crypto;
+using cli::io::BufferPool;
+using cli::io::UringFileReader;
 using cli::model::FileDataSource;
+using cli::model::internal::FileDataSourceBackend;
+
+namespace cli { namespace model { namespace internal {
+
+class FileDataSourceBackend {
+public:
+    virtual ~FileDataSourceBackend() noexcept = default;
+    virtual bool isMapped() const = 0;
+    virtual size_t size() const = 0;
+    virtual bool isSeekable() const = 0;
+    /**
+     * @brief Move read position to the given offset from the beginning of the data.
+     */
+    virtual void seek(size_t offset) = 0;
+    virtual bool hasData() = 0;
+    virtual Crypto::Bytes read(size_t maxSize) = 0;
+    virtual Crypto::Bytes readAll() = 0;
+    virtual Crypto::Text readText() = 0;
+    /**
+     * @brief Read line without line terminator.
+     * @return false - if no characters was extracted, true - otherwise.
+     */
+    virtual bool readLine(Crypto::Text& line) = 0;
+};
+
+}}}
+
+namespace {
+
+static constexpr const size_t kReadAllChunkSize = 64 * 1024; // 64KB
+
+class StreamBackend : public FileDataSourceBackend {
+public:
+    using istream_deleter = std::function<void(std::istream*)>;
+    using istream_ptr = std::unique_ptr<std::istream, istream_deleter>;
+
+    /**
+     * @param isSeekable - true if stream refers to the regular file.
+     */
+    StreamBackend(istream_ptr in, bool isSeekable) : in_(std::move(in)), isSeekable_(isSeekable) {
+    }
+
+    virtual bool isMapped() const override {
+        return false;
+    }
+
+    virtual size_t size() const override {
+        return FileDataSource::kSize_Unknown;
+    }
+
+    virtual bool isSeekable() const override {
+        return isSeekable_;
+    }
+
+    virtual void seek(size_t offset) override {
+        in_->clear();
+        if (!isSeekable_ || !in_->seekg(static_cast<std::streamoff>(offset))) {
+            throw cli::error::ArgumentRuntimeError("Failed to seek input data.");
+        }
+    }
+
+    virtual bool hasData() override {
+        return in_->good();
+    }
+
+    virtual Crypto::Bytes read(size_t maxSize) override {
+        Crypto::Bytes result(maxSize);
+        in_->read(reinterpret_cast<std::istream::char_type*>(result.data()), result.size());
+        if (!*in_) {
+            // Only part of chunk was read, so result MUST be trimmed.
+            result.resize(static_cast<size_t>(in_->gcount()));
+        }
+        return result;
+    }
+
+    virtual Crypto::Bytes readAll() override {
+        Crypto::Bytes result;
+        while (*in_) {
+            const auto offset = result.size();
+            result.resize(offset + kReadAllChunkSize);
+            in_->read(reinterpret_cast<std::istream::char_type*>(result.data() + offset), kReadAllChunkSize);
+            result.resize(offset + static_cast<size_t>(in_->gcount()));
+        }
+        return result;
+    }
+
+    virtual Crypto::Text readText() override {
+        Crypto::Text result;
+        std::copy(std::istreambuf_iterator<char>(*in_), std::istreambuf_iterator<char>(), std::back_inserter(result));
+        return result;
+    }
+
+    virtual bool readLine(Crypto::Text& line) override {
+        return static_cast<bool>(std::getline(*in_, line));
+    }
+
+private:
+    istream_ptr in_;
+    const bool isSeekable_;
+};
+
+#if OS_UNIX
+
+/**
+ * @brief Read file descriptor directly with read(2), bypassing iostream buffers.
+ *
+ * Used for the standard input, so pipelines are read with large blocks.
+ */
+class DescriptorBackend : public FileDataSourceBackend {
+public:
+    /**
+     * @param ownsDescriptor - if true, then descriptor is closed on destruction.
+     * @param bufferSize - size of the buffer, that accumulates data of the small reads.
+     */
+    DescriptorBackend(int fd, bool ownsDescriptor, size_t bufferSize)
+            : fd_(fd), ownsDescriptor_(ownsDescriptor), bufferSize_(bufferSize), buffer_(),
+              begin_(0), end_(0), eof_(false), size_(FileDataSource::kSize_Unknown), startOffset_(-1) {
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+            const auto offset = ::lseek(fd, 0, SEEK_CUR);
+            if (offset >= 0 && offset <= info.st_size) {
+                size_ = static_cast<size_t>(info.st_size - offset);
+                startOffset_ = offset;
+            }
+        }
+    }
+
+    virtual ~DescriptorBackend() noexcept {
+        if (ownsDescriptor_) {
+            (void)::close(fd_);
+        }
+    }
+
+    virtual bool isMapped() const override {
+        return false;
+    }
+
+    virtual size_t size() const override {
+        return size_;
+    }
+
+    virtual bool isSeekable() const override {
+        return startOffset_ >= 0;
+    }
+
+    virtual void seek(size_t offset) override {
+        if (!isSeekable() || ::lseek(fd_, startOffset_ + static_cast<off_t>(offset), SEEK_SET) < 0) {
+            throw cli::error::ArgumentRuntimeError("Failed to seek input data.");
+        }
+        begin_ = 0;
+        end_ = 0;
+        eof_ = false;
+    }
+
+    virtual bool hasData() override {
+        return begin_ < end_ || !eof_;
+    }
+
+    virtual Crypto::Bytes read(size_t maxSize) override {
+        if (maxSize > bufferSize_) {
+            Crypto::Bytes result(maxSize);
+            auto readSize = takeBuffered(result.data(), maxSize);
+            while (readSize < maxSize && !eof_) {
+                readSize += readSome(result.data() + readSize, maxSize - readSize);
+            }
+            result.resize(readSize);
+            return result;
+        }
+        fill(maxSize);
+        const auto readSize = std::min(maxSize, end_ - begin_);
+        Crypto::Bytes result(buffer_.data() + begin_, buffer_.data() + begin_ + readSize);
+        begin_ += readSize;
+        return result;
+    }
+
+    virtual Crypto::Bytes readAll() override {
+        Crypto::Bytes result;
+        while (hasData()) {
+            fill(bufferSize_);
+            result.insert(result.end(), buffer_.data() + begin_, buffer_.data() + end_);
+            begin_ = end_;
+        }
+        return result;
+    }
+
+    virtual Crypto::Text readText() override {
+        auto data = readAll();
+        return Crypto::Text(data.begin(), data.end());
+    }
+
+    virtual bool readLine(Crypto::Text& line) override {
+        line.clear();
+        bool extracted = false;
+        for (;;) {
+            if (begin_ == end_) {
+                if (eof_) {
+                    return extracted;
+                }
+                fill(1);
+                continue;
+            }
+            extracted = true;
+            const auto begin = buffer_.data() + begin_;
+            const auto end = buffer_.data() + end_;
+            auto lineEnd = static_cast<const unsigned char*>(std::memchr(begin, '\n', end - begin));
+            if (lineEnd != nullptr) {
+                line.append(reinterpret_cast<const char*>(begin), lineEnd - begin);
+                begin_ += (lineEnd - begin) + 1;
+                return true;
+            }
+            line.append(reinterpret_cast<const char*>(begin), end - begin);
+            begin_ = end_;
+        }
+    }
+
+private:
+    /**
+     * @brief Read from descriptor until buffer contains at least given number of bytes, or end of file is reached.
+     */
+    void fill(size_t size) {
+        if (buffer_.empty()) {
+            buffer_.resize(bufferSize_);
+        }
+        if (end_ - begin_ >= size || eof_) {
+            return;
+        }
+        if (begin_ > 0) {
+            std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+            end_ -= begin_;
+            begin_ = 0;
+        }
+        while (end_ < size && !eof_) {
+            end_ += readSome(buffer_.data() + end_, buffer_.size() - end_);
+        }
+    }
+
+    size_t takeBuffered(unsigned char* data, size_t size) {
+        const auto result = std::min(size, end_ - begin_);
+        if (result > 0) {
+            std::memcpy(data, buffer_.data() + begin_, result);
+            begin_ += result;
+        }
+        return result;
+    }
+
+    size_t readSome(unsigned char* data, size_t size) {
+        for (;;) {
+            const auto result = ::read(fd_, data, size);
+            if (result > 0) {
+                return static_cast<size_t>(result);
+            } else if (result == 0) {
+                eof_ = true;
+                return 0;
+            } else if (errno != EINTR) {
+                throw cli::error::ArgumentRuntimeError(
+                        tfm::format("Failed to read input data: %s", std::strerror(errno)));
+            }
+        }
+    }
+
+private:
+    const int fd_;
+    const bool ownsDescriptor_;
+    const size_t bufferSize_;
+    std::vector<unsigned char> buffer_;
+    size_t begin_;
+    size_t end_;
+    bool eof_;
+    size_t size_;
+    off_t startOffset_;
+};
+
+/**
+ * @brief Read regular file via memory mapping.
+ *
+ * Data is copied from the mapped pages directly to the resulting chunk,
+ * and pages that were already consumed are released to keep resident memory low.
+ */
+class MappedBackend : public FileDataSourceBackend {
+public:
+    MappedBackend(void* data, size_t size)
+            : data_(static_cast<const unsigned char*>(data)), size_(size), pos_(0), releasedPos_(0),
+              pageSize_(static_cast<size_t>(::sysconf(_SC_PAGESIZE))) {
+        (void)::madvise(data, size, MADV_SEQUENTIAL);
+    }
+
+    virtual ~MappedBackend() noexcept {
+        (void)::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+
+    /**
+     * @brief Map file with given descriptor to the memory.
+     * @note Mapping remains valid after the file descriptor is closed.
+     * @return Backend if file was mapped, nullptr - otherwise.
+     */
+    static std::unique_ptr<MappedBackend> map(int fd) {
+        std::unique_ptr<MappedBackend> result;
+        struct stat info;
+        if (::fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0 &&
+                static_cast<unsigned long long>(info.st_size) <= std::numeric_limits<size_t>::max()) {
+            const auto size = static_cast<size_t>(info.st_size);
+            void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED) {
+                result.reset(new MappedBackend(data, size));
+            }
+        }
+        return result;
+    }
+
+    virtual bool isMapped() const override {
+        return true;
+    }
 
-FileDataSource::FileDataSource(size_t chunkSize) : in_(&std::cin, [](std::istream*){}), chunkSize_(chunkSize) {
+    virtual size_t size() const override {
+        return size_;
+    }
+
+    virtual bool isSeekable() const override {
+        return true;
+    }
+
+    virtual void seek(size_t offset) override {
+        pos_ = std::min(offset, size_);
+        releasedPos_ = pos_ - (pos_ % pageSize_);
+    }
+
+    virtual bool hasData() override {
+        return pos_ < size_;
+    }
+
+    virtual Crypto::Bytes read(size_t maxSize) override {
+        const auto size = std::min(maxSize, size_ - pos_);
+        Crypto::Bytes result(data_ + pos_, data_ + pos_ + size);
+        pos_ += size;
+        releaseConsumedPages();
+        return result;
+    }
+
+    virtual Crypto::Bytes readAll() override {
+        return read(size_ - pos_);
+    }
+
+    virtual Crypto::Text readText() override {
+        Crypto::Text result(reinterpret_cast<const char*>(data_ + pos_), size_ - pos_);
+        pos_ = size_;
+        return result;
+    }
+
+    virtual bool readLine(Crypto::Text& line) override {
+        if (pos_ >= size_) {
+            line.clear();
+            return false;
+        }
+        const auto begin = data_ + pos_;
+        const auto end = data_ + size_;
+        auto lineEnd = static_cast<const unsigned char*>(std::memchr(begin, '\n', end - begin));
+        if (lineEnd == nullptr) {
+            line.assign(reinterpret_cast<const char*>(begin), end - begin);
+            pos_ = size_;
+        } else {
+            line.assign(reinterpret_cast<const char*>(begin), lineEnd - begin);
+            pos_ += (lineEnd - begin) + 1;
+        }
+        return true;
+    }
+
+private:
+    void releaseConsumedPages() {
+        const auto releaseEnd = pos_ - (pos_ % pageSize_);
+        if (releaseEnd > releasedPos_) {
+            (void)::madvise(const_cast<unsigned char*>(data_ + releasedPos_), releaseEnd - releasedPos_,
+                    MADV_DONTNEED);
+            releasedPos_ = releaseEnd;
+        }
+    }
+
+private:
+    const unsigned char* data_;
+    const size_t size_;
+    size_t pos_;
+    size_t releasedPos_;
+    const size_t pageSize_;
+};
+
+#endif //OS_UNIX
+
+#if USE_IO_URING
+
+/**
+ * @brief Read regular file with io_uring engine, several blocks are read ahead.
+ */
+class UringBackend : public FileDataSourceBackend {
+public:
+    explicit UringBackend(std::unique_ptr<UringFileReader> reader)
+            : reader_(std::move(reader)), block_(nullptr, 0), pos_(0), eof_(false) {
+    }
+
+    virtual bool isMapped() const override {
+        return false;
+    }
+
+    virtual size_t size() const override {
+        return reader_->size();
+    }
+
+    virtual bool isSeekable() const override {
+        return true;
+    }
+
+    virtual void seek(size_t offset) override {
+        const auto blockOffset = reader_->seek(offset);
+        block_ = UringFileReader::Block(nullptr, 0);
+        pos_ = 0;
+        eof_ = false;
+        if (offset > blockOffset && fetch()) {
+            pos_ = std::min(offset - blockOffset, block_.second);
+        }
+    }
+
+    virtual bool hasData() override {
+        return fetch();
+    }
+
+    virtual Crypto::Bytes read(size_t maxSize) override {
+        Crypto::Bytes result;
+        result.reserve(std::min(maxSize, reader_->size()));
+        while (result.size() < maxSize && fetch()) {
+            const auto size = std::min(maxSize - result.size(), block_.second - pos_);
+            result.insert(result.end(), block_.first + pos_, block_.first + pos_ + size);
+            pos_ += size;
+        }
+        return result;
+    }
+
+    virtual Crypto::Bytes readAll() override {
+        Crypto::Bytes result;
+        while (fetch()) {
+            result.insert(result.end(), block_.first + pos_, block_.first + block_.second);
+            pos_ = block_.second;
+        }
+        return result;
+    }
+
+    virtual Crypto::Text readText() override {
+        auto data = readAll();
+        return Crypto::Text(data.begin(), data.end());
+    }
+
+    virtual bool readLine(Crypto::Text& line) override {
+        line.clear();
+        bool extracted = false;
+        while (fetch()) {
+            extracted = true;
+            const auto begin = block_.first + pos_;
+            const auto end = block_.first + block_.second;
+            auto lineEnd = static_cast<const unsigned char*>(std::memchr(begin, '\n', end - begin));
+            if (lineEnd != nullptr) {
+                line.append(reinterpret_cast<const char*>(begin), lineEnd - begin);
+                pos_ += (lineEnd - begin) + 1;
+                return true;
+            }
+            line.append(reinterpret_cast<const char*>(begin), end - begin);
+            pos_ = block_.second;
+        }
+        return extracted;
+    }
+
+private:
+    /**
+     * @brief Take next block if current one is consumed.
+     * @return false - if end of file is reached.
+     */
+    bool fetch() {
+        if (pos_ < block_.second) {
+            return true;
+        }
+        if (eof_) {
+            return false;
+        }
+        block_ = reader_->next();
+        pos_ = 0;
+        eof_ = block_.second == 0;
+        return !eof_;
+    }
+
+private:
+    std::unique_ptr<UringFileReader> reader_;
+    UringFileReader::Block block_;
+    size_t pos_;
+    bool eof_;
+};
+
+#endif //USE_IO_URING
+
+}
+
+FileDataSource::FileDataSource(size_t chunkSize) : backend_(), chunkSize_(chunkSize), isFileInput_(false) {
+#if OS_UNIX
+    // Data that was already buffered by std::cin must not be skipped.
+    if (std::cin.rdbuf()->in_avail() <= 0) {
+        backend_.reset(new DescriptorBackend(STDIN_FILENO, false, chunkSize));
+        return;
+    }
+#endif //OS_UNIX
+    backend_.reset(new StreamBackend(StreamBackend::istream_ptr(&std::cin, [](std::istream*) {}), false));
 }
 
-FileDataSource::FileDataSource(const std::string& fileName, size_t chunkSize)
-        : in_(new std::ifstream(fileName), std::default_delete<std::istream>()), chunkSize_(chunkSize) {
-    if (!*in_) {
+FileDataSource::FileDataSource(
+        const std::string& fileName, size_t chunkSize, std::shared_ptr<BufferPool> bufferPool, bool useUring)
+        : backend_(), chunkSize_(chunkSize), isFileInput_(true) {
+#if USE_IO_URING
+    if (useUring) {
+        if (!bufferPool) {
+            bufferPool = std::make_shared<BufferPool>(chunkSize, UringFileReader::kQueueDepth_Default);
+        }
+        auto reader = UringFileReader::create(fileName, std::move(bufferPool));
+        if (reader) {
+            backend_.reset(new UringBackend(std::move(reader)));
+            return;
+        }
+    }
+#else
+    (void)bufferPool;
+    (void)useUring;
+#endif //USE_IO_URING
+#if OS_UNIX
+    const int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw error::ArgumentFileNotFound(fileName);
+    }
+    backend_ = MappedBackend::map(fd);
+    if (backend_) {
+        (void)::close(fd);
+        return;
+    }
+    // File that can not be mapped (i.e. FIFO or empty file) is read with the same descriptor,
+    // so FIFO writer is not affected by reopening.
+    backend_.reset(new DescriptorBackend(fd, true, chunkSize));
+#else
+    StreamBackend::istream_ptr in(new std::ifstream(fileName), std::default_delete<std::istream>());
+    if (!*in) {
         throw error::ArgumentFileNotFound(fileName);
     }
+    backend_.reset(new StreamBackend(std::move(in), true));
+#endif //OS_UNIX
+}
+
+FileDataSource::FileDataSource(FileDataSource&&) = default;
+
+FileDataSource& FileDataSource::operator=(FileDataSource&&) = default;
+
+FileDataSource::~FileDataSource() noexcept = default;
+
+bool FileDataSource::isFileInput() const {
+    return isFileInput_;
+}
+
+bool FileDataSource::isMapped() const {
+    return backend_->isMapped();
+}
+
+size_t FileDataSource::size() const {
+    return backend_->size();
+}
+
+bool FileDataSource::isSeekable() const {
+    return backend_->isSeekable();
+}
+
+void FileDataSource::seek(size_t offset) {
+    backend_->seek(offset);
 }
 
 bool FileDataSource::hasData() {
-    return in_->good();
+    return backend_->hasData();
 }
 
 Crypto::Bytes FileDataSource::read() {
-    Crypto::Bytes result(chunkSize_);
-    in_->read(reinterpret_cast<std::istream::char_type*>(result.data()), result.size());
-    if (!*in_) {
-        // Only part of chunk was read, so result MUST be trimmed.
-        result.resize(static_cast<size_t>(in_->gcount()));
-    }
-    return result;
+    return backend_->read(chunkSize_);
 }
 
 Crypto::Bytes FileDataSource::readAll() {
-    Crypto::Bytes result;
-    std::copy(std::istreambuf_iterator<char>(*in_), std::istreambuf_iterator<char>(), std::back_inserter(result));
-    return result;
+    return backend_->readAll();
 }
 
 Crypto::Text FileDataSource::readLine() {
     Crypto::Text result;
-    std::getline(*in_, result);
+    backend_->readLine(result);
     return result;
 }
 
 std::vector<Crypto::Text> FileDataSource::readMultiLine() {
     std::vector<Crypto::Text> result;
-    for (Crypto::Text line; std::getline(*in_, line); result.push_back(std::move(line)));
+    for (Crypto::Text line; backend_->readLine(line); result.push_back(std::move(line)));
     return result;
 }
 
 Crypto::Text FileDataSource::readText() {
-    Crypto::Text result;
-    std::copy(std::istreambuf_iterator<char>(*in_), std::istreambuf_iterator<char>(), std::back_inserter(result));
-    return result;
+    return backend_->readText();
 }
@@ -0,0 +1,132 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/concurrency/FileJobRunner.h>
+
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/crypto/Crypto.h>
+#include <cli/io/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <future>
+#include <stdexcept>
+
+using cli::Crypto;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
+using cli::concurrency::ThreadPool;
+
+namespace {
+
+/**
+ * @brief Return unique path of the temporary file next to the given file.
+ */
+std::string make_temp_path(const std::string& path) {
+    Crypto::Random random(Crypto::ByteUtils::stringToBytes("virgil-cli-file-job"));
+    return path + "." + Crypto::ByteUtils::bytesToHex(random.randomize(8)) + ".tmp";
+}
+
+/**
+ * @brief Replace given file with the temporary file.
+ * @return false - if file can not be replaced.
+ */
+bool replace_file(const std::string& tmpPath, const std::string& path) {
+#if OS_WIN32
+    std::remove(path.c_str());
+#endif //OS_WIN32
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+}
+
+FileJobRunner::FileJobRunner(size_t threadCount, bool isOutputWritten)
+        : threadCount_(threadCount == ThreadPool::kThreadCount_Auto ? ThreadPool::hardwareConcurrency() : threadCount),
+          isOutputWritten_(isOutputWritten) {
+}
+
+size_t FileJobRunner::run(const std::vector<FileJob>& fileJobs, const Handler& handler) const {
+    std::atomic<size_t> nextJob(0);
+    std::atomic<size_t> failedCount(0);
+    auto work = [&]() {
+        for (size_t i = nextJob++; i < fileJobs.size(); i = nextJob++) {
+            const auto& fileJob = fileJobs[i];
+            if (fileJob.inputFile == fileJob.outputFile) {
+                ++failedCount;
+                ULOG(WARNING) << tfm::format("File '%s' is not processed: Output file is the same as input file.",
+                        fileJob.inputFile);
+                continue;
+            }
+            // Output is written to the temporary file, so failed job leaves neither partial output,
+            // nor removes the output of the previous run.
+            const FileJob stagedJob = isOutputWritten_
+                    ? FileJob{ fileJob.inputFile, make_temp_path(fileJob.outputFile) } : fileJob;
+            try {
+                handler(stagedJob);
+                if (isOutputWritten_ && !replace_file(stagedJob.outputFile, fileJob.outputFile)) {
+                    throw std::runtime_error(tfm::format("Can not write output file '%s'.", fileJob.outputFile));
+                }
+                ULOG1(INFO) << tfm::format("File '%s' is processed.", fileJob.inputFile);
+            } catch (const std::exception& exception) {
+                ++failedCount;
+                ULOG(WARNING) << tfm::format("File '%s' is not processed: %s", fileJob.inputFile, exception.what());
+                if (isOutputWritten_) {
+                    // Sink of the handler is already closed, so temporary file can be removed.
+                    std::remove(stagedJob.outputFile.c_str());
+                }
+            }
+        }
+    };
+
+    const auto threadCount = std::min(threadCount_, fileJobs.size());
+    if (threadCount <= 1) {
+        work();
+        return failedCount;
+    }
+    // Workers take files one by one, so the number of the scheduled tasks does not depend on the number of files.
+    ThreadPool threadPool(threadCount);
+    std::vector<std::future<void>> workers;
+    for (size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(threadPool.submit(work));
+    }
+    for (auto& worker : workers) {
+        worker.get();
+    }
+    return failedCount;
+}
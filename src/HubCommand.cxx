@@ -43,6 +43,8 @@
 #include <cli/io/Logger.h>
 #include <cli/error/ArgumentError.h>
 
+#include <cli/command/AgentCommand.h>
+#include <cli/command/BatchCommand.h>
 #include <cli/command/KeygenCommand.h>
 #include <cli/command/KeyToPubCommand.h>
 #include <cli/command/KeyFormatCommand.h>
@@ -54,8 +56,12 @@
 #include <cli/command/CardGetCommand.h>
 #include <cli/command/CardRevokeCommand.h>
 #include <cli/command/CardSearchCommand.h>
+#include <cli/command/CardSyncCommand.h>
 #include <cli/command/CardInfoCommand.h>
+#include <cli/command/RekeyCommand.h>
+#include <cli/command/ContentInfoCommand.h>
 #include <cli/command/SecretAliasCommand.h>
+#include <cli/command/ServeCommand.h>
 
 using namespace cli;
 using namespace cli::command;
@@ -85,6 +91,10 @@ void HubCommand::doProcess() const {
         EncryptCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_DECRYPT) {
         DecryptCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_REKEY) {
+        RekeyCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_CONTENT_INFO) {
+        ContentInfoCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_SIGN) {
         SignCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_VERIFY) {
@@ -97,10 +107,18 @@ void HubCommand::doProcess() const {
         CardRevokeCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_CARD_SEARCH) {
         CardSearchCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_CARD_SYNC) {
+        CardSyncCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_CARD_INFO) {
         CardInfoCommand(getArgumentIO()).process();
     } else if (commandName == arg::value::VIRGIL_COMMAND_SECRET_ALIAS) {
         SecretAliasCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_AGENT) {
+        AgentCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_BATCH) {
+        BatchCommand(getArgumentIO()).process();
+    } else if (commandName == arg::value::VIRGIL_COMMAND_SERVE) {
+        ServeCommand(getArgumentIO()).process();
     } else {
         throw error::ArgumentValueError(arg::COMMAND, commandName);
     }
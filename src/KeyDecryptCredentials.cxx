@@ -36,15 +36,19 @@
 
 #include <cli/model/KeyDecryptCredentials.h>
 
+using cli::model::ContentInfo;
 using cli::model::KeyDecryptCredentials;
 
 KeyDecryptCredentials::KeyDecryptCredentials(PrivateKey privateKey)
         : privateKey_(std::move(privateKey)), publicKey_(privateKey_.extractPublic()) {
 }
 
+bool KeyDecryptCredentials::doIsRecipientOf(const ContentInfo& contentInfo) const {
+    return contentInfo.hasKeyRecipient(publicKey_.identifier());
+}
+
 bool KeyDecryptCredentials::doDecrypt(
         Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const {
-    cipher.decryptWithKey(source, sink, publicKey_.identifier(),
-            privateKey_.key(), privateKey_.password().bytesValue());
+    cipher.decryptWithKey(source, sink, publicKey_.identifier(), privateKey_.unlockedKey());
     return true;
 }
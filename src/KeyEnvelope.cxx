@@ -0,0 +1,196 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/model/KeyEnvelope.h>
+
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/model/BytesDataSink.h>
+#include <cli/model/BytesDataSource.h>
+#include <cli/model/ContentInfo.h>
+
+#include <virgil/crypto/VirgilCryptoException.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+
+using cli::Crypto;
+using cli::concurrency::ThreadPool;
+using cli::model::BytesDataSink;
+using cli::model::BytesDataSource;
+using cli::model::ContentInfo;
+using cli::model::DecryptCredentials;
+using cli::model::EncryptCredentials;
+using cli::model::KeyEnvelope;
+using virgil::crypto::VirgilCryptoException;
+
+namespace {
+
+constexpr const unsigned char kMagic[] = { 'V', 'C', 'L', 'I', 'E', 'N', 'V', '1' };
+constexpr const size_t kMagicSize = sizeof(kMagic);
+constexpr const size_t kNumberSize = 4;
+
+void appendNumber(Crypto::Bytes& data, uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; --i) {
+        data.push_back(static_cast<unsigned char>(value >> ((i - 1) * 8)));
+    }
+}
+
+uint64_t readNumber(const unsigned char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+Crypto::Bytes wrapShard(
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients, size_t begin, size_t end,
+        const Crypto::Bytes& key) {
+    Crypto::StreamCipher cipher;
+    for (size_t i = begin; i < end; ++i) {
+        recipients[i]->addSelfTo(cipher);
+    }
+    BytesDataSource keySource(key);
+    BytesDataSink shardSink;
+    cipher.encrypt(keySource, shardSink, true);
+    return shardSink.data();
+}
+
+/**
+ * @brief Split envelope to the shards, envelope without shards is returned as the single shard.
+ */
+std::vector<Crypto::Bytes> readShards(const Crypto::Bytes& envelope) {
+    if (envelope.size() < kMagicSize || !std::equal(kMagic, kMagic + kMagicSize, envelope.cbegin())) {
+        return { envelope };
+    }
+    if (envelope.size() < kMagicSize + kNumberSize) {
+        throw cli::error::ArgumentRuntimeError("Data key envelope is malformed.");
+    }
+    const auto shardCount = readNumber(envelope.data() + kMagicSize, kNumberSize);
+    std::vector<Crypto::Bytes> shards;
+    size_t pos = kMagicSize + kNumberSize;
+    for (uint64_t i = 0; i < shardCount; ++i) {
+        if (envelope.size() - pos < kNumberSize) {
+            throw cli::error::ArgumentRuntimeError("Data key envelope is malformed.");
+        }
+        const auto shardSize = readNumber(envelope.data() + pos, kNumberSize);
+        pos += kNumberSize;
+        if (shardSize == 0 || shardSize > envelope.size() - pos) {
+            throw cli::error::ArgumentRuntimeError("Data key envelope is malformed.");
+        }
+        shards.emplace_back(envelope.cbegin() + pos, envelope.cbegin() + pos + shardSize);
+        pos += shardSize;
+    }
+    if (shards.empty() || pos != envelope.size()) {
+        throw cli::error::ArgumentRuntimeError("Data key envelope is malformed.");
+    }
+    return shards;
+}
+
+Crypto::Bytes readShardContentInfo(const Crypto::Bytes& shard) {
+    const auto contentInfoSize = Crypto::CipherBase::defineContentInfoSize(shard);
+    if (contentInfoSize == 0 || contentInfoSize > shard.size()) {
+        throw cli::error::ArgumentRuntimeError("Data key envelope is malformed.");
+    }
+    return Crypto::Bytes(shard.cbegin(), shard.cbegin() + contentInfoSize);
+}
+
+}
+
+constexpr const size_t KeyEnvelope::kJobs_Auto;
+constexpr const size_t KeyEnvelope::kShardRecipients;
+
+Crypto::Bytes KeyEnvelope::wrap(
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients, const Crypto::Bytes& key, size_t jobs) {
+    if (recipients.size() <= kShardRecipients) {
+        return wrapShard(recipients, 0, recipients.size(), key);
+    }
+    const auto shardCount = (recipients.size() + kShardRecipients - 1) / kShardRecipients;
+    ThreadPool pool(jobs);
+    ULOG2(INFO) << tfm::format("Encrypt data key for %d recipient(s) in %d shard(s) with %d thread(s).",
+            recipients.size(), shardCount, pool.size());
+    std::vector<std::future<Crypto::Bytes>> shards;
+    shards.reserve(shardCount);
+    for (size_t begin = 0; begin < recipients.size(); begin += kShardRecipients) {
+        const auto end = std::min(begin + kShardRecipients, recipients.size());
+        shards.push_back(pool.submit([&recipients, &key, begin, end]() {
+            return wrapShard(recipients, begin, end, key);
+        }));
+    }
+    Crypto::Bytes envelope(kMagic, kMagic + kMagicSize);
+    appendNumber(envelope, shardCount, kNumberSize);
+    for (auto& future : shards) {
+        const auto shard = future.get();
+        appendNumber(envelope, shard.size(), kNumberSize);
+        envelope.insert(envelope.end(), shard.cbegin(), shard.cend());
+    }
+    return envelope;
+}
+
+Crypto::Bytes KeyEnvelope::unwrap(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& credentials, const Crypto::Bytes& envelope,
+        size_t keySize) {
+    for (const auto& shard : readShards(envelope)) {
+        const ContentInfo contentInfo(readShardContentInfo(shard));
+        for (const auto& credential : credentials) {
+            if (!credential->isRecipientOf(contentInfo)) {
+                continue;
+            }
+            Crypto::StreamCipher cipher;
+            BytesDataSource shardSource(shard);
+            BytesDataSink keySink;
+            try {
+                if (credential->decrypt(cipher, shardSource, keySink) && keySink.data().size() == keySize) {
+                    return keySink.data();
+                }
+            } catch (const VirgilCryptoException& exception) {
+                DLOG(INFO) << "Recipient can not decrypt data key: " << exception.what();
+            }
+        }
+    }
+    return Crypto::Bytes();
+}
+
+std::vector<Crypto::Bytes> KeyEnvelope::readContentInfos(const Crypto::Bytes& envelope) {
+    std::vector<Crypto::Bytes> result;
+    for (const auto& shard : readShards(envelope)) {
+        result.push_back(readShardContentInfo(shard));
+    }
+    return result;
+}
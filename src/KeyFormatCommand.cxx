@@ -37,21 +37,28 @@
 #include <cli/command/KeyFormatCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/concurrency/FileJobRunner.h>
 #include <cli/crypto/Crypto.h>
 
 #include <cli/io/Logger.h>
 #include <cli/memory.h>
 #include <cli/error/ArgumentError.h>
 
+#include <map>
+#include <string>
+
 using cli::Crypto;
 using cli::command::KeyFormatCommand;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentSource;
 using cli::argument::ArgumentParseOptions;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
 using cli::model::Password;
 using cli::model::PrivateKey;
 using cli::error::ArgumentLogicError;
+using cli::error::ArgumentRuntimeError;
 
 const char* KeyFormatCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_KEY_FORMAT;
@@ -71,10 +78,11 @@ void KeyFormatCommand::doProcess() const {
     auto isPublicKey = getArgumentIO()->isPublicKey();
     auto isPrivateKey = getArgumentIO()->isPrivateKey();
 
+    const auto isMultiFile = getArgumentIO()->isMultiFile();
     if (isPublicKey) {
-        processPublicKey();
+        isMultiFile ? processPublicKeyFiles() : processPublicKey();
     } else if (isPrivateKey) {
-        processPrivateKey();
+        isMultiFile ? processPrivateKeyFiles() : processPrivateKey();
     } else {
         throw ArgumentLogicError("Key format is not given in the command arguments.");
     }
@@ -94,7 +102,9 @@ void KeyFormatCommand::processPublicKey() const {
         throw ArgumentLogicError("Unexpected key format is given. Validation should fail first.");
     }
     ULOG1(INFO) << "Write public key to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(formattedKey);
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(formattedKey);
+    output.flush();
 
 }
 
@@ -103,14 +113,79 @@ void KeyFormatCommand::processPrivateKey() const {
     auto format = getArgumentIO()->getKeyFormat(ArgumentImportance::Required);
 
     ULOG1(INFO) << "Format private key.";
+    // Unlocked key is not encrypted, so password is used only to encrypt the formatted key.
     Crypto::Bytes formattedKey;
     if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_PEM) {
-        formattedKey = Crypto::KeyPair::privateKeyToPEM(privateKey.key(), privateKey.password().bytesValue());
+        formattedKey = Crypto::KeyPair::privateKeyToPEM(privateKey.unlockedKey(), privateKey.password().bytesValue());
     } else if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_DER) {
-        formattedKey = Crypto::KeyPair::privateKeyToDER(privateKey.key(), privateKey.password().bytesValue());
+        formattedKey = Crypto::KeyPair::privateKeyToDER(privateKey.unlockedKey(), privateKey.password().bytesValue());
     } else {
         throw ArgumentLogicError("Unexpected key format is given. Validation should fail first.");
     }
     ULOG1(INFO) << "Write private key to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(formattedKey);
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(formattedKey);
+    output.flush();
+}
+
+void KeyFormatCommand::processPublicKeyFiles() const {
+    auto format = getArgumentIO()->getKeyFormat(ArgumentImportance::Required);
+    auto fileJobs = getArgumentIO()->getFileJobs(false, ArgumentImportance::Required, "." + format);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+
+    ULOG1(INFO) << tfm::format("Format %d public key(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, true).run(fileJobs, [this, &format](const FileJob& fileJob) {
+        auto publicKey = getArgumentIO()->getFileSource(fileJob.inputFile).readAll();
+        Crypto::Bytes formattedKey;
+        if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_PEM) {
+            formattedKey = Crypto::KeyPair::publicKeyToPEM(publicKey);
+        } else if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_DER) {
+            formattedKey = Crypto::KeyPair::publicKeyToDER(publicKey);
+        } else {
+            throw ArgumentLogicError("Unexpected key format is given. Validation should fail first.");
+        }
+        auto output = getArgumentIO()->getFileSink(fileJob.outputFile);
+        output.write(formattedKey);
+        output.flush();
+    });
+    if (failedCount > 0) {
+        throw ArgumentRuntimeError(
+                tfm::format("Formatting failed for %d of %d public key(s).", failedCount, fileJobs.size()));
+    }
+}
+
+void KeyFormatCommand::processPrivateKeyFiles() const {
+    auto format = getArgumentIO()->getKeyFormat(ArgumentImportance::Required);
+    auto fileJobs = getArgumentIO()->getFileJobs(false, ArgumentImportance::Required, "." + format);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+
+    // Keys are unlocked one by one, because password can be requested from the user.
+    ULOG1(INFO) << tfm::format("Read %d private key(s).", fileJobs.size());
+    // Output files are unique, so input files are unique too.
+    std::map<std::string, PrivateKey> privateKeys;
+    for (const auto& fileJob : fileJobs) {
+        privateKeys.emplace(fileJob.inputFile, getArgumentIO()->getPrivateKeyFromFile(fileJob.inputFile));
+    }
+
+    ULOG1(INFO) << tfm::format("Format %d private key(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, true).run(fileJobs, [this, &format, &privateKeys](const FileJob& fileJob) {
+        const auto& privateKey = privateKeys.at(fileJob.inputFile);
+        Crypto::Bytes formattedKey;
+        if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_PEM) {
+            formattedKey = Crypto::KeyPair::privateKeyToPEM(
+                    privateKey.unlockedKey(), privateKey.password().bytesValue());
+        } else if (format == arg::value::VIRGIL_KEY_FORMAT_KEY_FORMAT_DER) {
+            formattedKey = Crypto::KeyPair::privateKeyToDER(
+                    privateKey.unlockedKey(), privateKey.password().bytesValue());
+        } else {
+            throw ArgumentLogicError("Unexpected key format is given. Validation should fail first.");
+        }
+        auto output = getArgumentIO()->getFileSink(fileJob.outputFile);
+        output.write(formattedKey);
+        output.flush();
+    });
+    if (failedCount > 0) {
+        throw ArgumentRuntimeError(
+                tfm::format("Formatting failed for %d of %d private key(s).", failedCount, fileJobs.size()));
+    }
 }
@@ -67,7 +67,9 @@ void KeyToPubCommand::doProcess() const {
     ULOG1(INFO) << "Read arguments.";
     auto privateKey = getArgumentIO()->getPrivateKeyFromInput(ArgumentImportance::Optional);
     ULOG1(INFO)  << "Extract public key.";
-    auto publicKey = Crypto::KeyPair::extractPublicKey(privateKey.key(), privateKey.password().bytesValue());
+    auto publicKey = privateKey.extractPublic().key();
     ULOG1(INFO)  << "Write public key to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(publicKey);
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(publicKey);
+    output.flush();
 }
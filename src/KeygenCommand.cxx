@@ -70,5 +70,7 @@ void KeygenCommand::doProcess() const {
     ULOG1(INFO)  << "Generate private key.";
     VirgilKeyPair keyPair = VirgilKeyPair::generate(keyAlgorithm, keyPassword.bytesValue());
     ULOG1(INFO)  << "Write private key to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(keyPair.privateKey());
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(keyPair.privateKey());
+    output.flush();
 }
@@ -36,6 +36,9 @@
 
 #include <cli/io/Logger.h>
 
+// Storage is defined within the library, so applications that link it do not initialize logger.
+INITIALIZE_EASYLOGGINGPP
+
 using cli::io::UserLogDispatchCallback;
 
 void UserLogDispatchCallback::handle(const el::LogDispatchData* dispatchData) {
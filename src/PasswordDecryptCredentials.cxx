@@ -36,11 +36,16 @@
 
 #include <cli/model/PasswordDecryptCredentials.h>
 
+using cli::model::ContentInfo;
 using cli::model::PasswordDecryptCredentials;
 
 PasswordDecryptCredentials::PasswordDecryptCredentials(Password password)
         : password_(std::move(password)) {}
 
+bool PasswordDecryptCredentials::doIsRecipientOf(const ContentInfo& contentInfo) const {
+    return contentInfo.hasPasswordRecipient();
+}
+
 bool PasswordDecryptCredentials::doDecrypt(
         Crypto::StreamCipher& cipher, Crypto::DataSource& source, Crypto::DataSink& sink) const {
     cipher.decryptWithPassword(source, sink, password_.bytesValue());
@@ -0,0 +1,122 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/model/PipelinedDataSink.h>
+
+#include <cli/crypto/Crypto.h>
+#include <cli/concurrency/BoundedQueue.h>
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+using cli::Crypto;
+using cli::model::PipelinedDataSink;
+using cli::concurrency::BoundedQueue;
+
+class PipelinedDataSink::Impl {
+public:
+    Impl(Crypto::DataSink& sink, size_t depth) : sink(sink), chunks(depth), failed(false), error(), writer() {
+    }
+
+    void run() {
+        try {
+            Crypto::Bytes chunk;
+            while (chunks.pop(chunk)) {
+                sink.write(chunk);
+                if (!sink.isGood()) {
+                    fail();
+                    return;
+                }
+            }
+        } catch (...) {
+            error = std::current_exception();
+            fail();
+        }
+    }
+
+    void fail() {
+        failed = true;
+        chunks.cancel();
+    }
+
+    void join() {
+        if (writer.joinable()) {
+            writer.join();
+        }
+    }
+
+public:
+    Crypto::DataSink& sink;
+    BoundedQueue<Crypto::Bytes> chunks;
+    std::atomic<bool> failed;
+    std::exception_ptr error;
+    std::thread writer;
+};
+
+PipelinedDataSink::PipelinedDataSink(Crypto::DataSink& sink, size_t depth) : impl_(new Impl(sink, depth)) {
+    impl_->writer = std::thread(&Impl::run, impl_.get());
+}
+
+PipelinedDataSink::~PipelinedDataSink() noexcept {
+    if (impl_->writer.joinable()) {
+        impl_->chunks.cancel();
+        impl_->join();
+    }
+}
+
+void PipelinedDataSink::finish() {
+    impl_->chunks.close();
+    impl_->join();
+    if (impl_->error) {
+        std::rethrow_exception(impl_->error);
+    }
+}
+
+bool PipelinedDataSink::isGood() {
+    return !impl_->failed;
+}
+
+void PipelinedDataSink::write(const Crypto::Bytes& data) {
+    if (!impl_->chunks.push(data) && impl_->failed) {
+        // Error is accessible only after writer is stopped.
+        impl_->join();
+        if (impl_->error) {
+            std::rethrow_exception(impl_->error);
+        }
+    }
+}
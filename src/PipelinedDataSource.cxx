@@ -0,0 +1,108 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/model/PipelinedDataSource.h>
+
+#include <cli/crypto/Crypto.h>
+#include <cli/concurrency/BoundedQueue.h>
+
+#include <exception>
+#include <thread>
+
+using cli::Crypto;
+using cli::model::PipelinedDataSource;
+using cli::concurrency::BoundedQueue;
+
+class PipelinedDataSource::Impl {
+public:
+    Impl(Crypto::DataSource& source, size_t depth) : source(source), chunks(depth), error(), reader() {
+    }
+
+    void run() {
+        try {
+            while (source.hasData()) {
+                if (!chunks.push(source.read())) {
+                    break;
+                }
+            }
+        } catch (...) {
+            // Queue closing below makes error visible to the consumer.
+            error = std::current_exception();
+        }
+        chunks.close();
+    }
+
+    void rethrowError() const {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+public:
+    Crypto::DataSource& source;
+    BoundedQueue<Crypto::Bytes> chunks;
+    std::exception_ptr error;
+    std::thread reader;
+};
+
+PipelinedDataSource::PipelinedDataSource(Crypto::DataSource& source, size_t depth)
+        : impl_(new Impl(source, depth)) {
+    impl_->reader = std::thread(&Impl::run, impl_.get());
+}
+
+PipelinedDataSource::~PipelinedDataSource() noexcept {
+    impl_->chunks.cancel();
+    if (impl_->reader.joinable()) {
+        impl_->reader.join();
+    }
+}
+
+bool PipelinedDataSource::hasData() {
+    if (impl_->chunks.waitNotEmpty()) {
+        return true;
+    }
+    impl_->rethrowError();
+    return false;
+}
+
+Crypto::Bytes PipelinedDataSource::read() {
+    Crypto::Bytes result;
+    if (!impl_->chunks.pop(result)) {
+        impl_->rethrowError();
+    }
+    return result;
+}
@@ -36,13 +36,121 @@
 
 #include <cli/model/PrivateKey.h>
 
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <virgil/crypto/VirgilCryptoException.h>
+
+#include <chrono>
+#include <list>
+#include <mutex>
+
 using cli::Crypto;
 using cli::model::PublicKey;
 using cli::model::PrivateKey;
 using cli::model::SecureValue;
+using virgil::crypto::VirgilCryptoException;
+
+namespace {
+
+/**
+ * @brief Compare given secrets in the time that does not depend on the position of the first mismatch.
+ */
+bool isEqualSecret(const Crypto::Bytes& expected, const Crypto::Bytes& given) {
+    unsigned char difference = expected.size() == given.size() ? 0 : 1;
+    for (size_t i = 0; i < given.size(); ++i) {
+        difference |= static_cast<unsigned char>((i < expected.size() ? expected[i] : 0) ^ given[i]);
+    }
+    return difference == 0;
+}
+
+/**
+ * @brief Process wide cache of the decrypted private keys, mapped by the encrypted private key.
+ *
+ * Cache is bounded: least recently used entry is evicted when cache is full,
+ * and entries expire after kTtl, so long running processes (batch) do not keep keys forever.
+ * Pinned entries are not counted, never expire, and are used by the command server,
+ * that unlocks keys once for all its commands.
+ */
+class UnlockedKeyCache {
+public:
+    static constexpr const size_t kMaxEntries = 16;
+    static constexpr const std::chrono::seconds kTtl = std::chrono::seconds(300); // 5 minutes
+
+    static UnlockedKeyCache& instance() {
+        static UnlockedKeyCache cache;
+        return cache;
+    }
+
+    bool find(const Crypto::Bytes& key, const SecureValue& password, SecureValue& unlockedKey) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& entry : pinned_) {
+            if (entry.key == key && isEqualSecret(entry.password.bytesValue(), password.bytesValue())) {
+                unlockedKey = entry.unlockedKey;
+                return true;
+            }
+        }
+        removeExpired();
+        for (auto entry = entries_.begin(); entry != entries_.end(); ++entry) {
+            if (entry->key == key) {
+                if (!isEqualSecret(entry->password.bytesValue(), password.bytesValue())) {
+                    return false;
+                }
+                unlockedKey = entry->unlockedKey;
+                // Keys that are used often stay unlocked.
+                entry->expiresAt = std::chrono::steady_clock::now() + kTtl;
+                entries_.splice(entries_.begin(), entries_, entry);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void add(const Crypto::Bytes& key, const SecureValue& password, const SecureValue& unlockedKey) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.remove_if([&key](const Entry& entry) { return entry.key == key; });
+        entries_.push_front(Entry{ key, password, unlockedKey, std::chrono::steady_clock::now() + kTtl });
+        while (entries_.size() > kMaxEntries) {
+            entries_.pop_back();
+        }
+    }
+
+    void pin(const Crypto::Bytes& key, const SecureValue& password, const SecureValue& unlockedKey) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.remove_if([&key](const Entry& entry) { return entry.key == key; });
+        pinned_.remove_if([&key](const Entry& entry) { return entry.key == key; });
+        pinned_.push_back(Entry{ key, password, unlockedKey, std::chrono::steady_clock::time_point::max() });
+    }
+
+private:
+    struct Entry {
+        Crypto::Bytes key;
+        SecureValue password;
+        SecureValue unlockedKey;
+        std::chrono::steady_clock::time_point expiresAt;
+    };
+
+    void removeExpired() {
+        const auto now = std::chrono::steady_clock::now();
+        entries_.remove_if([&now](const Entry& entry) { return entry.expiresAt <= now; });
+    }
+
+private:
+    std::mutex mutex_;
+    // Most recently used entries go first.
+    std::list<Entry> entries_;
+    std::list<Entry> pinned_;
+};
+
+constexpr const std::chrono::seconds UnlockedKeyCache::kTtl;
+
+}
 
 PublicKey PrivateKey::extractPublic() const {
-    return PublicKey(Crypto::KeyPair::extractPublicKey(key(), password_.bytesValue()), identifier());
+    if (publicKey_.empty()) {
+        publicKey_ = Crypto::KeyPair::extractPublicKey(unlockedKey(), Crypto::Bytes());
+    }
+    return PublicKey(publicKey_, identifier());
 }
 
 bool PrivateKey::isEncrypted() const {
@@ -60,6 +168,41 @@ SecureValue PrivateKey::password() const {
 bool PrivateKey::checkPassword(const SecureValue& keySecureValue) const {
     return Crypto::KeyPair::checkPrivateKeyPassword(key(), keySecureValue.bytesValue());
 }
+
 bool PrivateKey::checkPassword() const {
     return Crypto::KeyPair::checkPrivateKeyPassword(key(), password_.bytesValue());
 }
+
+bool PrivateKey::unlock(const SecureValue& keyPassword, CacheMode cacheMode) {
+    auto& cache = UnlockedKeyCache::instance();
+    SecureValue unlockedKey;
+    const bool isCached = cacheMode != CacheMode::None && cache.find(key(), keyPassword, unlockedKey);
+    if (isCached) {
+        DLOG(INFO) << "Use cached unlocked private key.";
+    } else {
+        try {
+            unlockedKey = SecureValue(Crypto::KeyPair::decryptPrivateKey(key(), keyPassword.bytesValue()));
+        } catch (const VirgilCryptoException&) {
+            return false;
+        }
+    }
+    if (cacheMode == CacheMode::Pinned) {
+        cache.pin(key(), keyPassword, unlockedKey);
+    } else if (cacheMode == CacheMode::Shared && !isCached) {
+        cache.add(key(), keyPassword, unlockedKey);
+    }
+    unlockedKey_ = std::move(unlockedKey);
+    password_ = keyPassword;
+    publicKey_.clear();
+    return true;
+}
+
+const Crypto::Bytes& PrivateKey::unlockedKey() const {
+    if (!unlockedKey_.bytesValue().empty()) {
+        return unlockedKey_.bytesValue();
+    }
+    if (isEncrypted()) {
+        throw error::ArgumentRuntimeError("Private key is encrypted, but password was not given.");
+    }
+    return key();
+}
@@ -74,5 +74,7 @@ void SecretAliasCommand::doProcess() const {
     auto secretAlias = keyDerivation.derive(secretValue.readAll());
 
     ULOG1(INFO) << "Write secret alias to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(Crypto::ByteUtils::bytesToHex(secretAlias));
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(Crypto::ByteUtils::bytesToHex(secretAlias));
+    output.flush();
 }
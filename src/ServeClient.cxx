@@ -0,0 +1,103 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/io/ServeClient.h>
+
+#include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/AgentChannel.h>
+#include <cli/io/Logger.h>
+
+#include <cstring>
+
+#if OS_UNIX
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#endif //OS_UNIX
+
+using cli::Crypto;
+using cli::io::AgentChannel;
+using cli::io::ServeClient;
+using cli::io::UnixSocket;
+
+static std::string currentDir() {
+#if OS_UNIX
+    std::vector<char> buffer(PATH_MAX);
+    while (::getcwd(buffer.data(), buffer.size()) == nullptr) {
+        if (errno != ERANGE) {
+            throw cli::error::ArgumentRuntimeError(
+                    tfm::format("Can not get current directory: %s", std::strerror(errno)));
+        }
+        buffer.resize(buffer.size() * 2);
+    }
+    return std::string(buffer.data());
+#else
+    throw cli::error::ArgumentRuntimeError("Command server is not supported on this platform.");
+#endif //OS_UNIX
+}
+
+ServeClient::ServeClient(const std::string& socketPath) : socket_(UnixSocket::connect(socketPath)) {
+}
+
+int ServeClient::run(const std::vector<std::string>& arguments) {
+    std::vector<Crypto::Bytes> fields;
+    const auto workingDir = currentDir();
+    fields.emplace_back(workingDir.cbegin(), workingDir.cend());
+    for (const auto& argument : arguments) {
+        fields.emplace_back(argument.cbegin(), argument.cend());
+    }
+    socket_.writeDescriptors({ 0, 1, 2 });
+    AgentChannel channel(std::move(socket_));
+    channel.write(AgentChannel::Message::Run, AgentChannel::pack(fields));
+
+    auto response = AgentChannel::Message::Failure;
+    Crypto::Bytes payload;
+    if (!channel.read(response, payload)) {
+        throw error::ArgumentRuntimeError("Command server closed connection unexpectedly.");
+    }
+    if (response == AgentChannel::Message::Failure) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Command server failed: %s", std::string(payload.cbegin(), payload.cend())));
+    }
+    if (response != AgentChannel::Message::Exit || payload.size() != 4) {
+        throw error::ArgumentRuntimeError("Command server returned malformed response.");
+    }
+    return static_cast<int>(
+            (static_cast<unsigned>(payload[0]) << 24) | (static_cast<unsigned>(payload[1]) << 16) |
+            (static_cast<unsigned>(payload[2]) << 8) | static_cast<unsigned>(payload[3]));
+}
@@ -0,0 +1,275 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/command/ServeCommand.h>
+
+#include <cli/api/api.h>
+#include <cli/api/Application.h>
+#include <cli/api/Configurations.h>
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/AgentChannel.h>
+#include <cli/io/Logger.h>
+#include <cli/io/Path.h>
+#include <cli/io/UnixSocket.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+#if OS_UNIX
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif //OS_UNIX
+
+using cli::Crypto;
+using cli::command::ServeCommand;
+using cli::argument::ArgumentImportance;
+using cli::argument::ArgumentParseOptions;
+using cli::concurrency::ThreadPool;
+using cli::io::AgentChannel;
+using cli::io::Path;
+using cli::io::UnixSocket;
+
+#if OS_UNIX
+
+namespace {
+
+constexpr const int kAcceptTimeoutMs = 500;
+
+/**
+ * @brief Number of the passed descriptors: stdin, stdout, stderr.
+ */
+constexpr const size_t kStandardDescriptors_Count = 3;
+
+volatile std::sig_atomic_t gIsStopRequested = 0;
+
+extern "C" void requestStop(int) {
+    gIsStopRequested = 1;
+}
+
+void installSignalHandlers() {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    action.sa_handler = requestStop;
+    sigemptyset(&action.sa_mask);
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+    ::sigaction(SIGHUP, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+}
+
+void resetSignalHandlers() {
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    std::signal(SIGHUP, SIG_DFL);
+    std::signal(SIGPIPE, SIG_DFL);
+}
+
+/**
+ * @brief Wait for the finished commands.
+ * @param shouldBlock - if true, then wait until at least one command is finished, or signal is received.
+ * @return Number of the finished commands.
+ */
+size_t reapCommands(bool shouldBlock) {
+    size_t result = 0;
+    int status = 0;
+    pid_t pid = 0;
+    while ((pid = ::waitpid(-1, &status, (shouldBlock && result == 0) ? 0 : WNOHANG)) > 0) {
+        ++result;
+    }
+    return result;
+}
+
+Crypto::Bytes encodeExitCode(int exitCode) {
+    const auto value = static_cast<unsigned>(exitCode);
+    return Crypto::Bytes {
+            static_cast<unsigned char>(value >> 24), static_cast<unsigned char>(value >> 16),
+            static_cast<unsigned char>(value >> 8), static_cast<unsigned char>(value)
+    };
+}
+
+/**
+ * @brief Terminate command if client has gone, i.e. it was interrupted by the user.
+ */
+void watchClient(AgentChannel& channel) {
+    std::thread([&channel]() {
+        AgentChannel::Message type;
+        Crypto::Bytes payload;
+        try {
+            while (channel.read(type, payload)) {
+            }
+        } catch (const std::exception&) {
+        }
+        std::raise(SIGTERM);
+    }).detach();
+}
+
+/**
+ * @brief Run command received over the given connection within the standard streams of the client.
+ * @note Is called within the process forked from the server, and never returns.
+ */
+void runCommand(UnixSocket connection) {
+    int exitCode = EXIT_FAILURE;
+    try {
+        auto descriptors = connection.readDescriptors(kStandardDescriptors_Count);
+        if (descriptors.empty()) {
+            ::_exit(EXIT_FAILURE);
+        }
+        AgentChannel channel(std::move(connection));
+        AgentChannel::Message type;
+        Crypto::Bytes payload;
+        if (!channel.read(type, payload) || type != AgentChannel::Message::Run) {
+            throw cli::error::ArgumentRuntimeError("Malformed command request.");
+        }
+        const auto fields = AgentChannel::unpack(payload);
+        if (fields.size() < 2) {
+            throw cli::error::ArgumentRuntimeError("Malformed command request.");
+        }
+        const std::string workingDir(fields[0].cbegin(), fields[0].cend());
+        if (::chdir(workingDir.c_str()) != 0) {
+            const std::string message = tfm::format("Can not change directory to '%s': %s",
+                    workingDir, std::strerror(errno));
+            channel.write(AgentChannel::Message::Failure, Crypto::Bytes(message.cbegin(), message.cend()));
+            ::_exit(EXIT_FAILURE);
+        }
+        for (size_t i = 0; i < descriptors.size(); ++i) {
+            ::dup2(descriptors[i], static_cast<int>(i));
+            ::close(descriptors[i]);
+        }
+        std::vector<std::string> arguments;
+        for (auto it = fields.cbegin() + 1; it != fields.cend(); ++it) {
+            arguments.emplace_back(it->cbegin(), it->cend());
+        }
+        std::vector<const char*> argv;
+        for (const auto& argument : arguments) {
+            argv.push_back(argument.c_str());
+        }
+        argv.push_back(nullptr);
+        const auto argc = static_cast<int>(arguments.size());
+
+        watchClient(channel);
+        cli::Configurations::applyArguments(argc, argv.data());
+        exitCode = cli::Application::runCommand(argc, argv.data());
+        std::cout.flush();
+        std::cerr.flush();
+        el::Loggers::flushAll();
+        channel.write(AgentChannel::Message::Exit, encodeExitCode(exitCode));
+    } catch (const std::exception& exception) {
+        LOG(WARNING) << tfm::format("Command server request failed: %s", exception.what());
+    }
+    ::_exit(exitCode);
+}
+
+}
+
+#endif //OS_UNIX
+
+const char* ServeCommand::doGetName() const {
+    return arg::value::VIRGIL_COMMAND_SERVE;
+}
+
+const char* ServeCommand::doGetUsage() const {
+    return usage::VIRGIL_SERVE;
+}
+
+ArgumentParseOptions ServeCommand::doGetArgumentParseOptions() const {
+    return ArgumentParseOptions().disableOptionsFirst();
+}
+
+void ServeCommand::doProcess() const {
+#if OS_UNIX
+    ULOG1(INFO) << "Read arguments.";
+    auto socketPath = getArgumentIO()->getServeSocket(ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    if (jobs == arg::value::VIRGIL_JOBS_AUTO) {
+        jobs = ThreadPool::hardwareConcurrency();
+    }
+    // Unlocked keys are kept in the process wide cache, that is inherited by the commands.
+    auto privateKeys = getArgumentIO()->getServeKeys(ArgumentImportance::Optional);
+
+    ULOG1(INFO) << tfm::format("Listen on the socket '%s'.", socketPath);
+    const auto socketDir = socketPath.substr(0, socketPath.find_last_of(Path::pathSeparator()));
+    if (!socketDir.empty() && socketDir != socketPath) {
+        Path::createDir(socketDir);
+    }
+    auto listener = UnixSocket::listen(socketPath);
+    installSignalHandlers();
+    ULOG(INFO) << tfm::format("Command server holds %d Private Key(s) and is listening on '%s'.",
+            privateKeys.size(), socketPath);
+
+    size_t runningCount = 0;
+    while (!gIsStopRequested) {
+        runningCount -= reapCommands(false);
+        if (runningCount >= jobs) {
+            runningCount -= reapCommands(true);
+            continue;
+        }
+        auto connection = listener.accept(kAcceptTimeoutMs);
+        if (!connection.isValid()) {
+            continue;
+        }
+        if (!connection.isPeerOwner()) {
+            LOG(WARNING) << "Connection from the process of another user is rejected.";
+            continue;
+        }
+        // Prevent output buffered by the server from being written twice.
+        std::cout.flush();
+        std::cerr.flush();
+        el::Loggers::flushAll();
+        const auto pid = ::fork();
+        if (pid < 0) {
+            LOG(WARNING) << tfm::format("Can not start command: %s", std::strerror(errno));
+            continue;
+        }
+        if (pid == 0) {
+            listener.detach();
+            resetSignalHandlers();
+            runCommand(std::move(connection));
+        }
+        ++runningCount;
+    }
+    ULOG1(INFO) << "Stop command server.";
+#else
+    throw error::ArgumentRuntimeError("Command server is not supported on this platform.");
+#endif //OS_UNIX
+}
@@ -0,0 +1,245 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/model/ServiceClient.h>
+
+#include <cli/api/api.h>
+#include <cli/concurrency/ConcurrentTaskRunner.h>
+#include <cli/concurrency/ThreadPool.h>
+#include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/memory.h>
+
+#include <virgil/sdk/crypto/Crypto.h>
+#include <virgil/sdk/client/CardValidator.h>
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+#if OS_UNIX
+#include <unistd.h>
+#endif
+
+using cli::Crypto;
+using cli::concurrency::ConcurrentTaskRunner;
+using cli::concurrency::ThreadPool;
+using cli::model::Card;
+using cli::model::CardIdentityGroup;
+using cli::model::CardScope;
+using cli::model::ServiceClient;
+
+using virgil::sdk::client::Client;
+using virgil::sdk::client::CardValidator;
+using virgil::sdk::client::ServiceConfig;
+using virgil::sdk::client::models::SearchCardsCriteria;
+using ServiceCrypto = virgil::sdk::crypto::Crypto;
+
+namespace {
+
+constexpr const size_t kParallelValidation_Min = 16;
+
+constexpr const size_t kSearchBatchSize = 100;
+constexpr const size_t kSearchConcurrency = 8;
+
+/**
+ * @brief Fingerprints of the Virgil Cards which signatures are verified by this process.
+ */
+class VerifiedCards {
+public:
+    static VerifiedCards& instance() {
+        static VerifiedCards verifiedCards;
+        return verifiedCards;
+    }
+
+    bool contains(const std::string& fingerprint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return fingerprints_.count(fingerprint) > 0;
+    }
+
+    void add(std::string fingerprint) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fingerprints_.insert(std::move(fingerprint));
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_set<std::string> fingerprints_;
+};
+
+std::string fingerprint_of(const Card& card) {
+    const auto hash = Crypto::Hash(Crypto::HashAlgorithm::SHA256).hash(
+            Crypto::ByteUtils::stringToBytes(card.exportAsString()));
+    return Crypto::ByteUtils::bytesToString(hash);
+}
+
+bool verify(const Card& card) {
+    // Each thread keeps its own validator, so it is created once per thread, not per Virgil Card.
+    thread_local const CardValidator validator(std::make_shared<ServiceCrypto>());
+    return validator.validateCardResponse(card.cardResponse());
+}
+
+/**
+ * @brief Return process wide pool for the validation of the large search results.
+ *
+ * Pool is created on the first call and is shared by all calls, so validators kept by its threads are reused.
+ * Pool is never destroyed, because validation can be requested until the process exit.
+ * Forked process (virgil-serve command) does not inherit threads of the pool, so it creates own pool.
+ */
+ThreadPool& validation_pool() {
+    static std::mutex mutex;
+    static ThreadPool* pool = nullptr;
+    std::lock_guard<std::mutex> lock(mutex);
+#if OS_UNIX
+    static pid_t poolOwner = 0;
+    if (poolOwner != ::getpid()) {
+        // Pool of the parent process has no threads here, and can not be destroyed.
+        pool = nullptr;
+        poolOwner = ::getpid();
+    }
+#endif //OS_UNIX
+    if (pool == nullptr) {
+        pool = new ThreadPool();
+    }
+    return *pool;
+}
+
+}
+
+std::shared_ptr<Client> ServiceClient::get(const std::string& accessToken) {
+    if (accessToken.empty()) {
+        throw error::ArgumentNotFoundError(arg::value::VIRGIL_CONFIG_APP_ACCESS_TOKEN);
+    }
+    static std::mutex mutex;
+    static std::map<std::string, std::shared_ptr<Client>> clients;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& client = clients[accessToken];
+    if (!client) {
+        ULOG3(INFO) << "Create client of the Virgil services.";
+        auto serviceConfig = ServiceConfig::createConfig(accessToken);
+        client = std::make_shared<Client>(std::move(serviceConfig));
+    }
+    return client;
+}
+
+bool ServiceClient::isValid(const Card& card) {
+    auto fingerprint = fingerprint_of(card);
+    if (VerifiedCards::instance().contains(fingerprint)) {
+        return true;
+    }
+    if (!verify(card)) {
+        return false;
+    }
+    VerifiedCards::instance().add(std::move(fingerprint));
+    return true;
+}
+
+void ServiceClient::validate(const Card& card) {
+    if (!isValid(card)) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Virgil Card '%s' has invalid signature.", card.identifier()));
+    }
+}
+
+void ServiceClient::validate(const std::vector<Card>& cards) {
+    if (cards.size() < kParallelValidation_Min) {
+        for (const auto& card : cards) {
+            validate(card);
+        }
+        return;
+    }
+    auto& validationPool = validation_pool();
+    const auto rangeSize = (cards.size() + validationPool.size() - 1) / validationPool.size();
+    ULOG3(INFO) << tfm::format("Verify %d Virgil Card(s) with %d thread(s).", cards.size(), validationPool.size());
+    std::vector<std::future<void>> ranges;
+    std::exception_ptr firstError;
+    try {
+        for (size_t begin = 0; begin < cards.size(); begin += rangeSize) {
+            const auto end = std::min(begin + rangeSize, cards.size());
+            ranges.push_back(validationPool.submit([&cards, begin, end]() {
+                for (size_t i = begin; i < end; ++i) {
+                    validate(cards[i]);
+                }
+            }));
+        }
+    } catch (...) {
+        firstError = std::current_exception();
+    }
+    // Tasks refer to the given cards, and pool outlives this call, so every task must be finished before return.
+    for (auto& range : ranges) {
+        try {
+            range.get();
+        } catch (...) {
+            if (!firstError) {
+                firstError = std::current_exception();
+            }
+        }
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
+void ServiceClient::searchCards(
+        const std::shared_ptr<Client>& client, const CardIdentityGroup& identityGroup, CardScope scope,
+        const SearchHandler& handler) {
+    std::vector<SearchBatch> batches;
+    for (const auto& cardIdentity : identityGroup.identities()) {
+        const auto& identities = cardIdentity.second;
+        for (size_t begin = 0; begin < identities.size(); begin += kSearchBatchSize) {
+            const auto end = std::min(begin + kSearchBatchSize, identities.size());
+            batches.push_back(SearchBatch{ cardIdentity.first,
+                    std::vector<std::string>(identities.cbegin() + begin, identities.cbegin() + end) });
+        }
+    }
+    ULOG1(INFO) << tfm::format("Search for Virgil Cards in %d batch(es).", batches.size());
+    ConcurrentTaskRunner<std::vector<Card>>(kSearchConcurrency).run(batches.size(),
+            [&client, &batches, scope](size_t index) {
+                const auto& batch = batches[index];
+                auto searchCriteria = SearchCardsCriteria::createCriteria(
+                        batch.identities, scope, batch.identityType);
+                return client->searchCards(searchCriteria).get();
+            },
+            [&batches, &handler](size_t index, std::vector<Card>& cards) {
+                validate(cards);
+                handler(batches[index], cards);
+            });
+}
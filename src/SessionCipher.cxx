@@ -0,0 +1,257 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/model/SessionCipher.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+#include <cli/model/KeyEnvelope.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+using cli::Crypto;
+using cli::model::DecryptCredentials;
+using cli::model::EncryptCredentials;
+using cli::model::KeyEnvelope;
+using cli::model::SecureValue;
+using cli::model::SessionCipher;
+
+namespace {
+
+constexpr const unsigned char kHeaderMagic[] = { 'V', 'C', 'L', 'I', 'S', 'E', 'S', '1' };
+constexpr const unsigned char kMessageMagic[] = { 'V', 'C', 'L', 'I', 'M', 'S', 'G', '1' };
+constexpr const size_t kMagicSize = sizeof(kHeaderMagic);
+constexpr const size_t kSessionIdSize = 16;
+constexpr const size_t kHeaderSize = kMagicSize + kSessionIdSize + 4;
+constexpr const size_t kEnvelopeSize_Max = 16 * 1024 * 1024; // 16MB
+constexpr const size_t kKeySize = 32;
+constexpr const size_t kNonceSize = 12;
+constexpr const size_t kMessagePrefixSize = kMagicSize + kSessionIdSize + kNonceSize;
+
+void appendNumber(Crypto::Bytes& data, uint64_t value, size_t size) {
+    for (size_t i = size; i > 0; --i) {
+        data.push_back(static_cast<unsigned char>(value >> ((i - 1) * 8)));
+    }
+}
+
+uint64_t readNumber(const unsigned char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < size; ++i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+Crypto::Bytes makeAuthData(const Crypto::Bytes& sessionId) {
+    Crypto::Bytes authData(kMessageMagic, kMessageMagic + kMagicSize);
+    authData.insert(authData.end(), sessionId.cbegin(), sessionId.cend());
+    return authData;
+}
+
+Crypto::Bytes makeHeader(
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients,
+        const Crypto::Bytes& sessionId, const SecureValue& key) {
+    ULOG2(INFO) << tfm::format("Encrypt session key for %d recipient(s).", recipients.size());
+    const auto envelope = KeyEnvelope::wrap(recipients, key.bytesValue());
+
+    Crypto::Bytes header(kHeaderMagic, kHeaderMagic + kMagicSize);
+    header.insert(header.end(), sessionId.cbegin(), sessionId.cend());
+    appendNumber(header, envelope.size(), 4);
+    header.insert(header.end(), envelope.cbegin(), envelope.cend());
+    return header;
+}
+
+/**
+ * @brief Process wide cache of the sessions that were started by this process, mapped by the session header.
+ *
+ * Only started sessions are cached, because their key is generated by this process;
+ * key of the opened session is always decrypted with the given credentials.
+ */
+class SessionCache {
+public:
+    static SessionCache& instance() {
+        static SessionCache cache;
+        return cache;
+    }
+
+    std::shared_ptr<const SessionCipher> find(const Crypto::Bytes& header) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = sessions_.find(header);
+        return found != sessions_.end() ? found->second : nullptr;
+    }
+
+    void add(const std::shared_ptr<const SessionCipher>& session) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sessions_[session->header()] = session;
+    }
+
+private:
+    std::mutex mutex_;
+    std::map<Crypto::Bytes, std::shared_ptr<const SessionCipher>> sessions_;
+};
+
+}
+
+SessionCipher::SessionCipher(Crypto::Bytes header, Crypto::Bytes sessionId, SecureValue key, bool isStarted)
+        : header_(std::move(header)), sessionId_(std::move(sessionId)), key_(std::move(key)), isStarted_(isStarted),
+          messageCount_(0) {
+}
+
+std::shared_ptr<const SessionCipher> SessionCipher::start(
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients) {
+    if (recipients.empty()) {
+        throw error::ArgumentRuntimeError("Session can not be started. Any of the given recipients cannot be used.");
+    }
+    Crypto::Random random(Crypto::ByteUtils::stringToBytes("virgil-cli-session"));
+    auto sessionId = random.randomize(kSessionIdSize);
+    SecureValue key(random.randomize(kKeySize));
+
+    auto header = makeHeader(recipients, sessionId, key);
+    auto session = std::make_shared<const SessionCipher>(
+            std::move(header), std::move(sessionId), std::move(key), true);
+    SessionCache::instance().add(session);
+    return session;
+}
+
+std::shared_ptr<const SessionCipher> SessionCipher::find(const Crypto::Bytes& header) {
+    return SessionCache::instance().find(header);
+}
+
+std::shared_ptr<const SessionCipher> SessionCipher::open(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& recipients, const Crypto::Bytes& header) {
+    // Session key is never taken from the cache, so the credentials are always verified by the decryption.
+    const auto key = KeyEnvelope::unwrap(recipients, readEnvelope(header), kKeySize);
+    if (key.empty()) {
+        return nullptr;
+    }
+    return std::make_shared<const SessionCipher>(header, readSessionId(header), SecureValue(key), false);
+}
+
+Crypto::Bytes SessionCipher::rekey(
+        const std::vector<std::unique_ptr<DecryptCredentials>>& credentials,
+        const std::vector<std::unique_ptr<EncryptCredentials>>& recipients, const Crypto::Bytes& header) {
+    if (recipients.empty()) {
+        throw error::ArgumentRuntimeError("Session can not be re-keyed. Any of the given recipients cannot be used.");
+    }
+    const auto session = open(credentials, header);
+    if (!session) {
+        return Crypto::Bytes();
+    }
+    return makeHeader(recipients, session->sessionId_, session->key_);
+}
+
+Crypto::Bytes SessionCipher::readEnvelope(const Crypto::Bytes& header) {
+    if (header.size() < kHeaderSize || !isHeader(header)) {
+        throw error::ArgumentRuntimeError("Session header is malformed.");
+    }
+    const auto envelopeSize = readNumber(header.data() + kMagicSize + kSessionIdSize, 4);
+    if (envelopeSize == 0 || envelopeSize > kEnvelopeSize_Max || header.size() != kHeaderSize + envelopeSize) {
+        throw error::ArgumentRuntimeError("Session header is malformed.");
+    }
+    return Crypto::Bytes(header.cbegin() + kHeaderSize, header.cend());
+}
+
+Crypto::Bytes SessionCipher::readSessionId(const Crypto::Bytes& data) {
+    if (data.size() < kMagicSize + kSessionIdSize || !(isHeader(data) || isMessage(data))) {
+        throw error::ArgumentRuntimeError("Data is neither session header nor session message.");
+    }
+    return Crypto::Bytes(data.cbegin() + kMagicSize, data.cbegin() + kMagicSize + kSessionIdSize);
+}
+
+bool SessionCipher::isHeader(const Crypto::Bytes& data) {
+    return data.size() >= kMagicSize && std::equal(kHeaderMagic, kHeaderMagic + kMagicSize, data.cbegin());
+}
+
+bool SessionCipher::isMessage(const Crypto::Bytes& data) {
+    return data.size() >= kMagicSize && std::equal(kMessageMagic, kMessageMagic + kMagicSize, data.cbegin());
+}
+
+const Crypto::Bytes& SessionCipher::header() const {
+    return header_;
+}
+
+void SessionCipher::encrypt(Crypto::DataSource& source, Crypto::DataSink& sink) const {
+    if (!isStarted_) {
+        throw error::ArgumentLogicError("SessionCipher: only session started by this process can encrypt messages.");
+    }
+    Crypto::Bytes nonce(kNonceSize - 8, 0);
+    appendNumber(nonce, messageCount_++, 8);
+
+    Crypto::SymmetricCipher cipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM);
+    cipher.setEncryptionKey(key_.bytesValue());
+    cipher.setIV(nonce);
+    cipher.reset();
+    cipher.setAuthData(makeAuthData(sessionId_));
+
+    Crypto::Bytes prefix(kMessageMagic, kMessageMagic + kMagicSize);
+    prefix.insert(prefix.end(), sessionId_.cbegin(), sessionId_.cend());
+    prefix.insert(prefix.end(), nonce.cbegin(), nonce.cend());
+    sink.write(prefix);
+    while (source.hasData()) {
+        sink.write(cipher.update(source.read()));
+    }
+    sink.write(cipher.finish());
+}
+
+void SessionCipher::decrypt(Crypto::DataSource& source, Crypto::DataSink& sink) const {
+    Crypto::Bytes prefix;
+    while (prefix.size() < kMessagePrefixSize && source.hasData()) {
+        const auto data = source.read();
+        prefix.insert(prefix.end(), data.cbegin(), data.cend());
+    }
+    if (prefix.size() < kMessagePrefixSize || !isMessage(prefix)) {
+        throw error::ArgumentRuntimeError("Encrypted data is not a session message, or is truncated.");
+    }
+    if (!std::equal(sessionId_.cbegin(), sessionId_.cend(), prefix.cbegin() + kMagicSize)) {
+        throw error::ArgumentRuntimeError("Encrypted message belongs to another session.");
+    }
+    const Crypto::Bytes nonce(
+            prefix.cbegin() + kMagicSize + kSessionIdSize, prefix.cbegin() + kMessagePrefixSize);
+
+    Crypto::SymmetricCipher cipher(Crypto::SymmetricCipher::Algorithm::AES_256_GCM);
+    cipher.setDecryptionKey(key_.bytesValue());
+    cipher.setIV(nonce);
+    cipher.reset();
+    cipher.setAuthData(makeAuthData(sessionId_));
+
+    sink.write(cipher.update(Crypto::Bytes(prefix.cbegin() + kMessagePrefixSize, prefix.cend())));
+    while (source.hasData()) {
+        sink.write(cipher.update(source.read()));
+    }
+    sink.write(cipher.finish());
+}
@@ -37,17 +37,24 @@
 #include <cli/command/SignCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/api/Engine.h>
+#include <cli/concurrency/FileJobRunner.h>
 #include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
 
 #include <cli/io/Logger.h>
 #include <cli/memory.h>
 
 using cli::Crypto;
+using cli::Engine;
+using cli::SignOptions;
 using cli::command::SignCommand;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentSource;
 using cli::argument::ArgumentParseOptions;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
 
 const char* SignCommand::doGetName() const {
     return arg::value::VIRGIL_COMMAND_SIGN;
@@ -62,15 +69,43 @@ ArgumentParseOptions SignCommand::doGetArgumentParseOptions() const {
 }
 
 void SignCommand::doProcess() const {
+    if (getArgumentIO()->isMultiFile()) {
+        processFiles();
+        return;
+    }
     ULOG1(INFO) << "Read arguments.";
     auto data = getArgumentIO()->getInputSource(ArgumentImportance::Optional);
-    auto hashAlgorithm = getArgumentIO()->getHashAlgorithm(ArgumentImportance::Required);
-    auto privateKey = getArgumentIO()->getPrivateKey(ArgumentImportance::Required);
+    SignOptions options;
+    options.hashAlgorithm = getArgumentIO()->getHashAlgorithm(ArgumentImportance::Required);
+    options.signer = getArgumentIO()->getSignerCredentials(ArgumentImportance::Required);
 
-    ULOG1(INFO) << "Sign input data.";
-    Crypto::StreamSigner signer(hashAlgorithm);
-    auto signature = signer.sign(data, privateKey.key(), privateKey.password().bytesValue());
+    auto signature = Engine::sign(options, data);
 
     ULOG1(INFO) << "Write signature to the output.";
-    getArgumentIO()->getOutputSink(ArgumentImportance::Optional).write(signature);
+    auto output = getArgumentIO()->getOutputSink(ArgumentImportance::Optional);
+    output.write(signature);
+    output.flush();
+}
+
+void SignCommand::processFiles() const {
+    ULOG1(INFO) << "Read arguments.";
+    auto fileJobs = getArgumentIO()->getFileJobs(false, ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    // Signer is resolved once and shared by all files.
+    SignOptions options;
+    options.hashAlgorithm = getArgumentIO()->getHashAlgorithm(ArgumentImportance::Required);
+    options.signer = getArgumentIO()->getSignerCredentials(ArgumentImportance::Required);
+
+    ULOG1(INFO) << tfm::format("Sign %d file(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, true).run(fileJobs, [this, &options](const FileJob& fileJob) {
+        auto data = getArgumentIO()->getFileSource(fileJob.inputFile);
+        auto signature = Engine::sign(options, data);
+        auto output = getArgumentIO()->getFileSink(fileJob.outputFile);
+        output.write(signature);
+        output.flush();
+    });
+    if (failedCount > 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Signing failed for %d of %d file(s).", failedCount, fileJobs.size()));
+    }
 }
@@ -0,0 +1,412 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <cli/io/UnixSocket.h>
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <cstring>
+
+#if OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#endif //OS_UNIX
+
+using cli::io::UnixSocket;
+
+#if OS_UNIX
+
+namespace {
+
+#ifdef MSG_NOSIGNAL
+constexpr const int kSendFlags = MSG_NOSIGNAL;
+#else
+constexpr const int kSendFlags = 0;
+#endif
+
+sockaddr_un makeAddress(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw cli::error::ArgumentRuntimeError(tfm::format("Invalid socket path: '%s'.", path));
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    return address;
+}
+
+int createSocket() {
+    int descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        throw cli::error::ArgumentRuntimeError(tfm::format("Can not create socket: %s", std::strerror(errno)));
+    }
+    ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int enabled = 1;
+    ::setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+    return descriptor;
+}
+
+bool tryConnect(int descriptor, const sockaddr_un& address) {
+    int result = 0;
+    do {
+        result = ::connect(descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    } while (result != 0 && errno == EINTR);
+    return result == 0;
+}
+
+}
+
+UnixSocket::UnixSocket() : descriptor_(-1) {
+}
+
+UnixSocket::UnixSocket(int descriptor, std::string path) : descriptor_(descriptor), path_(std::move(path)) {
+}
+
+UnixSocket::UnixSocket(UnixSocket&& other) noexcept
+        : descriptor_(other.descriptor_), path_(std::move(other.path_)) {
+    other.descriptor_ = -1;
+    other.path_.clear();
+}
+
+UnixSocket& UnixSocket::operator=(UnixSocket&& other) noexcept {
+    if (this != &other) {
+        close();
+        descriptor_ = other.descriptor_;
+        path_ = std::move(other.path_);
+        other.descriptor_ = -1;
+        other.path_.clear();
+    }
+    return *this;
+}
+
+UnixSocket::~UnixSocket() noexcept {
+    close();
+}
+
+UnixSocket UnixSocket::connect(const std::string& path) {
+    const auto address = makeAddress(path);
+    UnixSocket result(createSocket());
+    if (!tryConnect(result.descriptor_, address)) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Can not connect to the socket '%s': %s", path, std::strerror(errno)));
+    }
+    return result;
+}
+
+UnixSocket UnixSocket::listen(const std::string& path) {
+    const auto address = makeAddress(path);
+    struct stat info;
+    if (::lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw error::ArgumentRuntimeError(tfm::format("Path '%s' exists and it is not a socket.", path));
+        }
+        UnixSocket probe(createSocket());
+        if (tryConnect(probe.descriptor_, address)) {
+            throw error::ArgumentRuntimeError(tfm::format("Socket '%s' is used by another process.", path));
+        }
+        LOG(INFO) << tfm::format("Remove stale socket '%s'.", path);
+        ::unlink(path.c_str());
+    }
+    UnixSocket result(createSocket());
+    const auto previousMask = ::umask(S_IRWXG | S_IRWXO | S_IXUSR);
+    const auto bindResult = ::bind(result.descriptor_, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    const auto bindError = errno;
+    ::umask(previousMask);
+    if (bindResult != 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Can not bind socket to the path '%s': %s", path, std::strerror(bindError)));
+    }
+    result.path_ = path;
+    if (::listen(result.descriptor_, SOMAXCONN) != 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Can not listen on the socket '%s': %s", path, std::strerror(errno)));
+    }
+    return result;
+}
+
+UnixSocket UnixSocket::accept(int timeoutMs) const {
+    pollfd request;
+    request.fd = descriptor_;
+    request.events = POLLIN;
+    request.revents = 0;
+    if (::poll(&request, 1, timeoutMs) <= 0) {
+        return UnixSocket();
+    }
+    int descriptor = ::accept(descriptor_, nullptr, nullptr);
+    if (descriptor < 0) {
+        if (errno != EINTR && errno != EAGAIN && errno != ECONNABORTED) {
+            LOG(WARNING) << tfm::format("Can not accept connection: %s", std::strerror(errno));
+        }
+        return UnixSocket();
+    }
+    ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+#ifdef SO_NOSIGPIPE
+    int enabled = 1;
+    ::setsockopt(descriptor, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif
+    return UnixSocket(descriptor);
+}
+
+bool UnixSocket::isValid() const {
+    return descriptor_ >= 0;
+}
+
+bool UnixSocket::isPeerOwner() const {
+#if OS_LINUX
+    ucred credentials;
+    socklen_t size = sizeof(credentials);
+    if (::getsockopt(descriptor_, SOL_SOCKET, SO_PEERCRED, &credentials, &size) != 0) {
+        return false;
+    }
+    return credentials.uid == ::geteuid();
+#else
+    uid_t uid = 0;
+    gid_t gid = 0;
+    if (::getpeereid(descriptor_, &uid, &gid) != 0) {
+        return false;
+    }
+    return uid == ::geteuid();
+#endif //OS_LINUX
+}
+
+void UnixSocket::write(const unsigned char* data, size_t size) {
+    while (size > 0) {
+        const auto written = ::send(descriptor_, data, size, kSendFlags);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw error::ArgumentRuntimeError(tfm::format("Failed to write to the socket: %s", std::strerror(errno)));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+bool UnixSocket::read(unsigned char* data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        const auto received = ::recv(descriptor_, data + total, size - total, 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw error::ArgumentRuntimeError(tfm::format("Failed to read from the socket: %s", std::strerror(errno)));
+        }
+        if (received == 0) {
+            if (total == 0) {
+                return false;
+            }
+            throw error::ArgumentRuntimeError("Connection was closed in the middle of the message.");
+        }
+        total += static_cast<size_t>(received);
+    }
+    return true;
+}
+
+void UnixSocket::writeDescriptors(const std::vector<int>& descriptors) {
+    unsigned char marker = static_cast<unsigned char>(descriptors.size());
+    iovec data;
+    data.iov_base = &marker;
+    data.iov_len = sizeof(marker);
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * descriptors.size()), 0);
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    auto header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(sizeof(int) * descriptors.size());
+    std::memcpy(CMSG_DATA(header), descriptors.data(), sizeof(int) * descriptors.size());
+    ssize_t written = 0;
+    do {
+        written = ::sendmsg(descriptor_, &message, kSendFlags);
+    } while (written < 0 && errno == EINTR);
+    if (written != sizeof(marker)) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Failed to pass descriptors to the socket: %s", std::strerror(errno)));
+    }
+}
+
+std::vector<int> UnixSocket::readDescriptors(size_t count) {
+    unsigned char marker = 0;
+    iovec data;
+    data.iov_base = &marker;
+    data.iov_len = sizeof(marker);
+    std::vector<char> control(CMSG_SPACE(sizeof(int) * count), 0);
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &data;
+    message.msg_iovlen = 1;
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+    ssize_t received = 0;
+    do {
+        received = ::recvmsg(descriptor_, &message, 0);
+    } while (received < 0 && errno == EINTR);
+    if (received < 0) {
+        throw error::ArgumentRuntimeError(
+                tfm::format("Failed to receive descriptors from the socket: %s", std::strerror(errno)));
+    }
+    std::vector<int> result;
+    for (auto header = CMSG_FIRSTHDR(&message); header != nullptr; header = CMSG_NXTHDR(&message, header)) {
+        if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+            const auto descriptorCount = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            const auto begin = reinterpret_cast<const int*>(CMSG_DATA(header));
+            for (size_t i = 0; i < descriptorCount; ++i) {
+                int descriptor = -1;
+                std::memcpy(&descriptor, begin + i, sizeof(descriptor));
+                ::fcntl(descriptor, F_SETFD, FD_CLOEXEC);
+                result.push_back(descriptor);
+            }
+        }
+    }
+    if (received == 0 && result.empty()) {
+        return result;
+    }
+    if (result.size() != count || marker != count || (message.msg_flags & MSG_CTRUNC) != 0) {
+        for (auto descriptor : result) {
+            ::close(descriptor);
+        }
+        throw error::ArgumentRuntimeError(tfm::format("Expected %d descriptors, but received %d.", count, result.size()));
+    }
+    return result;
+}
+
+void UnixSocket::shutdown() {
+    if (descriptor_ >= 0) {
+        ::shutdown(descriptor_, SHUT_RDWR);
+    }
+}
+
+void UnixSocket::close() noexcept {
+    if (descriptor_ >= 0) {
+        ::close(descriptor_);
+        descriptor_ = -1;
+    }
+    if (!path_.empty()) {
+        ::unlink(path_.c_str());
+        path_.clear();
+    }
+}
+
+void UnixSocket::detach() noexcept {
+    path_.clear();
+    close();
+}
+
+#else
+
+UnixSocket::UnixSocket() : descriptor_(-1) {
+}
+
+UnixSocket::UnixSocket(int descriptor, std::string path) : descriptor_(descriptor), path_(std::move(path)) {
+}
+
+UnixSocket::UnixSocket(UnixSocket&&) noexcept = default;
+
+UnixSocket& UnixSocket::operator=(UnixSocket&&) noexcept = default;
+
+UnixSocket::~UnixSocket() noexcept = default;
+
+UnixSocket UnixSocket::connect(const std::string& path) {
+    (void)path;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::listen(const std::string& path) {
+    (void)path;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+UnixSocket UnixSocket::accept(int timeoutMs) const {
+    (void)timeoutMs;
+    return UnixSocket();
+}
+
+bool UnixSocket::isValid() const {
+    return false;
+}
+
+bool UnixSocket::isPeerOwner() const {
+    return false;
+}
+
+void UnixSocket::write(const unsigned char* data, size_t size) {
+    (void)data;
+    (void)size;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+bool UnixSocket::read(unsigned char* data, size_t size) {
+    (void)data;
+    (void)size;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+void UnixSocket::writeDescriptors(const std::vector<int>& descriptors) {
+    (void)descriptors;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+std::vector<int> UnixSocket::readDescriptors(size_t count) {
+    (void)count;
+    throw error::ArgumentRuntimeError("UNIX domain sockets are not supported on this platform.");
+}
+
+void UnixSocket::shutdown() {
+}
+
+void UnixSocket::close() noexcept {
+}
+
+void UnixSocket::detach() noexcept {
+}
+
+#endif //OS_UNIX
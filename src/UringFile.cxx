@@ -0,0 +1,543 @@
+/**
+ * Copyright (C) 2015-2017 Virgil Security Inc.
+ *
+ * Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *     (1) Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *     (2) Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *
+ *     (3) Neither the name of the copyright holder nor the names of its
+ *     contributors may be used to endorse or promote products derived from
+ *     this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+ * INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+ * IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <cli/io/UringFile.h>
+
+#if USE_IO_URING
+
+#include <cli/error/ArgumentError.h>
+#include <cli/io/Logger.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#include <liburing.h>
+
+using cli::io::BufferPool;
+using cli::io::UringFileReader;
+using cli::io::UringFileWriter;
+
+namespace {
+
+/**
+ * @brief Owner of the io_uring instance and its registered buffers.
+ */
+class Ring {
+public:
+    Ring() : ring_(), isInitialized_(false), isRegistered_(false) {
+    }
+
+    ~Ring() noexcept {
+        if (isInitialized_) {
+            io_uring_queue_exit(&ring_);
+        }
+    }
+
+    /**
+     * @return false - if io_uring is not supported.
+     */
+    bool init(size_t queueDepth) {
+        const int result = io_uring_queue_init(static_cast<unsigned>(queueDepth), &ring_, 0);
+        if (result < 0) {
+            LOG(INFO) << tfm::format("io_uring is not available: %s.", std::strerror(-result));
+            return false;
+        }
+        isInitialized_ = true;
+        return true;
+    }
+
+    /**
+     * @brief Register buffers, so kernel does not map them on each request.
+     * @note Registration can fail due to RLIMIT_MEMLOCK, in this case buffers are used as regular.
+     */
+    void registerBuffers(const std::vector<BufferPool::Buffer>& buffers) {
+        std::vector<struct iovec> chunks(buffers.size());
+        for (size_t i = 0; i < buffers.size(); ++i) {
+            chunks[i].iov_base = buffers[i].data();
+            chunks[i].iov_len = buffers[i].capacity();
+        }
+        const int result = io_uring_register_buffers(&ring_, chunks.data(), static_cast<unsigned>(chunks.size()));
+        isRegistered_ = result == 0;
+        if (!isRegistered_) {
+            LOG(INFO) << tfm::format("io_uring buffers are not registered: %s.", std::strerror(-result));
+        }
+    }
+
+    void prepareRead(int fd, size_t bufferIndex, unsigned char* data, size_t size, size_t offset, size_t userData) {
+        auto sqe = getSubmissionEntry();
+        if (isRegistered_) {
+            io_uring_prep_read_fixed(sqe, fd, data, static_cast<unsigned>(size), offset, static_cast<int>(bufferIndex));
+        } else {
+            io_uring_prep_read(sqe, fd, data, static_cast<unsigned>(size), offset);
+        }
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(userData));
+    }
+
+    void prepareWrite(
+            int fd, size_t bufferIndex, const unsigned char* data, size_t size, size_t offset, size_t userData) {
+        auto sqe = getSubmissionEntry();
+        if (isRegistered_) {
+            io_uring_prep_write_fixed(sqe, fd, data, static_cast<unsigned>(size), offset, static_cast<int>(bufferIndex));
+        } else {
+            io_uring_prep_write(sqe, fd, data, static_cast<unsigned>(size), offset);
+        }
+        io_uring_sqe_set_data(sqe, reinterpret_cast<void*>(userData));
+    }
+
+    void submit() {
+        int result = 0;
+        do {
+            result = io_uring_submit(&ring_);
+        } while (result == -EINTR);
+        if (result < 0) {
+            throw cli::error::ArgumentRuntimeError(
+                    tfm::format("Failed to submit io_uring requests: %s", std::strerror(-result)));
+        }
+    }
+
+    /**
+     * @brief Wait for the next completion.
+     * @param userData - user data of the completed request.
+     * @return Request result.
+     */
+    int wait(size_t& userData) {
+        struct io_uring_cqe* cqe = nullptr;
+        int result = 0;
+        do {
+            result = io_uring_wait_cqe(&ring_, &cqe);
+        } while (result == -EINTR);
+        if (result < 0) {
+            throw cli::error::ArgumentRuntimeError(
+                    tfm::format("Failed to wait io_uring completion: %s", std::strerror(-result)));
+        }
+        userData = reinterpret_cast<size_t>(io_uring_cqe_get_data(cqe));
+        result = cqe->res;
+        io_uring_cqe_seen(&ring_, cqe);
+        return result;
+    }
+
+private:
+    struct io_uring_sqe* getSubmissionEntry() {
+        auto sqe = io_uring_get_sqe(&ring_);
+        if (sqe == nullptr) {
+            // Queue depth is equal to the number of buffers, so it can not be full.
+            throw cli::error::ArgumentLogicError("io_uring submission queue is full.");
+        }
+        return sqe;
+    }
+
+private:
+    struct io_uring ring_;
+    bool isInitialized_;
+    bool isRegistered_;
+};
+
+/**
+ * @brief Return true if error means that request should be repeated.
+ */
+inline bool isTransientError(int error) {
+    return error == -EINTR || error == -EAGAIN;
+}
+
+}
+
+class UringFileReader::Impl {
+public:
+    struct Slot {
+        size_t offset = 0;
+        size_t length = 0;
+        size_t filled = 0;
+        bool isInFlight = false;
+        bool isCompleted = false;
+    };
+
+    Impl(std::string fileName, int fd, size_t size, size_t blockSize, bool isDirect)
+            : fileName(std::move(fileName)), fd(fd), size(size), blockSize(blockSize), isDirect(isDirect), ring(),
+              buffers(), slots(), head(0), nextOffset(0), hasReturned(false) {
+    }
+
+    ~Impl() noexcept {
+        // Requests in flight refer to the buffers, so they must be completed first.
+        try {
+            for (auto& slot : slots) {
+                while (slot.isInFlight) {
+                    reap();
+                }
+            }
+        } catch (...) {
+        }
+        (void)::close(fd);
+    }
+
+    void start() {
+        for (size_t i = 0; i < slots.size(); ++i) {
+            schedule(i);
+        }
+        ring.submit();
+    }
+
+    Block next() {
+        if (hasReturned) {
+            // Buffer of the previously returned block can be reused.
+            schedule(head);
+            ring.submit();
+            head = (head + 1) % slots.size();
+            hasReturned = false;
+        }
+        auto& slot = slots[head];
+        if (!slot.isInFlight && !slot.isCompleted) {
+            return Block(nullptr, 0);
+        }
+        while (!slot.isCompleted) {
+            reap();
+        }
+        slot.isCompleted = false;
+        hasReturned = true;
+        return Block(buffers[head].data(), slot.filled);
+    }
+
+    size_t seek(size_t offset) {
+        // Requests in flight refer to the buffers, so they must be completed first.
+        for (auto& slot : slots) {
+            while (slot.isInFlight) {
+                reap();
+            }
+        }
+        head = 0;
+        hasReturned = false;
+        nextOffset = std::min(offset, size) / blockSize * blockSize;
+        const auto blockOffset = nextOffset;
+        start();
+        return blockOffset;
+    }
+
+private:
+    void schedule(size_t index) {
+        auto& slot = slots[index];
+        slot.filled = 0;
+        slot.isCompleted = false;
+        slot.isInFlight = false;
+        if (nextOffset >= size) {
+            return;
+        }
+        slot.offset = nextOffset;
+        slot.length = std::min(blockSize, size - nextOffset);
+        nextOffset += slot.length;
+        prepare(index);
+    }
+
+    void prepare(size_t index) {
+        auto& slot = slots[index];
+        // Request full block, because O_DIRECT requires aligned length; read stops at the end of file anyway.
+        // Filled size is kept aligned for O_DIRECT, see reap().
+        ring.prepareRead(fd, index, buffers[index].data() + slot.filled, blockSize - slot.filled,
+                slot.offset + slot.filled, index);
+        slot.isInFlight = true;
+    }
+
+    void reap() {
+        size_t index = 0;
+        const int result = ring.wait(index);
+        auto& slot = slots[index];
+        slot.isInFlight = false;
+        if (result < 0 && isTransientError(result)) {
+            prepare(index);
+            ring.submit();
+            return;
+        } else if (result < 0) {
+            throw cli::error::ArgumentRuntimeError(
+                    tfm::format("Failed to read file '%s': %s", fileName, std::strerror(-result)));
+        }
+        const auto previousFilled = slot.filled;
+        slot.filled += static_cast<size_t>(result);
+        if (result == 0 || slot.filled >= slot.length) {
+            slot.filled = std::min(slot.filled, slot.length);
+            slot.isCompleted = true;
+            return;
+        }
+        // Short read, request the rest of the block.
+        if (isDirect) {
+            // O_DIRECT requires aligned offset and length, so the partially read unit is read again.
+            const auto alignedFilled = slot.filled / BufferPool::kAlignment * BufferPool::kAlignment;
+            if (alignedFilled > previousFilled) {
+                slot.filled = alignedFilled;
+            } else {
+                disableDirect();
+            }
+        }
+        prepare(index);
+        ring.submit();
+    }
+
+    /**
+     * @brief Switch file to the buffered reading, so the rest of the block can be requested from unaligned offset.
+     */
+    void disableDirect() {
+        const int flags = ::fcntl(fd, F_GETFL);
+        if (flags < 0 || ::fcntl(fd, F_SETFL, flags & ~O_DIRECT) < 0) {
+            throw cli::error::ArgumentRuntimeError(
+                    tfm::format("Failed to read file '%s': %s", fileName, std::strerror(errno)));
+        }
+        isDirect = false;
+        LOG(INFO) << tfm::format("Unaligned short read, file '%s' is read without O_DIRECT.", fileName);
+    }
+
+public:
+    const std::string fileName;
+    const int fd;
+    const size_t size;
+    const size_t blockSize;
+    bool isDirect;
+    Ring ring;
+    std::vector<BufferPool::Buffer> buffers;
+    std::vector<Slot> slots;
+    size_t head;
+    size_t nextOffset;
+    bool hasReturned;
+};
+
+std::unique_ptr<UringFileReader> UringFileReader::create(
+        const std::string& fileName, std::shared_ptr<BufferPool> bufferPool, size_t queueDepth) {
+    struct stat info;
+    if (::stat(fileName.c_str(), &info) != 0 || !S_ISREG(info.st_mode) ||
+            static_cast<size_t>(info.st_size) <= bufferPool->bufferSize()) {
+        // Opening of FIFO affects its writer, so file type is checked before opening.
+        return nullptr;
+    }
+    const auto blockSize = bufferPool->bufferSize();
+    bool isDirect = blockSize % BufferPool::kAlignment == 0;
+    int fd = ::open(fileName.c_str(), O_RDONLY | (isDirect ? O_DIRECT : 0));
+    if (fd < 0 && isDirect && errno == EINVAL) {
+        // File system does not support O_DIRECT.
+        isDirect = false;
+        fd = ::open(fileName.c_str(), O_RDONLY);
+    }
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || static_cast<size_t>(info.st_size) <= blockSize) {
+        (void)::close(fd);
+        return nullptr;
+    }
+    queueDepth = std::max(queueDepth, size_t(1));
+    std::unique_ptr<Impl> impl(new Impl(fileName, fd, static_cast<size_t>(info.st_size), blockSize, isDirect));
+    if (!impl->ring.init(queueDepth)) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < queueDepth; ++i) {
+        impl->buffers.push_back(bufferPool->acquire());
+    }
+    impl->slots.resize(queueDepth);
+    impl->ring.registerBuffers(impl->buffers);
+    impl->start();
+    LOG(INFO) << tfm::format("Read file '%s' with io_uring.", fileName);
+    return std::unique_ptr<UringFileReader>(new UringFileReader(std::move(impl)));
+}
+
+UringFileReader::UringFileReader(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {
+}
+
+UringFileReader::~UringFileReader() noexcept = default;
+
+size_t UringFileReader::size() const {
+    return impl_->size;
+}
+
+UringFileReader::Block UringFileReader::next() {
+    return impl_->next();
+}
+
+size_t UringFileReader::seek(size_t offset) {
+    return impl_->seek(offset);
+}
+
+class UringFileWriter::Impl {
+public:
+    struct Slot {
+        size_t offset = 0;
+        size_t length = 0;
+        size_t written = 0;
+        bool isInFlight = false;
+    };
+
+    Impl(int fd, size_t blockSize)
+            : fd(fd), blockSize(blockSize), ring(), buffers(), slots(), current(0), nextOffset(0), isGood(true) {
+    }
+
+    ~Impl() noexcept {
+        try {
+            flush();
+        } catch (...) {
+        }
+        (void)::close(fd);
+    }
+
+    void write(const unsigned char* data, size_t size) {
+        while (size > 0 && isGood) {
+            auto& slot = slots[current];
+            while (slot.isInFlight) {
+                reap();
+            }
+            const auto copySize = std::min(size, blockSize - slot.length);
+            std::memcpy(buffers[current].data() + slot.length, data, copySize);
+            slot.length += copySize;
+            data += copySize;
+            size -= copySize;
+            if (slot.length == blockSize) {
+                submitCurrent();
+            }
+        }
+    }
+
+    void flush() {
+        if (slots.empty()) {
+            return;
+        }
+        if (slots[current].length > 0 && !slots[current].isInFlight) {
+            submitCurrent();
+        }
+        for (auto& slot : slots) {
+            while (slot.isInFlight) {
+                reap();
+            }
+        }
+    }
+
+private:
+    void submitCurrent() {
+        auto& slot = slots[current];
+        slot.offset = nextOffset;
+        slot.written = 0;
+        nextOffset += slot.length;
+        prepare(current);
+        ring.submit();
+        current = (current + 1) % slots.size();
+    }
+
+    void prepare(size_t index) {
+        auto& slot = slots[index];
+        ring.prepareWrite(fd, index, buffers[index].data() + slot.written, slot.length - slot.written,
+                slot.offset + slot.written, index);
+        slot.isInFlight = true;
+    }
+
+    void reap() {
+        size_t index = 0;
+        const int result = ring.wait(index);
+        auto& slot = slots[index];
+        slot.isInFlight = false;
+        if (result < 0 && isTransientError(result)) {
+            prepare(index);
+            ring.submit();
+            return;
+        } else if (result <= 0) {
+            LOG(ERROR) << tfm::format("Failed to write file: %s", std::strerror(result < 0 ? -result : EIO));
+            isGood = false;
+            slot.length = 0;
+            return;
+        }
+        slot.written += static_cast<size_t>(result);
+        if (slot.written < slot.length) {
+            // Short write, request the rest of the block.
+            prepare(index);
+            ring.submit();
+            return;
+        }
+        slot.length = 0;
+    }
+
+public:
+    const int fd;
+    const size_t blockSize;
+    Ring ring;
+    std::vector<BufferPool::Buffer> buffers;
+    std::vector<Slot> slots;
+    size_t current;
+    size_t nextOffset;
+    bool isGood;
+};
+
+std::unique_ptr<UringFileWriter> UringFileWriter::create(
+        const std::string& fileName, std::shared_ptr<BufferPool> bufferPool, size_t queueDepth) {
+    struct stat info;
+    if (::stat(fileName.c_str(), &info) == 0 && !S_ISREG(info.st_mode)) {
+        // Positional writes are not applicable to the pipes and devices.
+        return nullptr;
+    }
+    const int fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd < 0) {
+        return nullptr;
+    }
+    queueDepth = std::max(queueDepth, size_t(1));
+    std::unique_ptr<Impl> impl(new Impl(fd, bufferPool->bufferSize()));
+    if (!impl->ring.init(queueDepth)) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < queueDepth; ++i) {
+        impl->buffers.push_back(bufferPool->acquire());
+    }
+    impl->slots.resize(queueDepth);
+    impl->ring.registerBuffers(impl->buffers);
+    LOG(INFO) << tfm::format("Write file '%s' with io_uring.", fileName);
+    return std::unique_ptr<UringFileWriter>(new UringFileWriter(std::move(impl)));
+}
+
+UringFileWriter::UringFileWriter(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {
+}
+
+UringFileWriter::~UringFileWriter() noexcept = default;
+
+bool UringFileWriter::isGood() const {
+    return impl_->isGood;
+}
+
+void UringFileWriter::write(const unsigned char* data, size_t size) {
+    impl_->write(data, size);
+}
+
+void UringFileWriter::flush() {
+    impl_->flush();
+}
+
+#endif //USE_IO_URING
@@ -37,18 +37,26 @@
 #include <cli/command/VerifyCommand.h>
 
 #include <cli/api/api.h>
+#include <cli/api/Engine.h>
+#include <cli/concurrency/FileJobRunner.h>
 #include <cli/crypto/Crypto.h>
+#include <cli/error/ArgumentError.h>
 #include <cli/error/ExitError.h>
 
 #include <cli/io/Logger.h>
 #include <cli/memory.h>
 
 using cli::Crypto;
+using cli::Engine;
+using cli::VerifyOptions;
 using cli::command::VerifyCommand;
 using cli::argument::ArgumentIO;
 using cli::argument::ArgumentImportance;
 using cli::argument::ArgumentSource;
 using cli::argument::ArgumentParseOptions;
+using cli::concurrency::FileJob;
+using cli::concurrency::FileJobRunner;
+using cli::model::PublicKey;
 using cli::error::ExitFailure;
 using cli::error::ExitSuccess;
 
@@ -65,15 +73,17 @@ ArgumentParseOptions VerifyCommand::doGetArgumentParseOptions() const {
 }
 
 void VerifyCommand::doProcess() const {
+    if (getArgumentIO()->isMultiFile()) {
+        processFiles();
+        return;
+    }
 
     ULOG1(INFO) << "Read arguments.";
     auto data = getArgumentIO()->getInputSource(ArgumentImportance::Optional);
     auto signature = getArgumentIO()->getSignatureSource(ArgumentImportance::Required);
-    auto senderKey = getArgumentIO()->getSenderKey(ArgumentImportance::Required);
+    VerifyOptions options{ getArgumentIO()->getSenderKey(ArgumentImportance::Required), signature.readAll() };
 
-    ULOG1(INFO) << "Verify input data with given sign.";
-    Crypto::StreamSigner signer;
-    bool verified = signer.verify(data, signature.readAll(), senderKey.key());
+    bool verified = Engine::verify(options, data);
 
     if (verified) {
         ULOG(INFO) << "Data verification: success.";
@@ -83,3 +93,34 @@ void VerifyCommand::doProcess() const {
         throw ExitFailure();
     }
 }
+
+void VerifyCommand::processFiles() const {
+    ULOG1(INFO) << "Read arguments.";
+    if (getArgumentIO()->hasSignature()) {
+        throw error::ArgumentNotAllowedError(opt::SIGN);
+    }
+    // Signature of each file is read from the file with the same name and the signature suffix.
+    auto fileJobs = getArgumentIO()->getFileJobs(false, ArgumentImportance::Required);
+    auto jobs = getArgumentIO()->getJobs(ArgumentImportance::Optional);
+    auto senderKey = getArgumentIO()->getSenderKey(ArgumentImportance::Required);
+
+    ULOG1(INFO) << tfm::format("Verify %d file(s).", fileJobs.size());
+    auto failedCount = FileJobRunner(jobs, false).run(fileJobs, [this, &senderKey](const FileJob& fileJob) {
+        auto data = getArgumentIO()->getFileSource(fileJob.inputFile);
+        VerifyOptions options{
+                PublicKey(senderKey.key(), senderKey.identifier()),
+                getArgumentIO()->getFileSource(fileJob.outputFile).readAll()
+        };
+        if (!Engine::verify(options, data)) {
+            throw error::ArgumentRuntimeError("Data verification: failed.");
+        }
+    });
+
+    if (failedCount == 0) {
+        ULOG(INFO) << tfm::format("Data verification: success for %d file(s).", fileJobs.size());
+        throw ExitSuccess();
+    } else {
+        ULOG(INFO) << tfm::format("Data verification: failed for %d of %d file(s).", failedCount, fileJobs.size());
+        throw ExitFailure();
+    }
+}
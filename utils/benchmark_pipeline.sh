@@ -0,0 +1,124 @@
+#!/bin/bash
+#
+# Copyright (C) 2015-2017 Virgil Security Inc.
+#
+# Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     (1) Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#
+#     (2) Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#
+#     (3) Neither the name of the copyright holder nor the names of its
+#     contributors may be used to endorse or promote products derived from
+#     this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+# IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+# INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+# STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+# IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+#
+# Measures wall-clock time of the encrypt and decrypt commands with and without pipelined processing (IO_PIPELINE)
+# on a slow disk emulation: input is fed and output is drained through FIFOs with a limited rate.
+# Requires GNU coreutils (dd with iflag=fullblock).
+#
+# Usage: benchmark_pipeline.sh <path-to-virgil> [size-in-MB] [rate-in-MB-per-second]
+#
+
+set -e
+
+VIRGIL="$1"
+SIZE_MB="${2:-256}"
+RATE_MB="${3:-64}"
+
+if [ -z "${VIRGIL}" ] || [ ! -x "${VIRGIL}" ]; then
+    echo "Usage: $(basename "$0") <path-to-virgil> [size-in-MB] [rate-in-MB-per-second]" >&2
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# Delay in seconds between 1MB blocks to get given rate.
+BLOCK_DELAY=$(awk "BEGIN { printf \"%.4f\", 1 / ${RATE_MB} }")
+
+function throttled_read() {
+    local file="$1"
+    local block=0
+    while [ ${block} -lt ${SIZE_MB} ]; do
+        dd if="${file}" bs=1048576 skip=${block} count=1 2>/dev/null
+        sleep "${BLOCK_DELAY}"
+        block=$((block + 1))
+    done
+    # Tail that is not aligned to the block size (i.e. encrypted data overhead).
+    dd if="${file}" bs=1048576 skip=${block} 2>/dev/null
+}
+
+function throttled_write() {
+    local file="$1"
+    : > "${file}"
+    while true; do
+        local written
+        written=$(dd bs=1048576 count=1 iflag=fullblock 2>/dev/null | tee -a "${file}" | wc -c)
+        [ "${written}" -eq 0 ] && break
+        sleep "${BLOCK_DELAY}"
+    done
+}
+
+function now() {
+    date +%s.%N
+}
+
+# $1 - pipeline mode, $2 - source file, $3 - destination file, rest - virgil command with arguments
+function measure() {
+    local mode="$1" source="$2" destination="$3"
+    shift 3
+    local in_fifo="${WORK_DIR}/in.fifo" out_fifo="${WORK_DIR}/out.fifo"
+    rm -f "${in_fifo}" "${out_fifo}"
+    mkfifo "${in_fifo}" "${out_fifo}"
+
+    local start end
+    start=$(now)
+    throttled_read "${source}" > "${in_fifo}" &
+    throttled_write "${destination}" < "${out_fifo}" &
+    "${VIRGIL}" "$@" -D IO_PIPELINE="${mode}" -i "${in_fifo}" -o "${out_fifo}"
+    wait
+    end=$(now)
+    awk "BEGIN { printf \"%-8s %-4s %8.2f s\n\", \"$1\", \"${mode}\", ${end} - ${start} }"
+}
+
+echo "Prepare ${SIZE_MB}MB of the random data, emulated disk rate is ${RATE_MB}MB/s."
+head -c $((SIZE_MB * 1048576)) /dev/urandom > "${WORK_DIR}/plain.data"
+"${VIRGIL}" keygen --no-password -o "${WORK_DIR}/alice.key"
+"${VIRGIL}" key2pub -i "${WORK_DIR}/alice.key" -o "${WORK_DIR}/alice.pub"
+
+echo "command  mode     time"
+for mode in off on; do
+    measure "${mode}" "${WORK_DIR}/plain.data" "${WORK_DIR}/encrypted.${mode}" \
+            encrypt "pubkey:${WORK_DIR}/alice.pub"
+done
+for mode in off on; do
+    measure "${mode}" "${WORK_DIR}/encrypted.${mode}" "${WORK_DIR}/decrypted.${mode}" \
+            decrypt "privkey:${WORK_DIR}/alice.key"
+    cmp -s "${WORK_DIR}/plain.data" "${WORK_DIR}/decrypted.${mode}" || {
+        echo "Decrypted data does not match the original data (mode: ${mode})." >&2
+        exit 1
+    }
+done
@@ -0,0 +1,116 @@
+#!/bin/bash
+#
+# Copyright (C) 2015-2017 Virgil Security Inc.
+#
+# Lead Maintainer: Virgil Security Inc. <support@virgilsecurity.com>
+#
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met:
+#
+#     (1) Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#
+#     (2) Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#
+#     (3) Neither the name of the copyright holder nor the names of its
+#     contributors may be used to endorse or promote products derived from
+#     this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+# IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+# DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+# INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+# (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+# SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+# HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+# STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+# IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+#
+# Measures how the encryption for many recipients scales: content info size, wall-clock time of the encryption
+# (dominated by the data key wrapping) and wall-clock time of the decryption by the last recipient
+# (dominated by the recipient lookup), for the default and the chunked formats.
+# Recipients are read from the file (--recipients), Key Pairs are generated once and reused by the next runs.
+#
+# Usage: benchmark_recipients.sh <path-to-virgil> [recipient-counts...]
+#
+
+set -e
+
+VIRGIL="$1"
+shift || true
+COUNTS="${*:-10 100 1000 10000}"
+
+if [ -z "${VIRGIL}" ] || [ ! -x "${VIRGIL}" ]; then
+    echo "Usage: $(basename "$0") <path-to-virgil> [recipient-counts...]" >&2
+    exit 1
+fi
+
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+function now() {
+    date +%s.%N
+}
+
+# $1 - number of Key Pairs that must exist in the work directory
+function generate_keys() {
+    local count="$1"
+    local index
+    index=$(ls "${WORK_DIR}" | grep -c '\.pub$' || true)
+    while [ ${index} -lt ${count} ]; do
+        "${VIRGIL}" keygen --no-password -o "${WORK_DIR}/${index}.key"
+        "${VIRGIL}" key2pub -i "${WORK_DIR}/${index}.key" -o "${WORK_DIR}/${index}.pub"
+        index=$((index + 1))
+    done
+}
+
+# $1 - output file, rest - virgil command with arguments; prints elapsed time in seconds
+function measure() {
+    local output="$1"
+    shift
+    local start end
+    start=$(now)
+    "${VIRGIL}" "$@" -o "${output}"
+    end=$(now)
+    awk "BEGIN { printf \"%.3f\", ${end} - ${start} }"
+}
+
+head -c 1024 /dev/urandom > "${WORK_DIR}/plain.data"
+
+echo "format   recipients  content-info(B)  encrypt(s)  decrypt(s)"
+for count in ${COUNTS}; do
+    echo "Generate ${count} Key Pair(s)." >&2
+    generate_keys "${count}"
+    recipients="${WORK_DIR}/recipients.${count}.txt"
+    : > "${recipients}"
+    for ((index = 0; index < count; ++index)); do
+        echo "pubkey:${WORK_DIR}/${index}.pub:${index}" >> "${recipients}"
+    done
+    last_key="${WORK_DIR}/$((count - 1)).key"
+
+    for format in default chunked; do
+        format_option=""
+        [ "${format}" = "chunked" ] && format_option="--chunked"
+        encrypted="${WORK_DIR}/encrypted.${format}.${count}"
+        decrypted="${WORK_DIR}/decrypted.${format}.${count}"
+        encrypt_time=$(measure "${encrypted}" encrypt -i "${WORK_DIR}/plain.data" ${format_option} \
+                --recipients="${recipients}")
+        content_info_size=$("${VIRGIL}" content-info -i "${encrypted}" | grep "content info size" | grep -o '[0-9]*$')
+        decrypt_time=$(measure "${decrypted}" decrypt -i "${encrypted}" "privkey:${last_key}:$((count - 1))")
+        cmp -s "${WORK_DIR}/plain.data" "${decrypted}" || {
+            echo "Decrypted data does not match the original data (format: ${format}, recipients: ${count})." >&2
+            exit 1
+        }
+        printf "%-8s %10d %16d %11s %11s\n" \
+                "${format}" "${count}" "${content_info_size}" "${encrypt_time}" "${decrypt_time}"
+    done
+done